@@ -102,6 +102,16 @@ cbuffer BufferObject : register(b3)
     matrix g_object_wvp_previous;
 };
 
+#if INSTANCED
+// High frequency - Updates per instanced draw
+static const uint g_max_instances = 32;
+cbuffer BufferInstance : register(b5)
+{
+    matrix g_instance_transform[g_max_instances];
+    matrix g_instance_wvp_previous[g_max_instances];
+};
+#endif
+
 // High frequency - Updates per light
 cbuffer LightBuffer : register(b4)
 {
@@ -23,12 +23,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Common.hlsl"
 //====================
 
+#if INSTANCED
+Pixel_PosUv mainVS(Vertex_PosUv input, uint instance_id : SV_InstanceID)
+{
+    matrix transform = g_instance_transform[instance_id];
+#else
 Pixel_PosUv mainVS(Vertex_PosUv input)
 {
+    matrix transform = g_object_transform;
+#endif
     Pixel_PosUv output;
 
     input.position.w    = 1.0f; 
-    output.position     = mul(input.position, g_object_transform);
+    output.position     = mul(input.position, transform);
     output.uv           = input.uv;
 
     return output;
@@ -19,13 +19,21 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ======
+//= INCLUDES ===================
 #include "Window.h"
 #include "Editor.h"
-//=================
+#include "Profiling/Benchmark.h"
+//==============================
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
+    // Headless benchmark, no window or editor, e.g. -headless -world sponza.world -frames 500 -output sponza.json
+    Spartan::BenchmarkSettings benchmark_settings;
+    if (Spartan::Benchmark::ParseCommandLine(__argc, __argv, benchmark_settings))
+    {
+        return Spartan::Benchmark(benchmark_settings).Run();
+    }
+
     // Create editor
     Editor editor;
 
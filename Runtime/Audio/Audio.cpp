@@ -89,6 +89,17 @@ namespace Spartan
             return false;
         }
 
+        // Headless runs don't open an audio device, the mixer still runs so audio sources behave the same
+        if (m_context->m_engine->EngineMode_IsSet(Engine_Headless))
+        {
+            m_result_fmod = m_system_fmod->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT);
+            if (m_result_fmod != FMOD_OK)
+            {
+                LogErrorFmod(m_result_fmod);
+                return false;
+            }
+        }
+
         // Make sure there is a sound card devices on the machine
         auto driver_count = 0;
         m_result_fmod = m_system_fmod->getNumDrivers(&driver_count);
@@ -154,10 +165,10 @@ namespace Spartan
 
 		if (m_listener)
 		{
-			auto position = m_listener->GetPosition();
+			auto position = m_listener_position;
 			auto velocity = Math::Vector3::Zero;
-			auto forward = m_listener->GetForward();
-			auto up = m_listener->GetUp();
+			auto forward = m_listener_forward;
+			auto up = m_listener_up;
 
 			// Set 3D attributes
 			m_result_fmod = m_system_fmod->set3DListenerAttributes(
@@ -178,6 +189,14 @@ namespace Spartan
     void Audio::SetListenerTransform(Transform* transform)
 	{
 		m_listener = transform;
+
+		// Keep a copy, so that ticking doesn't need to read the world (which physics might be writing to)
+		if (m_listener)
+		{
+			m_listener_position	= m_listener->GetPosition();
+			m_listener_forward	= m_listener->GetForward();
+			m_listener_up		= m_listener->GetUp();
+		}
 	}
 
 	void Audio::LogErrorFmod(int error) const
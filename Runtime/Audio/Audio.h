@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include "../Core/ISubsystem.h"
+#include "../Math/Vector3.h"
 //=============================
 
 //= FORWARD DECLARATIONS =
@@ -46,6 +47,9 @@ namespace Spartan
         //= ISubsystem ======================
         bool Initialize() override;
         void Tick(float delta_time) override;
+        uint32_t GetTickDataRead()      const override { return Tick_Data_None; }
+        uint32_t GetTickDataWrite()     const override { return Tick_Data_Audio; }
+        bool CanTickOnWorkerThread()    const override { return true; }
         //===================================
 
 		auto GetSystemFMOD() const { return m_system_fmod; }
@@ -59,6 +63,9 @@ namespace Spartan
 		float m_distance_entity		= 1.0f;
 		bool m_initialized			= false;
 		Transform* m_listener		= nullptr;
+		Math::Vector3 m_listener_position;
+		Math::Vector3 m_listener_forward;
+		Math::Vector3 m_listener_up;
 		Profiler* m_profiler		= nullptr;
 		FMOD::System* m_system_fmod = nullptr;
 	};
@@ -21,11 +21,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ===================
+//= INCLUDES ========================
 #include "ISubsystem.h"
 #include "../Logging/Log.h"
+#include "../Threading/Threading.h"
 #include "Spartan_Definitions.h"
-//==============================
+//===================================
 
 namespace Spartan
 {
@@ -47,6 +48,8 @@ namespace Spartan
 
         std::shared_ptr<ISubsystem> ptr;
         Tick_Group tick_group;
+        std::vector<uint32_t> dependencies;         // Earlier subsystems (of the same tick group) which this one conflicts with
+        std::unique_ptr<TaskCounter> tick_counter   = std::make_unique<TaskCounter>();
     };
 
 	class SPARTAN_CLASS Context
@@ -72,6 +75,24 @@ namespace Spartan
             validate_subsystem_type<T>();
 
             m_subsystems.emplace_back(std::make_shared<T>(this), tick_group);
+
+            // Depend on every earlier subsystem of the same group that writes what we access or accesses what we write
+            _subystem& subsystem    = m_subsystems.back();
+            const uint32_t read     = subsystem.ptr->GetTickDataRead();
+            const uint32_t write    = subsystem.ptr->GetTickDataWrite();
+            for (uint32_t i = 0; i < static_cast<uint32_t>(m_subsystems.size()) - 1; i++)
+            {
+                const _subystem& other = m_subsystems[i];
+                if (other.tick_group != tick_group)
+                    continue;
+
+                const uint32_t other_read   = other.ptr->GetTickDataRead();
+                const uint32_t other_write  = other.ptr->GetTickDataWrite();
+                if ((write & (other_read | other_write)) || (read & other_write))
+                {
+                    subsystem.dependencies.emplace_back(i);
+                }
+            }
 		}
 
 		// Initialize subsystems
@@ -87,18 +108,41 @@ namespace Spartan
                 }
             }
 
+            m_threading = GetSubsystem<Threading>();
+
 			return result;
 		}
 
-        // Tick
+        // Tick, subsystems which can tick on a worker thread do so as soon as the subsystems they depend on are done
 		void Tick(Tick_Group tick_group, float delta_time = 0.0f)
 		{
-            for (const auto& subsystem : m_subsystems)
+            for (auto& subsystem : m_subsystems)
             {
                 if (subsystem.tick_group != tick_group)
                     continue;
 
-                subsystem.ptr->Tick(delta_time);
+                if (m_threading && subsystem.ptr->CanTickOnWorkerThread())
+                {
+                    m_threading->AddTask([this, &subsystem, delta_time]()
+                    {
+                        TickWaitDependencies(subsystem);
+                        subsystem.ptr->Tick(delta_time);
+                    }, subsystem.tick_counter.get());
+                }
+                else
+                {
+                    TickWaitDependencies(subsystem);
+                    subsystem.ptr->Tick(delta_time);
+                }
+            }
+
+            // Nothing should still be ticking once the group is done
+            if (m_threading)
+            {
+                for (const auto& subsystem : m_subsystems)
+                {
+                    m_threading->Wait(*subsystem.tick_counter);
+                }
             }
 		}
 
@@ -120,6 +164,18 @@ namespace Spartan
         Engine* m_engine = nullptr;
 
 	private:
+        void TickWaitDependencies(const _subystem& subsystem) const
+        {
+            if (!m_threading)
+                return;
+
+            for (const uint32_t dependency : subsystem.dependencies)
+            {
+                m_threading->Wait(*m_subsystems[dependency].tick_counter);
+            }
+        }
+
 		std::vector<_subystem> m_subsystems;
+        Threading* m_threading = nullptr;
 	};
 }
@@ -39,14 +39,13 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
-	Engine::Engine(const WindowData& window_data)
+	Engine::Engine(const WindowData& window_data, const uint32_t flags /*= Engine_Physics | Engine_Game*/)
 	{
         // Window
         m_window_data = window_data;
 
-        // Flags
-        m_flags |= Engine_Physics;
-        m_flags |= Engine_Game;
+        // Flags, set before the subsystems get created as some of them depend on Engine_Headless
+        m_flags = flags;
 
         // Create context
 		m_context = make_shared<Context>();
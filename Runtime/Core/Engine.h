@@ -53,12 +53,13 @@ namespace Spartan
 	{
 		Engine_Physics	= 1UL << 0, // Should the physics tick?	
 		Engine_Game		= 1UL << 1,	// Is the engine running in game or editor mode?
+		Engine_Headless	= 1UL << 2,	// No window, presentation or audio device (benchmarks, automated runs)
 	};
 
 	class SPARTAN_CLASS Engine
 	{
 	public:
-		Engine(const WindowData& window_data);
+		Engine(const WindowData& window_data, const uint32_t flags = Engine_Physics | Engine_Game);
 		~Engine();
 
 		// Performs a simulation cycle
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <type_traits>
 #include <memory>
+#include <cstdint>
 #include "Spartan_Definitions.h"
 //==============================
 
@@ -31,6 +32,22 @@ namespace Spartan
 {
 	class Context;
 
+    // Data a subsystem accesses while ticking, subsystems of the same tick group which don't conflict can tick concurrently
+    enum Tick_Data : uint32_t
+    {
+        Tick_Data_None      = 0,
+        Tick_Data_Time      = 1 << 0,
+        Tick_Data_Resources = 1 << 1,
+        Tick_Data_Audio     = 1 << 2,
+        Tick_Data_Physics   = 1 << 3,
+        Tick_Data_Input     = 1 << 4,
+        Tick_Data_World     = 1 << 5, // entities, components and their transforms
+        Tick_Data_Rhi       = 1 << 6,
+        Tick_Data_Profiler  = 1 << 7,
+        Tick_Data_Settings  = 1 << 8,
+        Tick_Data_All       = ~0u
+    };
+
 	class SPARTAN_CLASS ISubsystem : public std::enable_shared_from_this<ISubsystem>
 	{		
 	public:
@@ -39,6 +56,11 @@ namespace Spartan
 		virtual bool Initialize() { return true; }
 		virtual void Tick(float delta_time) {}
 
+        // Tick scheduling, by default a subsystem conflicts with every other subsystem and ticks on the main thread
+        virtual uint32_t GetTickDataRead()      const { return Tick_Data_All; }
+        virtual uint32_t GetTickDataWrite()     const { return Tick_Data_All; }
+        virtual bool CanTickOnWorkerThread()    const { return false; }
+
         template <typename T>
         std::shared_ptr<T> GetPtrShared() { return dynamic_pointer_cast<T>(shared_from_this()); }
 
@@ -44,6 +44,15 @@ namespace Spartan
         m_time_frame_end    = m_time_frame_start;
         m_time_frame_start  = chrono::high_resolution_clock::now();
 
+        // Fixed time step, simulated time only depends on the number of ticks
+        if (m_delta_time_fixed_ms > 0.0)
+        {
+            m_time_ms                   += m_delta_time_fixed_ms;
+            m_delta_time_ms             = m_delta_time_fixed_ms;
+            m_delta_time_smoothed_ms    = m_delta_time_fixed_ms;
+            return;
+        }
+
         // Compute durations
         const chrono::duration<double, milli> time_elapsed      = m_time_start - m_time_frame_start;
         chrono::duration<double, milli> time_delta              = m_time_frame_start - m_time_frame_end;
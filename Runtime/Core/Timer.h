@@ -54,6 +54,10 @@ namespace Spartan
         auto GetFpsPolicy() const   { return m_fps_policy; }
         //==================================================
 
+        // A fixed delta time makes every tick advance by the same amount, without any fps limiting (zero reverts to real time)
+        void SetFixedDeltaTimeMs(const double delta_time_ms)    { m_delta_time_fixed_ms = delta_time_ms; }
+        auto GetFixedDeltaTimeMs() const                        { return m_delta_time_fixed_ms; }
+
         auto GetTimeMs()                const { return m_time_ms; }
         auto GetTimeSec()               const { return static_cast<float>(m_time_ms / 1000.0); }
 		auto GetDeltaTimeMs()           const { return m_delta_time_ms; }
@@ -70,6 +74,7 @@ namespace Spartan
 		double m_delta_time_ms          = 0.0f;
         double m_delta_time_smoothed_ms = 0.0f;
         double m_sleep_overhead         = 0.0f;
+        double m_delta_time_fixed_ms    = 0.0f;
 
         // FPS
         double m_fps_min                = 30.0;
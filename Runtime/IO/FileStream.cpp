@@ -23,6 +23,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "FileStream.h"
 #include "../RHI/RHI_Vertex.h"
+#include <filesystem>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 //============================
 
 //= NAMESPACES =====
@@ -31,6 +40,15 @@ using namespace std;
 
 namespace Spartan
 {
+    namespace _file_stream
+    {
+        // Buffered writes are handed to the background once they reach this size
+        static const uint64_t write_flush_size = 4 * 1024 * 1024;
+
+        // Skipped bytes are carried over from the destination in chunks of this size
+        static const uint64_t skip_chunk_size = 64 * 1024;
+    }
+
 	FileStream::FileStream(const string& path, uint32_t flags)
 	{
 		m_is_open	= false;
@@ -43,7 +61,22 @@ namespace Spartan
 
 		if (m_flags & FileStream_Write)
 		{
-			out.open(path, ios_flags);
+            m_path      = path;
+            m_path_temp = path + ".tmp";
+
+            // Appending continues from a copy of the existing file
+            error_code error;
+            if ((m_flags & FileStream_Append) && filesystem::exists(path, error))
+            {
+                if (!filesystem::copy_file(path, m_path_temp, filesystem::copy_options::overwrite_existing, error))
+                {
+                    LOG_ERROR("Failed to open \"%s\" for appending", path.c_str());
+                    return;
+                }
+                m_write_offset = static_cast<uint64_t>(filesystem::file_size(m_path_temp, error));
+            }
+
+			out.open(m_path_temp, ios_flags);
 			if (out.fail())
 			{
 				LOG_ERROR("Failed to open \"%s\" for writing", path.c_str());
@@ -52,12 +85,15 @@ namespace Spartan
 		}
 		else if (m_flags & FileStream_Read)
 		{
-			in.open(path, ios_flags);
-			if(in.fail())
-			{
-				LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
-				return;
-			}
+            if (!Map(path))
+            {
+                in.open(path, ios_flags);
+                if (in.fail())
+                {
+                    LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
+                    return;
+                }
+            }
 		}
 
 		m_is_open = true;
@@ -70,13 +106,44 @@ namespace Spartan
 
 	void FileStream::Close()
 	{
+        if (!m_is_open)
+            return;
+        m_is_open = false;
+
 		if (m_flags & FileStream_Write)
 		{
+            // Wait for the background flush and write whatever is left
+            if (m_flush.valid())
+            {
+                m_write_failed |= !m_flush.get();
+            }
+            out.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
 			out.flush();
+            m_write_failed |= out.fail();
 			out.close();
+            in.close();
+
+            // The destination is only replaced once everything has been written, so a failed or interrupted save leaves it intact
+            error_code error;
+            if (!m_write_failed)
+            {
+                filesystem::rename(m_path_temp, m_path, error);
+            }
+
+            if (m_write_failed || error)
+            {
+                LOG_ERROR("Failed to write \"%s\"", m_path.c_str());
+                filesystem::remove(m_path_temp, error);
+            }
+
+            m_buffer.clear();
+            m_buffer.shrink_to_fit();
+            m_buffer_flushing.clear();
+            m_buffer_flushing.shrink_to_fit();
 		}
 		else if (m_flags & FileStream_Read)
 		{
+            Unmap();
 			in.clear();
 			in.close();
 		}
@@ -87,7 +154,7 @@ namespace Spartan
 		const auto length = static_cast<uint32_t>(value.length());
 		Write(length);
 
-		out.write(const_cast<char*>(value.c_str()), length);
+		WriteBytes(value.data(), length);
 	}
 
 	void FileStream::Write(const vector<string>& value)
@@ -105,28 +172,28 @@ namespace Spartan
 	{
 		const auto length = static_cast<uint32_t>(value.size());
 		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan) * length);
+		WriteBytes(value.data(), sizeof(RHI_Vertex_PosTexNorTan) * length);
 	}
 
 	void FileStream::Write(const vector<uint32_t>& value)
 	{
 		const auto length = static_cast<uint32_t>(value.size());
 		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint32_t) * length);
+		WriteBytes(value.data(), sizeof(uint32_t) * length);
 	}
 
 	void FileStream::Write(const vector<unsigned char>& value)
 	{
 		const auto size = static_cast<uint32_t>(value.size());
 		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
+		WriteBytes(value.data(), sizeof(unsigned char) * size);
 	}
 
 	void FileStream::Write(const vector<std::byte>& value)
 	{
 		const auto size = static_cast<uint32_t>(value.size());
 		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
+		WriteBytes(value.data(), sizeof(std::byte) * size);
 	}
 
 	void FileStream::Skip(uint32_t n)
@@ -134,11 +201,50 @@ namespace Spartan
 		// Set the seek cursor to offset n from the current position
 		if (m_flags & FileStream_Write)
 		{
-			out.seekp(n, ios::cur);
+            // Skipped bytes keep what the destination file already has at this offset, or zeros if there is nothing there.
+            // The destination is only replaced on Close(), so it can be read while the temporary file is written.
+            if (!in.is_open())
+            {
+                in.open(m_path, ios::binary | ios::in);
+            }
+            if (in.is_open())
+            {
+                in.clear();
+                in.seekg(m_write_offset, ios::beg);
+            }
+
+            // The range can be large (e.g. the mip chain of a texture), so it's carried over in bounded chunks
+            vector<std::byte> chunk(static_cast<size_t>((min)(static_cast<uint64_t>(n), _file_stream::skip_chunk_size)));
+            uint64_t remaining = n;
+            while (remaining != 0)
+            {
+                const uint64_t size = (min)(remaining, static_cast<uint64_t>(chunk.size()));
+
+                uint64_t read = 0;
+                if (in.is_open() && in.good())
+                {
+                    in.read(reinterpret_cast<char*>(chunk.data()), size);
+                    read = static_cast<uint64_t>(in.gcount());
+                }
+                memset(chunk.data() + read, 0, static_cast<size_t>(size - read));
+
+                WriteBytes(chunk.data(), size);
+                remaining -= size;
+            }
 		}
 		else if (m_flags & FileStream_Read)
 		{
-			in.ignore(n, ios::cur);
+            if (m_mapped_data)
+            {
+                if (CanRead(n))
+                {
+                    m_mapped_offset += n;
+                }
+            }
+            else
+            {
+                in.seekg(n, ios::cur);
+            }
 		}
 	}
 
@@ -147,8 +253,14 @@ namespace Spartan
 		uint32_t length = 0;
 		Read(&length);
 
+		if (!CanRead(length))
+		{
+			value->clear();
+			return;
+		}
+
 		value->resize(length);
-		in.read(const_cast<char*>(value->c_str()), length);
+		ReadBytes(value->data(), length);
 	}
 
 	void FileStream::Read(vector<string>* vec)
@@ -162,11 +274,15 @@ namespace Spartan
 		uint32_t size = 0;
 		Read(&size);
 
-		string str;
-		for (uint32_t i = 0; i < size; i++)
+		// Every string takes at least its length
+		if (!CanRead(static_cast<uint64_t>(size) * sizeof(uint32_t)))
+			return;
+
+		// Read in place, without going through a temporary
+		vec->resize(size);
+		for (string& str : *vec)
 		{
 			Read(&str);
-			vec->emplace_back(str);
 		}
 	}
 
@@ -180,10 +296,11 @@ namespace Spartan
 
         const auto length = ReadAs<uint32_t>();
 
-		vec->reserve(length);
-		vec->resize(length);
+		if (!CanRead(sizeof(RHI_Vertex_PosTexNorTan) * static_cast<uint64_t>(length)))
+			return;
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan) * length);
+		vec->resize(length);
+		ReadBytes(vec->data(), sizeof(RHI_Vertex_PosTexNorTan) * static_cast<uint64_t>(length));
 	}
 
 	void FileStream::Read(vector<uint32_t>* vec)
@@ -196,10 +313,11 @@ namespace Spartan
 
         const auto length = ReadAs<uint32_t>();
 
-		vec->reserve(length);
-		vec->resize(length);
+		if (!CanRead(sizeof(uint32_t) * static_cast<uint64_t>(length)))
+			return;
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint32_t) * length);
+		vec->resize(length);
+		ReadBytes(vec->data(), sizeof(uint32_t) * static_cast<uint64_t>(length));
 	}
 
 	void FileStream::Read(vector<unsigned char>* vec)
@@ -212,10 +330,11 @@ namespace Spartan
 
         const auto length = ReadAs<uint32_t>();
 
-		vec->reserve(length);
-		vec->resize(length);
+		if (!CanRead(sizeof(unsigned char) * static_cast<uint64_t>(length)))
+			return;
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
+		vec->resize(length);
+		ReadBytes(vec->data(), sizeof(unsigned char) * static_cast<uint64_t>(length));
 	}
 
 	void FileStream::Read(vector<std::byte>* vec)
@@ -228,9 +347,197 @@ namespace Spartan
 
 		const auto length = ReadAs<uint32_t>();
 
-		vec->reserve(length);
-		vec->resize(length);
+		if (!CanRead(sizeof(std::byte) * static_cast<uint64_t>(length)))
+			return;
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
+		vec->resize(length);
+		ReadBytes(vec->data(), sizeof(std::byte) * static_cast<uint64_t>(length));
 	}
+
+    uint64_t FileStream::GetPosition()
+    {
+        if (m_flags & FileStream_Write)
+            return m_write_offset;
+
+        if (m_mapped_data)
+            return m_mapped_offset;
+
+        return static_cast<uint64_t>(in.tellg());
+    }
+
+    bool FileStream::Seek(const uint64_t position)
+    {
+        if (!(m_flags & FileStream_Read))
+        {
+            LOG_ERROR("Seeking is only supported when reading");
+            return false;
+        }
+
+        if (m_mapped_data)
+        {
+            if (position > m_mapped_size)
+            {
+                LOG_ERROR("Attempted to seek to offset %llu, past the end of the file (%llu bytes)", static_cast<unsigned long long>(position), static_cast<unsigned long long>(m_mapped_size));
+                return false;
+            }
+
+            m_mapped_offset = position;
+            return true;
+        }
+
+        in.clear();
+        in.seekg(position, ios::beg);
+        return !in.fail();
+    }
+
+    uint64_t FileStream::GetSize()
+    {
+        if (m_flags & FileStream_Write)
+            return m_write_offset;
+
+        if (m_mapped_data)
+            return m_mapped_size;
+
+        const auto position = in.tellg();
+        in.seekg(0, ios::end);
+        const auto size = in.tellg();
+        in.seekg(position, ios::beg);
+        return static_cast<uint64_t>(size);
+    }
+
+    void FileStream::WriteBytes(const void* data, const uint64_t size)
+    {
+        const std::byte* bytes = static_cast<const std::byte*>(data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        m_write_offset += size;
+
+        if (m_buffer.size() >= _file_stream::write_flush_size)
+        {
+            WriteFlush();
+        }
+    }
+
+    void FileStream::WriteFlush()
+    {
+        // Writes have to land in order, so the previous flush must be done before the buffers are swapped
+        if (m_flush.valid())
+        {
+            m_write_failed |= !m_flush.get();
+        }
+
+        m_buffer_flushing.swap(m_buffer);
+        m_buffer.clear();
+
+        m_flush = async(launch::async, [this]()
+        {
+            out.write(reinterpret_cast<const char*>(m_buffer_flushing.data()), m_buffer_flushing.size());
+            return !out.fail();
+        });
+    }
+
+    bool FileStream::Map(const string& path)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // The view keeps the file and the mapping alive, so both handles can be closed right away
+        HANDLE mapping  = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data      = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+
+        if (!data)
+            return false;
+
+        m_mapped_size = static_cast<uint64_t>(size.QuadPart);
+#else
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file == -1)
+            return false;
+
+        struct stat info = {};
+        if (fstat(file, &info) != 0 || info.st_size == 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        // The mapping keeps the file alive, so the descriptor can be closed right away
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+
+        if (data == MAP_FAILED)
+            return false;
+
+        m_mapped_size = static_cast<uint64_t>(info.st_size);
+#endif
+
+        m_mapped_data   = static_cast<const std::byte*>(data);
+        m_mapped_offset = 0;
+        return true;
+    }
+
+    void FileStream::Unmap()
+    {
+        if (!m_mapped_data)
+            return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(m_mapped_data);
+#else
+        munmap(const_cast<std::byte*>(m_mapped_data), static_cast<size_t>(m_mapped_size));
+#endif
+
+        m_mapped_data   = nullptr;
+        m_mapped_size   = 0;
+        m_mapped_offset = 0;
+    }
+
+    bool FileStream::ReadBytes(void* destination, const uint64_t size)
+    {
+        if (!m_mapped_data)
+        {
+            in.read(reinterpret_cast<char*>(destination), size);
+            return !in.fail();
+        }
+
+        // Out of bounds reads yield zeros instead of touching memory past the mapping
+        if (!CanRead(size))
+        {
+            memset(destination, 0, size);
+            return false;
+        }
+
+        memcpy(destination, m_mapped_data + m_mapped_offset, size);
+        m_mapped_offset += size;
+        return true;
+    }
+
+    bool FileStream::CanRead(const uint64_t size)
+    {
+        // Without a mapping the size isn't known upfront, ifstream fails on its own
+        if (!m_mapped_data)
+            return true;
+
+        if (size > m_mapped_size - m_mapped_offset)
+        {
+            LOG_ERROR("Attempted to read %llu bytes at offset %llu, past the end of the file (%llu bytes)", static_cast<unsigned long long>(size), static_cast<unsigned long long>(m_mapped_offset), static_cast<unsigned long long>(m_mapped_size));
+            m_mapped_offset = m_mapped_size;
+            return false;
+        }
+
+        return true;
+    }
 }
@@ -23,7 +23,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===================
 #include <vector>
+#include <string>
 #include <fstream>
+#include <future>
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
@@ -76,7 +78,7 @@ namespace Spartan
 		>::type>
 		void Write(T value)
 		{
-			out.write(reinterpret_cast<char*>(&value), sizeof(value));
+			WriteBytes(&value, sizeof(value));
 		}
 
 		void Write(const std::string& value);
@@ -114,7 +116,7 @@ namespace Spartan
 		>::type>
 		void Read(T* value)
 		{
-			in.read(reinterpret_cast<char*>(value), sizeof(T));
+			ReadBytes(value, sizeof(T));
 		}
 		void Read(std::string* value);
 		void Read(std::vector<std::string>* vec);
@@ -151,9 +153,38 @@ namespace Spartan
 		}
 		//=====================================================
 
+		//= POSITIONING =========================================================
+		// Byte offset of the next read or write
+		uint64_t GetPosition();
+		// Moves the read position to an absolute offset, only supported when reading
+		bool Seek(uint64_t position);
+		// Size of the file when reading, bytes written so far when writing
+		uint64_t GetSize();
+		//=======================================================================
+
 	private:
+        // Writing goes to a buffer which is flushed to a temporary file in the background, Close() then renames it over the destination
+        void WriteBytes(const void* data, uint64_t size);
+        void WriteFlush();
+
+        // Reading is served from a read-only mapping of the file, ifstream is only a fallback for files which can't be mapped
+        bool Map(const std::string& path);
+        void Unmap();
+        bool ReadBytes(void* destination, uint64_t size);
+        bool CanRead(uint64_t size);
+
 		std::ofstream out;
 		std::ifstream in;
+        std::string m_path;
+        std::string m_path_temp;
+        std::vector<std::byte> m_buffer;
+        std::vector<std::byte> m_buffer_flushing;
+        std::future<bool> m_flush;
+        uint64_t m_write_offset = 0;
+        bool m_write_failed     = false;
+        const std::byte* m_mapped_data  = nullptr;
+        uint64_t m_mapped_size          = 0;
+        uint64_t m_mapped_offset        = 0;
 		uint32_t m_flags;
 		bool m_is_open;
 	};
@@ -42,6 +42,10 @@ namespace Spartan
 
 	Input::Input(Context* context) : ISubsystem(context)
 	{
+        // Without a window there is nothing to receive input from
+        if (context->m_engine->EngineMode_IsSet(Engine_Headless))
+            return;
+
         const WindowData& window_data   = context->m_engine->GetWindowData();
 		const auto window_handle	    = static_cast<HWND>(window_data.handle);
 
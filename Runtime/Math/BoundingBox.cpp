@@ -111,6 +111,32 @@ namespace Spartan::Math
 
 	BoundingBox BoundingBox::Transform(const Matrix& transform) const
 	{
+#if SPARTAN_MATH_SIMD
+        // The matrix rows are only transposed once and shared by the center and the extents
+        __m128 r0, r1, r2, r3;
+        transform.LoadRows(r0, r1, r2, r3);
+
+        const Vector3 center_old = GetCenter();
+        const Vector3 extent_old = GetExtents();
+
+        __m128 center = _mm_mul_ps(r0, _mm_set1_ps(center_old.x));
+        center = _mm_add_ps(center, _mm_mul_ps(r1, _mm_set1_ps(center_old.y)));
+        center = _mm_add_ps(center, _mm_mul_ps(r2, _mm_set1_ps(center_old.z)));
+        center = _mm_add_ps(center, r3);
+        center = _mm_mul_ps(center, _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(center, center, _MM_SHUFFLE(3, 3, 3, 3))));
+
+        const __m128 mask_abs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 extent = _mm_mul_ps(_mm_and_ps(r0, mask_abs), _mm_set1_ps(extent_old.x));
+        extent = _mm_add_ps(extent, _mm_mul_ps(_mm_and_ps(r1, mask_abs), _mm_set1_ps(extent_old.y)));
+        extent = _mm_add_ps(extent, _mm_mul_ps(_mm_and_ps(r2, mask_abs), _mm_set1_ps(extent_old.z)));
+
+        alignas(16) float min[4];
+        alignas(16) float max[4];
+        _mm_store_ps(min, _mm_sub_ps(center, extent));
+        _mm_store_ps(max, _mm_add_ps(center, extent));
+
+        return BoundingBox(Vector3(min[0], min[1], min[2]), Vector3(max[0], max[1], max[2]));
+#else
         const Vector3 center_new = transform * GetCenter();
         const Vector3 extent_old = GetExtents();
         const Vector3 extend_new = Vector3
@@ -121,6 +147,7 @@ namespace Spartan::Math
 		);
 
 		return BoundingBox(center_new - extend_new, center_new + extend_new);
+#endif
 	}
 
     void BoundingBox::Merge(const BoundingBox& box)
@@ -129,7 +156,7 @@ namespace Spartan::Math
         m_min.y = Helper::Min(m_min.y, box.m_min.y);
         m_min.z = Helper::Min(m_min.z, box.m_min.z);
         m_max.x = Helper::Max(m_max.x, box.m_max.x);
-        m_max.y = Helper::Max(m_max.x, box.m_max.x);
-        m_max.z = Helper::Max(m_max.x, box.m_max.x);
+        m_max.y = Helper::Max(m_max.y, box.m_max.y);
+        m_max.z = Helper::Max(m_max.z, box.m_max.z);
     }
 }
@@ -86,42 +86,84 @@ namespace Spartan::Math
 
     bool Frustum::IsVisible(const Vector3& center, const Vector3& extent, bool ignore_near_plane /*= false*/) const
     {
-        float radius = 0.0f;
+        return CheckCube(center, extent, ignore_near_plane) != Outside;
+    }
+
+    uint32_t Frustum::IsVisible(const BoundingBoxSoA& boxes, uint32_t offset, bool ignore_near_plane /*= false*/) const
+    {
+        if (offset >= boxes.GetCount())
+            return 0;
+
+        const uint32_t count    = Helper::Min(boxes.GetCount() - offset, 32u);
+        const uint32_t mask     = count == 32 ? ~0u : (1u << count) - 1;
 
-        if (!ignore_near_plane)
+        // Which plane is the near one depends on reverse-z, so both depth planes are skipped when ignoring it
+        const uint32_t plane_first = ignore_near_plane ? 2 : 0;
+
+        uint32_t visible = 0;
+#if SPARTAN_MATH_SIMD
+        // Four boxes at a time, the storage is padded to 32 boxes so reading past count is safe
+        for (uint32_t i = 0; i < count; i += 4)
         {
-            radius = Helper::Max3(extent.x, extent.y, extent.z);
+            const uint32_t index    = offset + i;
+            const __m128 center_x   = _mm_loadu_ps(&boxes.center_x[index]);
+            const __m128 center_y   = _mm_loadu_ps(&boxes.center_y[index]);
+            const __m128 center_z   = _mm_loadu_ps(&boxes.center_z[index]);
+            const __m128 extent_x   = _mm_loadu_ps(&boxes.extent_x[index]);
+            const __m128 extent_y   = _mm_loadu_ps(&boxes.extent_y[index]);
+            const __m128 extent_z   = _mm_loadu_ps(&boxes.extent_z[index]);
+
+            __m128 outside = _mm_setzero_ps();
+            for (uint32_t plane_index = plane_first; plane_index < 6; plane_index++)
+            {
+                const Plane& plane = m_planes[plane_index];
+
+                // Distance of the center and projected radius of the box, along the plane normal
+                __m128 d = _mm_mul_ps(center_x, _mm_set1_ps(plane.normal.x));
+                d = _mm_add_ps(d, _mm_mul_ps(center_y, _mm_set1_ps(plane.normal.y)));
+                d = _mm_add_ps(d, _mm_mul_ps(center_z, _mm_set1_ps(plane.normal.z)));
+
+                __m128 r = _mm_mul_ps(extent_x, _mm_set1_ps(Helper::Abs(plane.normal.x)));
+                r = _mm_add_ps(r, _mm_mul_ps(extent_y, _mm_set1_ps(Helper::Abs(plane.normal.y))));
+                r = _mm_add_ps(r, _mm_mul_ps(extent_z, _mm_set1_ps(Helper::Abs(plane.normal.z))));
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), _mm_set1_ps(-plane.d)));
+            }
+
+            visible |= static_cast<uint32_t>(~_mm_movemask_ps(outside) & 0xF) << i;
         }
-        else
+#else
+        for (uint32_t i = 0; i < count; i++)
         {
-            constexpr float z = numeric_limits<float>::infinity(); // reverse-z only (but I must read form Renderer)
-            radius = Helper::Max3(extent.x, extent.y, z);
+            const uint32_t index    = offset + i;
+            const Vector3 center    = Vector3(boxes.center_x[index], boxes.center_y[index], boxes.center_z[index]);
+            const Vector3 extent    = Vector3(boxes.extent_x[index], boxes.extent_y[index], boxes.extent_z[index]);
+
+            if (CheckCube(center, extent, ignore_near_plane) != Outside)
+            {
+                visible |= 1u << i;
+            }
         }
+#endif
 
-        // Check sphere first as it's cheaper
-        if (CheckSphere(center, radius) != Outside)
-            return true;
-
-        if (CheckCube(center, radius) != Outside)
-            return true;
-
-        return false;
+        return visible & mask;
     }
 
-	Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent) const
+	Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent, bool ignore_near_plane) const
 	{
         Intersection result = Inside;
-        Plane plane_abs;
 
-		// Check if any one point of the cube is in the view frustum.
-		
-		for (const Plane& plane : m_planes)
+        // Which plane is the near one depends on reverse-z, so both depth planes are skipped when ignoring it
+        const uint32_t plane_first = ignore_near_plane ? 2 : 0;
+
+		// Compare the distance of the center against the extent projected onto the plane normal
+		for (uint32_t plane_index = plane_first; plane_index < 6; plane_index++)
 		{
-            plane_abs.normal    = plane.normal.Abs();
-            plane_abs.d         = plane.d;
+            const Plane& plane = m_planes[plane_index];
+            const Vector3 normal_abs = plane.normal.Abs();
 
             const float d   = center.x * plane.normal.x + center.y * plane.normal.y + center.z * plane.normal.z;
-            const float r   = extent.x * plane_abs.normal.x + extent.y * plane_abs.normal.y + extent.z * plane_abs.normal.z;
+            const float r   = extent.x * normal_abs.x + extent.y * normal_abs.y + extent.z * normal_abs.z;
 
             const float d_p_r = d + r;
             const float d_m_r = d - r;
@@ -140,25 +182,4 @@ namespace Spartan::Math
 
 		return result;
 	}
-
-	Intersection Frustum::CheckSphere(const Vector3& center, float radius) const
-	{
-		// calculate our distances to each of the planes
-		for (const auto& plane : m_planes)
-		{
-			// find the distance to this plane
-            const float distance = Vector3::Dot(plane.normal, center) + plane.d;
-
-			// if this distance is < -sphere.radius, we are outside
-			if (distance < -radius)
-				return Outside;
-
-			// else if the distance is between +- radius, then we intersect
-			if (static_cast<float>(Helper::Abs(distance)) < radius)
-				return Intersects;
-		}
-
-		// otherwise we are fully in view
-		return Inside;
-	}
 }
@@ -22,13 +22,50 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES =============
+#include <vector>
 #include "../Math/Plane.h"
+#include "BoundingBox.h"
 #include "Matrix.h"
 #include "Vector3.h"
 //========================
 
 namespace Spartan::Math
 {
+    // Bounding boxes as center and extent arrays, one per component, so that several boxes can be tested at once
+    struct BoundingBoxSoA
+    {
+        // Resizes while keeping the storage padded to a multiple of 32 boxes (the padding is zeroed)
+        void Resize(const uint32_t count)
+        {
+            const uint32_t count_padded = (count + 31) & ~31u;
+            for (std::vector<float>* component : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z })
+            {
+                component->assign(count_padded, 0.0f);
+            }
+            m_count = count;
+        }
+
+        void Set(const uint32_t index, const BoundingBox& box)
+        {
+            const Vector3 center  = box.GetCenter();
+            const Vector3 extents = box.GetExtents();
+            center_x[index] = center.x; center_y[index] = center.y; center_z[index] = center.z;
+            extent_x[index] = extents.x; extent_y[index] = extents.y; extent_z[index] = extents.z;
+        }
+
+        uint32_t GetCount() const { return m_count; }
+
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> center_z;
+        std::vector<float> extent_x;
+        std::vector<float> extent_y;
+        std::vector<float> extent_z;
+
+    private:
+        uint32_t m_count = 0;
+    };
+
 	class Frustum
 	{
 	public:
@@ -38,9 +75,11 @@ namespace Spartan::Math
 
         bool IsVisible(const Vector3& center, const Vector3& extent, bool ignore_near_plane = false) const;
 
+        // Tests up to 32 boxes, starting at offset (a multiple of 32), and returns a mask where bit i is set if box offset + i is visible
+        uint32_t IsVisible(const BoundingBoxSoA& boxes, uint32_t offset, bool ignore_near_plane = false) const;
+
 	private:
-        Intersection CheckCube(const Vector3& center, const Vector3& extent) const;
-        Intersection CheckSphere(const Vector3& center, float radius) const;
+        Intersection CheckCube(const Vector3& center, const Vector3& extent, bool ignore_near_plane) const;
 
 		Plane m_planes[6];
 	};
@@ -27,6 +27,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <random>
 //===============
 
+// SIMD - Define SPARTAN_MATH_SIMD as 0 to force the scalar implementations
+#ifndef SPARTAN_MATH_SIMD
+    #if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+        #define SPARTAN_MATH_SIMD 1
+    #else
+        #define SPARTAN_MATH_SIMD 0
+    #endif
+#endif
+
+#if SPARTAN_MATH_SIMD
+#include <emmintrin.h>
+#endif
+
 namespace Spartan::Math
 {
     enum Intersection
@@ -29,7 +29,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Spartan::Math
 {
-	class SPARTAN_CLASS Matrix
+	// 16 byte aligned so that each column can be loaded into a single SIMD register
+	class alignas(16) SPARTAN_CLASS Matrix
 	{
 	public:
 		Matrix()
@@ -125,10 +126,20 @@ namespace Spartan::Math
 
 			// Extract rotation and remove scaling
 			Matrix normalized;
+#if SPARTAN_MATH_SIMD
+            // Each column holds one element of every row, so dividing it by (sx, sy, sz, 1) removes the scaling of all three rows at once
+            const __m128 divisor    = _mm_setr_ps(scale.x, scale.y, scale.z, 1.0f);
+            const __m128 mask_w     = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+            _mm_store_ps(&normalized.m00, _mm_and_ps(_mm_div_ps(_mm_load_ps(&m00), divisor), mask_w));
+            _mm_store_ps(&normalized.m01, _mm_and_ps(_mm_div_ps(_mm_load_ps(&m01), divisor), mask_w));
+            _mm_store_ps(&normalized.m02, _mm_and_ps(_mm_div_ps(_mm_load_ps(&m02), divisor), mask_w));
+            _mm_store_ps(&normalized.m03, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+#else
 			normalized.m00 = m00 / scale.x; normalized.m01 = m01 / scale.x; normalized.m02 = m02 / scale.x; normalized.m03 = 0.0f;
 			normalized.m10 = m10 / scale.y; normalized.m11 = m11 / scale.y; normalized.m12 = m12 / scale.y; normalized.m13 = 0.0f;
 			normalized.m20 = m20 / scale.z; normalized.m21 = m21 / scale.z; normalized.m22 = m22 / scale.z; normalized.m23 = 0.0f;
 			normalized.m30 = 0; normalized.m31 = 0; normalized.m32 = 0; normalized.m33 = 1.0f;
+#endif
 
 			return RotationMatrixToQuaternion(normalized);
 		}
@@ -191,6 +202,20 @@ namespace Spartan::Math
 		//= SCALE ========================================================================================
         [[nodiscard]] Vector3 GetScale() const
 		{
+#if SPARTAN_MATH_SIMD
+            // Lane i of the columns holds row i, so all three row lengths (and signs) are computed at once
+            const __m128 c0         = _mm_load_ps(&m00);
+            const __m128 c1         = _mm_load_ps(&m01);
+            const __m128 c2         = _mm_load_ps(&m02);
+            const __m128 c3         = _mm_load_ps(&m03);
+            const __m128 length     = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, c0), _mm_mul_ps(c1, c1)), _mm_mul_ps(c2, c2)));
+            const __m128 product    = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(c0, c1), c2), c3);
+            const __m128 sign       = _mm_and_ps(_mm_cmplt_ps(product, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+
+            alignas(16) float scale[4];
+            _mm_store_ps(scale, _mm_xor_ps(length, sign));
+            return Vector3(scale[0], scale[1], scale[2]);
+#else
             const int xs = (Helper::Sign(m00 * m01 * m02 * m03) < 0) ? -1 : 1;
             const int ys = (Helper::Sign(m10 * m11 * m12 * m13) < 0) ? -1 : 1;
             const int zs = (Helper::Sign(m20 * m21 * m22 * m23) < 0) ? -1 : 1;
@@ -200,6 +225,7 @@ namespace Spartan::Math
 				static_cast<float>(ys) * Helper::Sqrt(m10 * m10 + m11 * m11 + m12 * m12),
 				static_cast<float>(zs) * Helper::Sqrt(m20 * m20 + m21 * m21 + m22 * m22)
 			);
+#endif
 		}
 
 		static inline Matrix CreateScale(float scale) { return CreateScale(scale, scale, scale); }
@@ -286,6 +312,86 @@ namespace Spartan::Math
         [[nodiscard]] Matrix Inverted() const { return Invert(*this); }
 		static inline Matrix Invert(const Matrix& matrix)
 		{
+#if SPARTAN_MATH_SIMD
+            // Cramer's rule, computing the cofactors four at a time (based on Intel's "Streaming SIMD Extensions - Inverse of 4x4 Matrix").
+            // The inverse of the transpose is the transpose of the inverse, so this works on the column-major data as is.
+            __m128 row0 = _mm_load_ps(&matrix.m00);
+            __m128 row1 = _mm_load_ps(&matrix.m01);
+            __m128 row2 = _mm_load_ps(&matrix.m02);
+            __m128 row3 = _mm_load_ps(&matrix.m03);
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+            row1 = _mm_shuffle_ps(row1, row1, 0x4E);
+            row3 = _mm_shuffle_ps(row3, row3, 0x4E);
+
+            __m128 minor0, minor1, minor2, minor3;
+            __m128 tmp;
+
+            tmp     = _mm_mul_ps(row2, row3);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0xB1);
+            minor0  = _mm_mul_ps(row1, tmp);
+            minor1  = _mm_mul_ps(row0, tmp);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0x4E);
+            minor0  = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+            minor1  = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+            minor1  = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+            tmp     = _mm_mul_ps(row1, row2);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0xB1);
+            minor0  = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+            minor3  = _mm_mul_ps(row0, tmp);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0x4E);
+            minor0  = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+            minor3  = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+            minor3  = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+            tmp     = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0xB1);
+            row2    = _mm_shuffle_ps(row2, row2, 0x4E);
+            minor0  = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+            minor2  = _mm_mul_ps(row0, tmp);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0x4E);
+            minor0  = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+            minor2  = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+            minor2  = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+            tmp     = _mm_mul_ps(row0, row1);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0xB1);
+            minor2  = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+            minor3  = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0x4E);
+            minor2  = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+            minor3  = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+            tmp     = _mm_mul_ps(row0, row3);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0xB1);
+            minor1  = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+            minor2  = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0x4E);
+            minor1  = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+            minor2  = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+            tmp     = _mm_mul_ps(row0, row2);
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0xB1);
+            minor1  = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+            minor3  = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+            tmp     = _mm_shuffle_ps(tmp, tmp, 0x4E);
+            minor1  = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+            minor3  = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+            // Determinant - A true division (instead of _mm_rcp_ss) keeps the precision of the scalar path
+            __m128 det = _mm_mul_ps(row0, minor0);
+            det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+            det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+            det = _mm_div_ss(_mm_set_ss(1.0f), det);
+            det = _mm_shuffle_ps(det, det, 0x00);
+
+            Matrix result;
+            _mm_store_ps(&result.m00, _mm_mul_ps(det, minor0));
+            _mm_store_ps(&result.m01, _mm_mul_ps(det, minor1));
+            _mm_store_ps(&result.m02, _mm_mul_ps(det, minor2));
+            _mm_store_ps(&result.m03, _mm_mul_ps(det, minor3));
+            return result;
+#else
 			float v0 = matrix.m20 * matrix.m31 - matrix.m21 * matrix.m30;
 			float v1 = matrix.m20 * matrix.m32 - matrix.m22 * matrix.m30;
 			float v2 = matrix.m20 * matrix.m33 - matrix.m23 *matrix.m30;
@@ -339,6 +445,7 @@ namespace Spartan::Math
 				i10, i11, i12, i13,
 				i20, i21, i22, i23,
 				i30, i31, i32, i33);
+#endif
 		}
 		//================================================================================================
 
@@ -360,6 +467,27 @@ namespace Spartan::Math
 		//= MULTIPLICATION ================================================================================================================
 		Matrix operator*(const Matrix& rhs) const
 		{
+#if SPARTAN_MATH_SIMD
+            // Every column of the result is a linear combination of this matrix's columns, weighted by the matching column of rhs
+            const __m128 c0 = _mm_load_ps(&m00);
+            const __m128 c1 = _mm_load_ps(&m01);
+            const __m128 c2 = _mm_load_ps(&m02);
+            const __m128 c3 = _mm_load_ps(&m03);
+
+            Matrix result;
+            const float* column_rhs = rhs.Data();
+            float* column_result    = &result.m00;
+            for (uint32_t i = 0; i < 4; i++, column_rhs += 4, column_result += 4)
+            {
+                __m128 column = _mm_mul_ps(c0, _mm_set1_ps(column_rhs[0]));
+                column = _mm_add_ps(column, _mm_mul_ps(c1, _mm_set1_ps(column_rhs[1])));
+                column = _mm_add_ps(column, _mm_mul_ps(c2, _mm_set1_ps(column_rhs[2])));
+                column = _mm_add_ps(column, _mm_mul_ps(c3, _mm_set1_ps(column_rhs[3])));
+                _mm_store_ps(column_result, column);
+            }
+
+            return result;
+#else
 			return Matrix(
 				m00 * rhs.m00 + m01 * rhs.m10 + m02 * rhs.m20 + m03 * rhs.m30,
 				m00 * rhs.m01 + m01 * rhs.m11 + m02 * rhs.m21 + m03 * rhs.m31,
@@ -378,12 +506,27 @@ namespace Spartan::Math
 				m30 * rhs.m02 + m31 * rhs.m12 + m32 * rhs.m22 + m33 * rhs.m32,
 				m30 * rhs.m03 + m31 * rhs.m13 + m32 * rhs.m23 + m33 * rhs.m33
 			);
+#endif
 		}
 
 		void operator*=(const Matrix& rhs) { (*this) = (*this) * rhs; }
 
 		Vector3 operator*(const Vector3& rhs) const
 		{
+#if SPARTAN_MATH_SIMD
+            __m128 r0, r1, r2, r3;
+            LoadRows(r0, r1, r2, r3);
+
+            __m128 result = _mm_mul_ps(r0, _mm_set1_ps(rhs.x));
+            result = _mm_add_ps(result, _mm_mul_ps(r1, _mm_set1_ps(rhs.y)));
+            result = _mm_add_ps(result, _mm_mul_ps(r2, _mm_set1_ps(rhs.z)));
+            result = _mm_add_ps(result, r3);
+            result = _mm_mul_ps(result, _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 3, 3, 3))));
+
+            alignas(16) float v[4];
+            _mm_store_ps(v, result);
+            return Vector3(v[0], v[1], v[2]);
+#else
 			Vector4 vWorking;
 
 			vWorking.x = (rhs.x * m00) + (rhs.y * m10) + (rhs.z * m20) + m30;
@@ -392,10 +535,24 @@ namespace Spartan::Math
 			vWorking.w = 1 / ((rhs.x * m03) + (rhs.y * m13) + (rhs.z * m23) + m33);
 
 			return Vector3(vWorking.x * vWorking.w, vWorking.y * vWorking.w, vWorking.z * vWorking.w);
+#endif
 		}
 
         Vector4 operator*(const Vector4& rhs) const
         {
+#if SPARTAN_MATH_SIMD
+            __m128 r0, r1, r2, r3;
+            LoadRows(r0, r1, r2, r3);
+
+            __m128 result = _mm_mul_ps(r0, _mm_set1_ps(rhs.x));
+            result = _mm_add_ps(result, _mm_mul_ps(r1, _mm_set1_ps(rhs.y)));
+            result = _mm_add_ps(result, _mm_mul_ps(r2, _mm_set1_ps(rhs.z)));
+            result = _mm_add_ps(result, _mm_mul_ps(r3, _mm_set1_ps(rhs.w)));
+
+            alignas(16) float v[4];
+            _mm_store_ps(v, result);
+            return Vector4(v[0], v[1], v[2], v[3]);
+#else
             return Vector4
             (
                 (rhs.x * m00) + (rhs.y * m10) + (rhs.z * m20) + (rhs.w * m30),
@@ -403,6 +560,7 @@ namespace Spartan::Math
                 (rhs.x * m02) + (rhs.y * m12) + (rhs.z * m22) + (rhs.w * m32),
                 (rhs.x * m03) + (rhs.y * m13) + (rhs.z * m23) + (rhs.w * m33)
             );
+#endif
         }
 		//=================================================================================================================================
 
@@ -440,6 +598,17 @@ namespace Spartan::Math
 		//==================================================================
 
         [[nodiscard]] const float* Data() const { return &m00; }
+#if SPARTAN_MATH_SIMD
+        // Loads the rows (mi0, mi1, mi2, mi3), the memory holds columns so they have to be transposed
+        void LoadRows(__m128& r0, __m128& r1, __m128& r2, __m128& r3) const
+        {
+            r0 = _mm_load_ps(&m00);
+            r1 = _mm_load_ps(&m01);
+            r2 = _mm_load_ps(&m02);
+            r3 = _mm_load_ps(&m03);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        }
+#endif
         [[nodiscard]] std::string ToString() const;
 
 		// Column-major memory representation 
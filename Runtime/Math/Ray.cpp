@@ -24,7 +24,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Environment.h"
-#include "../World/Components/Renderable.h"
 //==========================================
 
 //= NAMESPACES =====
@@ -46,30 +45,7 @@ namespace Spartan::Math
 	{
 		// Find all the entities that the ray hits
 		vector<RayHit> hits;
-		const auto& entities = context->GetSubsystem<World>()->EntityGetAll();
-		for (const auto& entity : entities)
-		{
-			// Make sure there entity has a renderable
-			if (!entity->HasComponent<Renderable>())
-				continue;
-
-			// Get object oriented bounding box
-			const auto& aabb = entity->GetComponent<Renderable>()->GetAabb();
-
-			// Compute hit distance
-			auto distance = HitDistance(aabb);
-
-			// Don't store hit data if there was no hit
-			if (distance == INFINITY)
-				continue;
-
-			hits.emplace_back(
-                entity,                             // Entity
-                m_start + distance * m_direction,   // Position
-                distance,                           // Distance
-                distance == 0.0f                    // Inside
-            );
-		}
+		context->GetSubsystem<World>()->GetBvh().QueryRay(*this, hits);
 
 		// Sort by distance (ascending)
 		sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b)
@@ -55,6 +55,9 @@ namespace Spartan
 		//= Subsystem =======================
 		bool Initialize() override;
 		void Tick(float delta_time) override;
+		uint32_t GetTickDataRead()		const override { return Tick_Data_Physics; }
+		uint32_t GetTickDataWrite()		const override { return Tick_Data_Physics | Tick_Data_World | Tick_Data_Rhi; } // rigid bodies move their transforms, debug draw adds renderer lines
+		bool CanTickOnWorkerThread()	const override { return true; }
 		//===================================
 
         // Rigid body
@@ -0,0 +1,455 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "Spartan.h"
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "../Rendering/Renderer.h"
+#include "../RHI/RHI_Device.h"
+#include "../RHI/RHI_SwapChain.h"
+#include "../RHI/RHI_CommandList.h"
+#include "../RHI/RHI_Implementation.h"
+#include "../Threading/Threading.h"
+#include "../World/World.h"
+#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+//======================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    namespace _Benchmark
+    {
+        struct Statistics
+        {
+            float mean  = 0.0f;
+            float min   = 0.0f;
+            float max   = 0.0f;
+            float p50   = 0.0f;
+            float p95   = 0.0f;
+        };
+
+        Statistics compute_statistics(vector<float> values)
+        {
+            Statistics statistics;
+            if (values.empty())
+                return statistics;
+
+            sort(values.begin(), values.end());
+
+            float sum = 0.0f;
+            for (const float value : values)
+            {
+                sum += value;
+            }
+
+            const auto percentile = [&values](const float p) { return values[static_cast<size_t>(p * (values.size() - 1) + 0.5f)]; };
+
+            statistics.mean = sum / static_cast<float>(values.size());
+            statistics.min  = values.front();
+            statistics.max  = values.back();
+            statistics.p50  = percentile(0.5f);
+            statistics.p95  = percentile(0.95f);
+
+            return statistics;
+        }
+
+        const char* api_name(const RHI_Api_Type api_type)
+        {
+            switch (api_type)
+            {
+                case RHI_Api_D3d11:     return "D3D11";
+                case RHI_Api_D3d12:     return "D3D12";
+                case RHI_Api_Vulkan:    return "Vulkan";
+                case RHI_Api_Null:      return "Null";
+                default:                return "Unknown";
+            }
+        }
+
+        // Command line values, anything which isn't entirely a number within range is rejected (and logged)
+        bool parse_value(const string& argument, const char* text, uint32_t& value)
+        {
+            errno = 0;
+            char* end                       = nullptr;
+            const unsigned long long parsed = strtoull(text, &end, 10);
+            if (end == text || *end != '\0' || errno == ERANGE || text[0] == '-' || parsed > numeric_limits<uint32_t>::max())
+            {
+                LOG_ERROR("Invalid value \"%s\" for %s, expected an unsigned integer", text, argument.c_str());
+                return false;
+            }
+
+            value = static_cast<uint32_t>(parsed);
+            return true;
+        }
+
+        bool parse_value(const string& argument, const char* text, double& value)
+        {
+            errno = 0;
+            char* end           = nullptr;
+            const double parsed = strtod(text, &end);
+            if (end == text || *end != '\0' || errno == ERANGE || !isfinite(parsed) || parsed <= 0.0)
+            {
+                LOG_ERROR("Invalid value \"%s\" for %s, expected a positive number", text, argument.c_str());
+                return false;
+            }
+
+            value = parsed;
+            return true;
+        }
+
+        string escape_json(const string& text)
+        {
+            string escaped;
+            escaped.reserve(text.size());
+
+            for (const char c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+
+            return escaped;
+        }
+    }
+
+    Benchmark::Benchmark(const BenchmarkSettings& settings)
+    {
+        m_settings = settings;
+    }
+
+    Benchmark::~Benchmark()
+    {
+        m_samples.clear();
+        m_engine.reset();
+    }
+
+    int Benchmark::Run()
+    {
+        // The reason has been logged while parsing
+        if (!m_settings.command_line_valid)
+            return 1;
+
+        // Create a headless engine, the resolution comes from the settings as there is no window
+        WindowData window_data;
+        window_data.width   = static_cast<float>(m_settings.width);
+        window_data.height  = static_cast<float>(m_settings.height);
+        m_engine            = make_unique<Engine>(window_data, Engine_Physics | Engine_Game | Engine_Headless);
+
+        Context* context    = m_engine->GetContext();
+        Renderer* renderer  = context->GetSubsystem<Renderer>();
+        Profiler* profiler  = context->GetSubsystem<Profiler>();
+
+        // The D3D and Vulkan swap chains need a window, so headless rendering requires the null RHI
+        if (!renderer->IsInitialized())
+        {
+            LOG_ERROR("The renderer failed to initialize, headless runs need a backend which can present without a window");
+            return 1;
+        }
+
+        // Every tick advances the simulation by the same amount and gets profiled
+        context->GetSubsystem<Timer>()->SetFixedDeltaTimeMs(m_settings.delta_time_ms);
+        profiler->SetUpdateInterval(0.0f);
+
+        #if defined(API_GRAPHICS_NULL)
+        profiler->SetProfilingEnabledGpu(false); // nothing executes, so there is nothing to time
+        #endif
+
+        if (!LoadWorld())
+            return 1;
+
+        // Let background work (e.g. resource loading) finish, then warm up the caches
+        Threading* threading = context->GetSubsystem<Threading>();
+        while (threading->AreTasksRunning())
+        {
+            this_thread::sleep_for(chrono::milliseconds(16));
+        }
+
+        for (uint32_t i = 0; i < m_settings.warmup_frame_count; i++)
+        {
+            Tick();
+        }
+
+        #if defined(API_GRAPHICS_NULL)
+        RHI_Context* rhi_context = renderer->GetRhiDevice()->GetContextRhi();
+        if (m_settings.trace_frame_count != 0)
+        {
+            FileSystem::Delete(rhi_context->trace_file_path);
+            rhi_context->trace_frames = m_settings.trace_frame_count;
+        }
+        rhi_context->validation_errors = 0;
+        #endif
+
+        // Measure, the time blocks of a frame are resolved when the next one starts, so the last tick only does that
+        LOG_INFO("Running %d frames at %.2f ms per frame...", m_settings.frame_count, m_settings.delta_time_ms);
+        for (uint32_t frame = 0; frame <= m_settings.frame_count; frame++)
+        {
+            Stopwatch stopwatch;
+            Tick();
+            const float frame_ms = stopwatch.GetElapsedTimeMs();
+
+            if (frame != 0)
+            {
+                RecordTimeBlocks(frame - 1);
+            }
+
+            if (frame != m_settings.frame_count)
+            {
+                RecordFrame(frame, frame_ms);
+            }
+        }
+
+        if (!Write())
+            return 1;
+
+        #if defined(API_GRAPHICS_NULL)
+        if (rhi_context->validation_errors != 0)
+        {
+            LOG_ERROR("The command streams had %d validation errors", rhi_context->validation_errors.load());
+            return 2;
+        }
+        #endif
+
+        return 0;
+    }
+
+    bool Benchmark::ParseCommandLine(int argc, const char* const* argv, BenchmarkSettings& settings)
+    {
+        bool headless       = false;
+        bool format_set     = false;
+        bool valid          = true;
+
+        for (int i = 1; i < argc; i++)
+        {
+            const string argument   = argv[i];
+            const bool has_value    = i + 1 < argc;
+
+            if (argument == "-headless")
+            {
+                headless = true;
+            }
+            else if (argument == "-world" && has_value)
+            {
+                settings.world_file_path = argv[++i];
+            }
+            else if (argument == "-output" && has_value)
+            {
+                settings.output_file_path = argv[++i];
+            }
+            else if (argument == "-format" && has_value)
+            {
+                settings.format = string(argv[++i]) == "csv" ? Benchmark_Csv : Benchmark_Json;
+                format_set      = true;
+            }
+            else if (argument == "-frames" && has_value)
+            {
+                valid &= _Benchmark::parse_value(argument, argv[++i], settings.frame_count);
+            }
+            else if (argument == "-warmup" && has_value)
+            {
+                valid &= _Benchmark::parse_value(argument, argv[++i], settings.warmup_frame_count);
+            }
+            else if (argument == "-delta" && has_value)
+            {
+                valid &= _Benchmark::parse_value(argument, argv[++i], settings.delta_time_ms);
+            }
+            else if (argument == "-resolution" && i + 2 < argc)
+            {
+                valid &= _Benchmark::parse_value(argument, argv[++i], settings.width);
+                valid &= _Benchmark::parse_value(argument, argv[++i], settings.height);
+            }
+            else if (argument == "-trace" && has_value)
+            {
+                valid &= _Benchmark::parse_value(argument, argv[++i], settings.trace_frame_count);
+            }
+        }
+
+        // Without an explicit format, the output file extension decides
+        if (!format_set)
+        {
+            settings.format = FileSystem::GetExtensionFromFilePath(settings.output_file_path) == ".csv" ? Benchmark_Csv : Benchmark_Json;
+        }
+
+        settings.command_line_valid = valid;
+
+        return headless;
+    }
+
+    void Benchmark::Tick() const
+    {
+        // Same as the editor's tick, minus the UI
+        Renderer* renderer = m_engine->GetContext()->GetSubsystem<Renderer>();
+        renderer->GetSwapChain()->GetCmdList()->Begin();
+        m_engine->Tick();
+        renderer->Present();
+    }
+
+    bool Benchmark::LoadWorld()
+    {
+        if (m_settings.world_file_path.empty())
+            return true;
+
+        Context* context        = m_engine->GetContext();
+        World* world            = context->GetSubsystem<World>();
+        Threading* threading    = context->GetSubsystem<Threading>();
+
+        // World::LoadFromFile() waits for the world to acknowledge the request when it ticks, so it has to run on another thread
+        TaskCounter counter;
+        bool loaded = false;
+        const string& file_path = m_settings.world_file_path;
+        threading->AddTask([world, &file_path, &loaded]() { loaded = world->LoadFromFile(file_path); }, &counter);
+
+        while (!counter.IsDone())
+        {
+            Tick();
+        }
+
+        if (!loaded)
+        {
+            LOG_ERROR("Failed to load \"%s\"", file_path.c_str());
+        }
+
+        return loaded;
+    }
+
+    void Benchmark::RecordFrame(const uint32_t frame, const float frame_ms)
+    {
+        Profiler* profiler = m_engine->GetContext()->GetSubsystem<Profiler>();
+
+        // Metrics are cleared when the profiler ticks, so at this point they are the ones of this frame
+        const uint32_t bindings =
+            profiler->m_rhi_bindings_buffer_index   +
+            profiler->m_rhi_bindings_buffer_vertex  +
+            profiler->m_rhi_bindings_buffer_constant+
+            profiler->m_rhi_bindings_sampler        +
+            profiler->m_rhi_bindings_texture        +
+            profiler->m_rhi_bindings_shader_vertex  +
+            profiler->m_rhi_bindings_shader_pixel   +
+            profiler->m_rhi_bindings_shader_compute +
+            profiler->m_rhi_bindings_render_target  +
+            profiler->m_rhi_bindings_descriptor_set +
+            profiler->m_rhi_bindings_pipeline;
+
+        AddSample(frame, "frame",               "time",     frame_ms);
+        AddSample(frame, "draw_calls",          "count",    static_cast<float>(profiler->m_rhi_draw_calls));
+        AddSample(frame, "bindings",            "count",    static_cast<float>(bindings));
+        AddSample(frame, "pipeline_barriers",   "count",    static_cast<float>(profiler->m_rhi_pipeline_barriers));
+        AddSample(frame, "meshes_rendered",     "count",    static_cast<float>(profiler->m_renderer_meshes_rendered));
+    }
+
+    void Benchmark::RecordTimeBlocks(const uint32_t frame)
+    {
+        for (const TimeBlock& time_block : m_engine->GetContext()->GetSubsystem<Profiler>()->GetTimeBlocks())
+        {
+            if (!time_block.IsComplete() || !time_block.GetName())
+                continue;
+
+            AddSample(frame, time_block.GetName(), time_block.GetType() == TimeBlock_Gpu ? "gpu" : "cpu", time_block.GetDuration());
+        }
+    }
+
+    void Benchmark::AddSample(const uint32_t frame, const string& name, const char* type, const float value)
+    {
+        auto it = find_if(m_samples.begin(), m_samples.end(), [&name, type](const Samples& samples) { return samples.type == type && samples.name == name; });
+        if (it == m_samples.end())
+        {
+            m_samples.emplace_back();
+            it          = m_samples.end() - 1;
+            it->name    = name;
+            it->type    = type;
+        }
+        else if (it->frame_last == frame)
+        {
+            it->values.back() += value;
+            return;
+        }
+
+        it->frame_last = frame;
+        it->values.emplace_back(value);
+    }
+
+    bool Benchmark::Write() const
+    {
+        ofstream fout(m_settings.output_file_path, ios::out | ios::trunc);
+        if (!fout.is_open())
+        {
+            LOG_ERROR("Failed to open \"%s\" for writing", m_settings.output_file_path.c_str());
+            return false;
+        }
+
+        if (m_settings.format == Benchmark_Csv)
+        {
+            fout << "name,type,frames,mean,min,max,p50,p95" << endl;
+
+            for (const Samples& samples : m_samples)
+            {
+                const _Benchmark::Statistics statistics = _Benchmark::compute_statistics(samples.values);
+                fout << "\"" << samples.name << "\"," << samples.type << "," << samples.values.size() << ","
+                     << statistics.mean << "," << statistics.min << "," << statistics.max << "," << statistics.p50 << "," << statistics.p95 << endl;
+            }
+        }
+        else
+        {
+            Renderer* renderer      = m_engine->GetContext()->GetSubsystem<Renderer>();
+            RHI_Device* rhi_device  = renderer->GetRhiDevice().get();
+            const PhysicalDevice* physical_device = rhi_device->GetPrimaryPhysicalDevice();
+
+            fout << "{" << endl;
+            fout << "    \"world\": \"" << _Benchmark::escape_json(m_settings.world_file_path) << "\"," << endl;
+            fout << "    \"api\": \"" << _Benchmark::api_name(rhi_device->GetContextRhi()->api_type) << "\"," << endl;
+            fout << "    \"gpu\": \"" << (physical_device ? _Benchmark::escape_json(physical_device->GetName()) : "") << "\"," << endl;
+            fout << "    \"frames\": " << m_settings.frame_count << "," << endl;
+            fout << "    \"delta_time_ms\": " << m_settings.delta_time_ms << "," << endl;
+            fout << "    \"resolution\": [" << m_settings.width << ", " << m_settings.height << "]," << endl;
+            #if defined(API_GRAPHICS_NULL)
+            fout << "    \"validation_errors\": " << rhi_device->GetContextRhi()->validation_errors.load() << "," << endl;
+            #endif
+            fout << "    \"samples\":" << endl;
+            fout << "    [" << endl;
+
+            for (size_t i = 0; i < m_samples.size(); i++)
+            {
+                const Samples& samples = m_samples[i];
+                const _Benchmark::Statistics statistics = _Benchmark::compute_statistics(samples.values);
+
+                fout << "        { \"name\": \"" << _Benchmark::escape_json(samples.name) << "\", \"type\": \"" << samples.type << "\", \"frames\": " << samples.values.size()
+                     << ", \"mean\": " << statistics.mean << ", \"min\": " << statistics.min << ", \"max\": " << statistics.max
+                     << ", \"p50\": " << statistics.p50 << ", \"p95\": " << statistics.p95 << " }" << (i + 1 != m_samples.size() ? "," : "") << endl;
+            }
+
+            fout << "    ]" << endl;
+            fout << "}" << endl;
+        }
+
+        fout.close();
+        LOG_INFO("Results written to \"%s\"", m_settings.output_file_path.c_str());
+        return true;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===========================
+#include <string>
+#include <vector>
+#include <memory>
+#include "../Core/Spartan_Definitions.h"
+//======================================
+
+namespace Spartan
+{
+    class Engine;
+
+    enum Benchmark_Format
+    {
+        Benchmark_Json,
+        Benchmark_Csv
+    };
+
+    struct BenchmarkSettings
+    {
+        std::string world_file_path;                        // empty benchmarks the default world
+        std::string output_file_path    = "benchmark.json";
+        Benchmark_Format format         = Benchmark_Json;
+        uint32_t frame_count            = 300;
+        uint32_t warmup_frame_count     = 10;
+        double delta_time_ms            = 1000.0 / 60.0;
+        uint32_t width                  = 1920;
+        uint32_t height                 = 1080;
+        uint32_t trace_frame_count      = 0;                // null RHI only, frames whose command streams get written to a text file
+        bool command_line_valid         = true;             // false if a value on the command line was malformed, Run() then fails
+    };
+
+    // Runs the engine without a window for a fixed number of frames at a fixed delta time
+    // and writes the per-frame timings of every time block, plus some RHI metrics, to a file.
+    class SPARTAN_CLASS Benchmark
+    {
+    public:
+        Benchmark(const BenchmarkSettings& settings);
+        ~Benchmark();
+
+        // Returns the process exit code, 0 on success, 1 on failure, 2 if the null RHI reported validation errors
+        int Run();
+
+        // Returns true if the command line asks for a headless run (-headless), in which case settings are filled from it.
+        // Malformed values are logged and make Run() fail, instead of being used.
+        static bool ParseCommandLine(int argc, const char* const* argv, BenchmarkSettings& settings);
+
+    private:
+        struct Samples
+        {
+            std::string name;
+            std::string type;
+            uint32_t frame_last = 0;
+            std::vector<float> values; // one per frame, blocks with the same name in a frame are summed
+        };
+
+        void Tick() const;
+        bool LoadWorld();
+        void RecordFrame(uint32_t frame, float frame_ms);
+        void RecordTimeBlocks(uint32_t frame);
+        void AddSample(uint32_t frame, const std::string& name, const char* type, float value);
+        bool Write() const;
+
+        BenchmarkSettings m_settings;
+        std::unique_ptr<Engine> m_engine;
+        std::vector<Samples> m_samples;
+    };
+}
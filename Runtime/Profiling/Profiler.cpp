@@ -73,6 +73,7 @@ namespace Spartan
         {
             OnFrameEnd();
 
+            lock_guard<mutex> lock(m_mutex_time_blocks);
             const uint32_t new_size = m_time_block_count + 100;
             m_time_blocks_read.reserve(new_size);
             m_time_blocks_read.resize(new_size);
@@ -124,7 +125,10 @@ namespace Spartan
     {
         // Clear time blocks
         {
-            uint32_t pass_index_gpu = 0;
+            lock_guard<mutex> lock(m_mutex_time_blocks);
+
+            // Every command list has its own timestamps
+            unordered_map<const RHI_CommandList*, uint32_t> pass_index_gpu;
 
             for (uint32_t i = 0; i < m_time_block_count; i++)
             {
@@ -134,10 +138,11 @@ namespace Spartan
                 {
                     // Must not happen when TimeBlockEnd() ends as D3D11 waits
                     // too much for the results to be ready, which increases CPU time.
-                    time_block.ComputeDuration(pass_index_gpu);
+                    uint32_t& pass_index = pass_index_gpu[time_block.GetCmdList()];
+                    time_block.ComputeDuration(pass_index);
                     if (time_block.GetType() == TimeBlock_Gpu)
                     {
-                        pass_index_gpu += 2;
+                        pass_index += 2;
                     }
 
                     m_time_blocks_read[i] = time_block;
@@ -150,6 +155,15 @@ namespace Spartan
                 time_block.Reset();
             }
 
+            // Drop blocks left over from frames which had more of them, so the read list only holds this frame
+            for (uint32_t i = m_time_block_count; i < static_cast<uint32_t>(m_time_blocks_read.size()); i++)
+            {
+                if (m_time_blocks_read[i].IsComplete())
+                {
+                    m_time_blocks_read[i] = TimeBlock();
+                }
+            }
+
             m_time_block_count = 0;
         }
 
@@ -211,7 +225,9 @@ namespace Spartan
 		if (!can_profile_cpu && !can_profile_gpu)
 			return;
 
-        // Last incomplete block of the same type, is the parent
+        lock_guard<mutex> lock(m_mutex_time_blocks);
+
+        // Last incomplete block of the same type (and thread), is the parent
         TimeBlock* time_block_parent = GetLastIncompleteTimeBlock(type);
 
 		if (TimeBlock* time_block = GetNewTimeBlock())
@@ -226,6 +242,7 @@ namespace Spartan
         if (m_increase_capacity)
             return;
 
+        lock_guard<mutex> lock(m_mutex_time_blocks);
 		if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
 		{
 			time_block->End();
@@ -263,10 +280,16 @@ namespace Spartan
 
 	TimeBlock* Profiler::GetLastIncompleteTimeBlock(TimeBlock_Type type /*= TimeBlock_Undefined*/)
 	{
+        const thread::id thread_id = this_thread::get_id();
+
 		for (int i = m_time_block_count - 1; i >= 0; i--)
 		{
 			TimeBlock& time_block = m_time_blocks_write[i];
 
+            // Blocks started by other threads belong to a different tree
+            if (time_block.GetThreadId() != thread_id)
+                continue;
+
             if (type == time_block.GetType() || type == TimeBlock_Undefined)
             {
                 if (!time_block.IsComplete())
@@ -371,19 +394,19 @@ namespace Spartan
 			material_count,
 
 			// RHI
-			m_rhi_draw_calls,
-			m_rhi_bindings_buffer_index,
-			m_rhi_bindings_buffer_vertex,
-			m_rhi_bindings_buffer_constant,
-			m_rhi_bindings_sampler,
-			m_rhi_bindings_texture,
-			m_rhi_bindings_shader_vertex,
-			m_rhi_bindings_shader_pixel,
-            m_rhi_bindings_shader_compute,
-			m_rhi_bindings_render_target,
-            m_rhi_bindings_pipeline,
-            m_rhi_bindings_descriptor_set,
-            m_rhi_pipeline_barriers
+			m_rhi_draw_calls.load(),
+			m_rhi_bindings_buffer_index.load(),
+			m_rhi_bindings_buffer_vertex.load(),
+			m_rhi_bindings_buffer_constant.load(),
+			m_rhi_bindings_sampler.load(),
+			m_rhi_bindings_texture.load(),
+			m_rhi_bindings_shader_vertex.load(),
+			m_rhi_bindings_shader_pixel.load(),
+            m_rhi_bindings_shader_compute.load(),
+			m_rhi_bindings_render_target.load(),
+            m_rhi_bindings_pipeline.load(),
+            m_rhi_bindings_descriptor_set.load(),
+            m_rhi_pipeline_barriers.load()
 		);
 
 		m_metrics = string(buffer);
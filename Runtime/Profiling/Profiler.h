@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===========================
 #include <string>
 #include <vector>
+#include <mutex>
+#include <atomic>
 #include "TimeBlock.h"
 #include "../Core/ISubsystem.h"
 #include "../Core/Stopwatch.h"
@@ -76,20 +78,20 @@ namespace Spartan
         bool IsCpuStuttering()                          const { return m_is_stuttering_cpu; }
         bool IsGpuStuttering()                          const { return m_is_stuttering_gpu; }
 		
-		// Metrics - RHI
-		uint32_t m_rhi_draw_calls				= 0;
-		uint32_t m_rhi_bindings_buffer_index	= 0;
-		uint32_t m_rhi_bindings_buffer_vertex	= 0;
-		uint32_t m_rhi_bindings_buffer_constant = 0;
-		uint32_t m_rhi_bindings_sampler			= 0;
-		uint32_t m_rhi_bindings_texture			= 0;
-		uint32_t m_rhi_bindings_shader_vertex	= 0;
-		uint32_t m_rhi_bindings_shader_pixel	= 0;
-        uint32_t m_rhi_bindings_shader_compute  = 0;
-		uint32_t m_rhi_bindings_render_target	= 0;
-        uint32_t m_rhi_bindings_descriptor_set  = 0;     
-        uint32_t m_rhi_bindings_pipeline        = 0;
-        uint32_t m_rhi_pipeline_barriers        = 0;
+		// Metrics - RHI (atomic, command lists can be recorded from multiple threads)
+        std::atomic<uint32_t> m_rhi_draw_calls               = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_index    = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_vertex   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_constant = 0;
+        std::atomic<uint32_t> m_rhi_bindings_sampler         = 0;
+        std::atomic<uint32_t> m_rhi_bindings_texture         = 0;
+        std::atomic<uint32_t> m_rhi_bindings_shader_vertex   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_shader_pixel    = 0;
+        std::atomic<uint32_t> m_rhi_bindings_shader_compute  = 0;
+        std::atomic<uint32_t> m_rhi_bindings_render_target   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_descriptor_set  = 0;
+        std::atomic<uint32_t> m_rhi_bindings_pipeline        = 0;
+        std::atomic<uint32_t> m_rhi_pipeline_barriers        = 0;
 
 		// Metrics - Renderer
 		uint32_t m_renderer_meshes_rendered = 0;
@@ -139,7 +141,8 @@ namespace Spartan
 		float m_profiling_interval_sec		= 0.3f;
 		float m_time_since_profiling_sec	= m_profiling_interval_sec;
 
-		// Time blocks (double buffered)
+		// Time blocks (double buffered), subsystems which tick concurrently start them from different threads
+		std::mutex m_mutex_time_blocks;
 		uint32_t m_time_block_capacity	= 200;
 		uint32_t m_time_block_count		= 0;
 		std::vector<TimeBlock> m_time_blocks_write;
@@ -47,6 +47,7 @@ namespace Spartan
 		m_rhi_device	    = rhi_device.get();
         m_cmd_list          = cmd_list;
         m_type              = type;
+        m_thread_id         = this_thread::get_id();
         m_max_tree_depth    = Math::Helper::Max(m_max_tree_depth, m_tree_depth);
 
 		if (type == TimeBlock_Cpu)
@@ -118,6 +119,7 @@ namespace Spartan
         m_max_tree_depth    = 0;
         m_type              = TimeBlock_Undefined;
         m_is_complete       = false;
+        m_thread_id         = thread::id();
 
         if (m_rhi_device && m_rhi_device->IsInitialized())
         {
@@ -39,19 +39,19 @@ namespace Spartan
         d3d11_utility::release(*reinterpret_cast<ID3D11VertexShader**>(&m_resource));
 	}
 
-	void* RHI_Shader::_Compile(const string& shader)
+	bool RHI_Shader::_CompileBytecode(const string& shader, vector<uint8_t>& bytecode)
 	{
 		if (!m_rhi_device)
 		{
 			LOG_ERROR_INVALID_INTERNALS();
-			return nullptr;
+			return false;
 		}
 
 		auto d3d11_device = m_rhi_device->GetContextRhi()->device;
 		if (!d3d11_device)
 		{
 			LOG_ERROR_INVALID_INTERNALS();
-			return nullptr;
+			return false;
 		}
 
 		// Compile flags
@@ -115,7 +115,7 @@ namespace Spartan
         else
         {
             LOG_ERROR("\"%s\" is not file or a source", shader.c_str());
-            return nullptr;
+            return false;
         }
 
 		// Log any compilation possible warnings and/or errors
@@ -153,40 +153,62 @@ namespace Spartan
 			}
 		}
 
+		if (!shader_blob)
+            return false;
+
+        const uint8_t* ptr = static_cast<const uint8_t*>(shader_blob->GetBufferPointer());
+        bytecode.assign(ptr, ptr + shader_blob->GetBufferSize());
+
+        d3d11_utility::release(shader_blob);
+		return true;
+	}
+
+	void* RHI_Shader::_CreateResource(const vector<uint8_t>& bytecode)
+	{
+		auto d3d11_device = m_rhi_device->GetContextRhi()->device;
+		if (!d3d11_device)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return nullptr;
+		}
+
 		// Create shader
 		void* shader_view = nullptr;
-		if (shader_blob)
+		if (m_shader_type == RHI_Shader_Vertex)
 		{
-			if (m_shader_type == RHI_Shader_Vertex)
+			if (FAILED(d3d11_device->CreateVertexShader(bytecode.data(), bytecode.size(), nullptr, reinterpret_cast<ID3D11VertexShader**>(&shader_view))))
 			{
-				if (FAILED(d3d11_device->CreateVertexShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11VertexShader**>(&shader_view))))
-				{
-                    LOG_ERROR("Failed to create vertex shader, %s", d3d11_utility::dxgi_error_to_string(result));
-				}
+                LOG_ERROR("Failed to create vertex shader");
+                return nullptr;
+			}
 
-				// Create input layout
+			// Create input layout (it expects a blob, which the cached bytecode isn't)
+            ID3DBlob* shader_blob = nullptr;
+            if (SUCCEEDED(D3DCreateBlob(bytecode.size(), &shader_blob)))
+            {
+                memcpy(shader_blob->GetBufferPointer(), bytecode.data(), bytecode.size());
                 if (!m_input_layout->Create(m_vertex_type, shader_blob))
                 {
                     LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(m_file_path).c_str());
                 }
-			}
-			else if (m_shader_type == RHI_Shader_Pixel)
+                d3d11_utility::release(shader_blob);
+            }
+		}
+		else if (m_shader_type == RHI_Shader_Pixel)
+		{
+			if (FAILED(d3d11_device->CreatePixelShader(bytecode.data(), bytecode.size(), nullptr, reinterpret_cast<ID3D11PixelShader**>(&shader_view))))
 			{
-				if (FAILED(d3d11_device->CreatePixelShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11PixelShader**>(&shader_view))))
-				{
-					LOG_ERROR("Failed to create pixel shader, %s", d3d11_utility::dxgi_error_to_string(result));
-				}
+				LOG_ERROR("Failed to create pixel shader");
 			}
-            else if (m_shader_type == RHI_Shader_Compute)
+		}
+        else if (m_shader_type == RHI_Shader_Compute)
+        {
+            if (FAILED(d3d11_device->CreateComputeShader(bytecode.data(), bytecode.size(), nullptr, reinterpret_cast<ID3D11ComputeShader**>(&shader_view))))
             {
-                if (FAILED(d3d11_device->CreateComputeShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11ComputeShader**>(&shader_view))))
-                {
-                    LOG_ERROR("Failed to create compute shader, %s", d3d11_utility::dxgi_error_to_string(result));
-                }
+                LOG_ERROR("Failed to create compute shader");
             }
-		}
+        }
 
-        d3d11_utility::release(shader_blob);
 		return shader_view;
 	}
 }
@@ -237,6 +237,12 @@ namespace Spartan
 
     RHI_Texture2D::~RHI_Texture2D()
     {
+        DestroyResourceGpu();
+    }
+
+    function<void()> RHI_Texture2D::DetachResourceGpu()
+    {
+        // The runtime keeps the objects alive for as long as the GPU uses them, so they can be released right away
         d3d11_utility::release(*reinterpret_cast<ID3D11ShaderResourceView**>(&m_resource_view[0]));
         d3d11_utility::release(*reinterpret_cast<ID3D11UnorderedAccessView**>(&m_resource_view_unorderedAccess));
         d3d11_utility::release(*reinterpret_cast<ID3D11Texture2D**>(&m_resource));
@@ -252,6 +258,8 @@ namespace Spartan
         {
             d3d11_utility::release(*reinterpret_cast<ID3D11DepthStencilView**>(&depth_stencil));
         }
+
+        return nullptr;
     }
 
     void RHI_Texture::SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* command_list /*= nullptr*/)
@@ -39,7 +39,12 @@ namespace Spartan
 		
 	}
 
-	void* RHI_Shader::_Compile(const string& shader)
+	bool RHI_Shader::_CompileBytecode(const string& shader, vector<uint8_t>& bytecode)
+	{
+        return false;
+	}
+
+	void* RHI_Shader::_CreateResource(const vector<uint8_t>& bytecode)
 	{
         return nullptr;
 	}
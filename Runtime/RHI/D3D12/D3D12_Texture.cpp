@@ -39,6 +39,11 @@ namespace Spartan
        
     }
 
+    function<void()> RHI_Texture2D::DetachResourceGpu()
+    {
+        return nullptr;
+    }
+
     void RHI_Texture::SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* command_list /*= nullptr*/)
     {
         
@@ -0,0 +1,969 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Spartan.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_CommandList.h"
+#include "../RHI_Pipeline.h"
+#include "../RHI_Device.h"
+#include "../RHI_Sampler.h"
+#include "../RHI_Texture.h"
+#include "../RHI_Shader.h"
+#include "../RHI_ConstantBuffer.h"
+#include "../RHI_VertexBuffer.h"
+#include "../RHI_IndexBuffer.h"
+#include "../RHI_SwapChain.h"
+#include "../RHI_PipelineState.h"
+#include "../RHI_PipelineCache.h"
+#include "../RHI_DescriptorCache.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Rendering/Renderer.h"
+#include <fstream>
+//===================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    namespace _Null_CommandList
+    {
+        static const char* command_names[] =
+        {
+            "render_pass_begin",
+            "render_pass_end",
+            "clear",
+            "draw",
+            "draw_indexed",
+            "dispatch",
+            "viewport",
+            "scissor",
+            "vertex_buffer",
+            "index_buffer",
+            "constant_buffer",
+            "sampler",
+            "texture",
+            "barrier"
+        };
+
+        static const char* layout_names[] =
+        {
+            "undefined",
+            "general",
+            "preinitialized",
+            "color_attachment",
+            "depth_stencil_attachment",
+            "depth_stencil_read_only",
+            "shader_read_only",
+            "transfer_dst",
+            "present_src"
+        };
+
+        inline const char* stage_name(const uint32_t stage)
+        {
+            return stage == RHI_Shader_Vertex ? "vertex" : stage == RHI_Shader_Pixel ? "pixel" : "compute";
+        }
+
+        inline const char* pass_name(const RHI_PipelineState* pipeline_state)
+        {
+            return (pipeline_state && pipeline_state->pass_name) ? pipeline_state->pass_name : "unnamed pass";
+        }
+
+        // Returns true if the pass writes to the texture, in which case it can't also sample it
+        inline bool is_written(const RHI_PipelineState* pipeline_state, const RHI_Texture* texture)
+        {
+            for (const RHI_Texture* render_target : pipeline_state->render_target_color_textures)
+            {
+                if (render_target == texture)
+                    return true;
+            }
+
+            if (pipeline_state->render_target_depth_texture == texture && !pipeline_state->render_target_depth_texture_read_only)
+                return true;
+
+            return pipeline_state->unordered_access_view == texture;
+        }
+
+        // Appends a command buffer to the trace file, one command per line, indented per render pass
+        void trace(const null_utility::command_buffer& cmd_buffer, const uint64_t frame, const string& file_path)
+        {
+            ofstream fout(file_path, ios::out | ios::app);
+            if (!fout.is_open())
+            {
+                LOG_ERROR("Failed to open \"%s\"", file_path.c_str());
+                return;
+            }
+
+            fout << "frame " << frame << ", command list " << cmd_buffer.index << ", " << cmd_buffer.commands.size() << " commands" << endl;
+
+            uint32_t depth = 1;
+            for (const null_utility::command& cmd : cmd_buffer.commands)
+            {
+                if (cmd.type == null_utility::command_type::render_pass_end && depth > 1)
+                {
+                    depth--;
+                }
+
+                fout << string(depth * 4, ' ') << command_names[static_cast<uint32_t>(cmd.type)];
+
+                if (cmd.label)
+                {
+                    fout << " \"" << cmd.label << "\"";
+                }
+
+                if (cmd.object)
+                {
+                    fout << " #" << cmd.object->GetId();
+
+                    if (!cmd.object->GetName().empty())
+                    {
+                        fout << " \"" << cmd.object->GetName() << "\"";
+                    }
+                }
+
+                const array<uint32_t, 4>& args = cmd.args;
+                switch (cmd.type)
+                {
+                    case null_utility::command_type::render_pass_begin: fout << " color_targets=" << args[0] << " depth_target=" << args[1];                                                       break;
+                    case null_utility::command_type::clear:             fout << " color_mask=" << args[0] << " depth=" << args[1] << " stencil=" << args[2];                                       break;
+                    case null_utility::command_type::draw:              fout << " vertices=" << args[0];                                                                                           break;
+                    case null_utility::command_type::draw_indexed:      fout << " indices=" << args[0] << " index_offset=" << args[1] << " vertex_offset=" << args[2] << " instances=" << args[3];  break;
+                    case null_utility::command_type::dispatch:          fout << " groups=" << args[0] << "x" << args[1] << "x" << args[2];                                                         break;
+                    case null_utility::command_type::viewport:          fout << " " << static_cast<int32_t>(args[0]) << "," << static_cast<int32_t>(args[1]) << " " << args[2] << "x" << args[3];  break;
+                    case null_utility::command_type::scissor:           fout << " " << static_cast<int32_t>(args[0]) << "," << static_cast<int32_t>(args[1]) << " -> " << static_cast<int32_t>(args[2]) << "," << static_cast<int32_t>(args[3]); break;
+                    case null_utility::command_type::vertex_buffer:     fout << " offset=" << args[0];                                                                                             break;
+                    case null_utility::command_type::index_buffer:      fout << " offset=" << args[0];                                                                                             break;
+                    case null_utility::command_type::constant_buffer:   fout << " slot=" << args[0] << " stage=" << stage_name(args[1]);                                                           break;
+                    case null_utility::command_type::sampler:           fout << " slot=" << args[0];                                                                                               break;
+                    case null_utility::command_type::texture:           fout << " slot=" << args[0] << " stage=" << stage_name(args[1]);                                                           break;
+                    case null_utility::command_type::barrier:           fout << " " << layout_names[args[0]] << " -> " << layout_names[args[1]];                                                   break;
+                    default:                                                                                                                                                                       break;
+                }
+
+                fout << endl;
+
+                if (cmd.type == null_utility::command_type::render_pass_begin)
+                {
+                    depth++;
+                }
+            }
+
+            fout.close();
+        }
+    }
+
+	RHI_CommandList::RHI_CommandList(uint32_t index, RHI_SwapChain* swap_chain, Context* context)
+	{
+        m_swap_chain        = swap_chain;
+        m_renderer          = context->GetSubsystem<Renderer>();
+        m_profiler          = context->GetSubsystem<Profiler>();
+        m_rhi_device        = m_renderer->GetRhiDevice().get();
+        m_pipeline_cache    = m_renderer->GetPipelineCache();
+        m_descriptor_cache  = m_renderer->GetDescriptorCache();
+        m_timestamps.fill(0);
+
+        // Command buffer
+        null_utility::command_buffer* cmd_buffer = new null_utility::command_buffer();
+        cmd_buffer->index   = index;
+        m_cmd_buffer        = static_cast<void*>(cmd_buffer);
+	}
+
+	RHI_CommandList::~RHI_CommandList()
+    {
+        delete static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        m_cmd_buffer = nullptr;
+    }
+
+    bool RHI_CommandList::Begin()
+    {
+        // Sync CPU to GPU
+        if (!Wait())
+        {
+            LOG_ERROR("Failed to wait");
+            return false;
+        }
+
+        if (m_cmd_state != RHI_Cmd_List_Idle)
+        {
+            LOG_ERROR("The command list is still being used");
+            return false;
+        }
+
+        // Bound state doesn't carry over from previous recordings
+        static_cast<null_utility::command_buffer*>(m_cmd_buffer)->reset();
+        m_vertex_buffer_id      = 0;
+        m_vertex_buffer_offset  = 0;
+        m_index_buffer_id       = 0;
+        m_index_buffer_offset   = 0;
+        m_render_pass_active    = false;
+
+        m_cmd_state = RHI_Cmd_List_Recording;
+        m_flushed   = false;
+        return true;
+    }
+
+    bool RHI_CommandList::Stop()
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            LOG_WARNING("The command list is not recording, no need to stop it");
+            return true;
+        }
+
+        if (m_render_pass_active)
+        {
+            NULL_VALIDATION_ERROR("Stopped recording while \"%s\" is still active", _Null_CommandList::pass_name(m_pipeline_state));
+        }
+
+        m_cmd_state = RHI_Cmd_List_Submittable;
+        return true;
+    }
+
+    bool RHI_CommandList::Submit()
+    {
+        // Ensure the command list has recorded
+        if (m_cmd_state == RHI_Cmd_List_Idle)
+        {
+            LOG_WARNING("The command list is idle, nothing to submit");
+            return false;
+        }
+
+        // Ensure the command list is not recording
+        if (m_cmd_state == RHI_Cmd_List_Recording)
+        {
+            if (!Stop())
+            {
+                LOG_ERROR("Failed to stop recording");
+                return false;
+            }
+        }
+
+        // Nothing gets executed, but the command stream can be traced
+        RHI_Context* rhi_context = m_rhi_device->GetContextRhi();
+        if (rhi_context->trace_frames != 0)
+        {
+            _Null_CommandList::trace(*static_cast<null_utility::command_buffer*>(m_cmd_buffer), m_renderer->GetFrameNum(), rhi_context->trace_file_path);
+        }
+
+        m_cmd_state = RHI_Cmd_List_Pending;
+        return true;
+    }
+
+    bool RHI_CommandList::Wait()
+    {
+        // There is no GPU, so submitted work is complete as soon as it's waited for
+        if (m_cmd_state == RHI_Cmd_List_Pending)
+        {
+            m_cmd_state = RHI_Cmd_List_Idle;
+        }
+
+        return true;
+    }
+
+    bool RHI_CommandList::Reset()
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+            return true;
+
+        lock_guard<mutex> guard(m_mutex_reset);
+
+        static_cast<null_utility::command_buffer*>(m_cmd_buffer)->reset();
+        m_render_pass_active = false;
+
+        m_cmd_state = RHI_Cmd_List_Idle;
+        return true;
+    }
+
+    bool RHI_CommandList::BeginRenderPass(RHI_PipelineState& pipeline_state)
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't begin \"%s\", the command list is not recording", _Null_CommandList::pass_name(&pipeline_state));
+            return false;
+        }
+
+        if (!pipeline_state.IsValid())
+        {
+            LOG_ERROR("Invalid pipeline state");
+            return false;
+        }
+
+        if (m_render_pass_active)
+        {
+            NULL_VALIDATION_ERROR("Can't begin \"%s\", \"%s\" is still active", _Null_CommandList::pass_name(&pipeline_state), _Null_CommandList::pass_name(m_pipeline_state));
+            return false;
+        }
+
+        // Get a pipeline which matches the pipeline state, this also transitions the render targets to their attachment layouts
+        m_pipeline = m_pipeline_cache->GetPipeline(this, pipeline_state, nullptr);
+        if (!m_pipeline)
+        {
+            LOG_ERROR("Failed to acquire appropriate pipeline");
+            return false;
+        }
+
+        // Keep a local pointer for convenience
+        m_pipeline_state        = &pipeline_state;
+        m_render_pass_active    = true;
+
+        // Start marker and profiler (if enabled)
+        Timeblock_Start(m_pipeline_state);
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        cmd_buffer->render_pass_drawn = false;
+
+        // Shaders
+        {
+            if (cmd_buffer->shader_vertex != pipeline_state.shader_vertex)
+            {
+                cmd_buffer->shader_vertex = pipeline_state.shader_vertex;
+                m_profiler->m_rhi_bindings_shader_vertex++;
+            }
+
+            if (cmd_buffer->shader_pixel != pipeline_state.shader_pixel)
+            {
+                cmd_buffer->shader_pixel = pipeline_state.shader_pixel;
+                m_profiler->m_rhi_bindings_shader_pixel++;
+            }
+
+            if (cmd_buffer->shader_compute != pipeline_state.shader_compute)
+            {
+                cmd_buffer->shader_compute = pipeline_state.shader_compute;
+                m_profiler->m_rhi_bindings_shader_compute++;
+            }
+        }
+
+        // Render target(s)
+        uint32_t render_target_color_count = 0;
+        {
+            array<const void*, state_max_render_target_count + 1> render_targets = {}; // +1 for depth-stencil
+
+            // Swapchain
+            if (pipeline_state.render_target_swapchain)
+            {
+                render_targets[0] = pipeline_state.render_target_swapchain->Get_Resource_View_RenderTarget();
+            }
+            // Textures
+            else
+            {
+                for (uint32_t i = 0; i < state_max_render_target_count; i++)
+                {
+                    if (RHI_Texture* texture = pipeline_state.render_target_color_textures[i])
+                    {
+                        render_targets[i] = texture->Get_Resource_View_RenderTarget(pipeline_state.render_target_color_texture_array_index);
+
+                        if (!render_targets[i])
+                        {
+                            NULL_VALIDATION_ERROR("\"%s\" renders to \"%s\", which has no render target view", _Null_CommandList::pass_name(&pipeline_state), texture->GetName().c_str());
+                        }
+                    }
+                }
+            }
+
+            // Depth-stencil
+            if (RHI_Texture* texture = pipeline_state.render_target_depth_texture)
+            {
+                const uint32_t array_index = pipeline_state.render_target_depth_stencil_texture_array_index;
+                const void*& depth_stencil = render_targets[state_max_render_target_count];
+                depth_stencil = pipeline_state.render_target_depth_texture_read_only ? texture->Get_Resource_View_DepthStencilReadOnly(array_index) : texture->Get_Resource_View_DepthStencil(array_index);
+
+                if (!depth_stencil)
+                {
+                    NULL_VALIDATION_ERROR("\"%s\" renders to \"%s\", which has no matching depth-stencil view", _Null_CommandList::pass_name(&pipeline_state), texture->GetName().c_str());
+                }
+            }
+
+            for (uint32_t i = 0; i < state_max_render_target_count; i++)
+            {
+                render_target_color_count += render_targets[i] ? 1 : 0;
+            }
+
+            // Set if dirty
+            if (cmd_buffer->render_targets != render_targets)
+            {
+                cmd_buffer->render_targets = render_targets;
+                m_profiler->m_rhi_bindings_render_target++;
+            }
+        }
+
+        // Unordered access view(s)
+        if (RHI_Texture* texture = pipeline_state.unordered_access_view)
+        {
+            if (!texture->Get_Resource_View_UnorderedAccess())
+            {
+                NULL_VALIDATION_ERROR("\"%s\" writes to \"%s\", which has no unordered access view", _Null_CommandList::pass_name(&pipeline_state), texture->GetName().c_str());
+            }
+
+            m_profiler->m_rhi_bindings_render_target++;
+        }
+
+        null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::render_pass_begin, nullptr, _Null_CommandList::pass_name(&pipeline_state));
+        cmd.args = { render_target_color_count, pipeline_state.render_target_depth_texture ? 1u : 0u, 0, 0 };
+
+        // Viewport
+        if (pipeline_state.viewport.IsDefined())
+        {
+            SetViewport(pipeline_state.viewport);
+        }
+
+        // Clear render target(s)
+        Clear(pipeline_state);
+
+        m_renderer->SetGlobalSamplersAndConstantBuffers(this);
+
+        m_profiler->m_rhi_bindings_pipeline++;
+
+        return true;
+	}
+
+	bool RHI_CommandList::EndRenderPass()
+	{
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't end a render pass, the command list is not recording");
+            return false;
+        }
+
+        if (!m_render_pass_active)
+        {
+            NULL_VALIDATION_ERROR("There is no active render pass to end");
+            return false;
+        }
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        cmd_buffer->record(null_utility::command_type::render_pass_end, nullptr, _Null_CommandList::pass_name(m_pipeline_state));
+        cmd_buffer->render_pass_drawn   = false;
+        m_render_pass_active            = false;
+
+        // End marker and profiler (if enabled)
+        Timeblock_End(m_pipeline_state);
+        return true;
+	}
+
+    void RHI_CommandList::Clear(RHI_PipelineState& pipeline_state)
+    {
+        if (!m_render_pass_active)
+        {
+            NULL_VALIDATION_ERROR("Can't clear \"%s\" outside of its render pass", _Null_CommandList::pass_name(&pipeline_state));
+            return;
+        }
+
+        // Color
+        uint32_t color_mask = 0;
+        for (uint8_t i = 0; i < state_max_render_target_count; i++)
+        {
+            if (pipeline_state.clear_color[i] != state_color_load && pipeline_state.clear_color[i] != state_color_dont_care)
+            {
+                if ((pipeline_state.render_target_swapchain && i == 0) || pipeline_state.render_target_color_textures[i])
+                {
+                    color_mask |= 1 << i;
+                }
+            }
+        }
+
+        // Depth-stencil
+        bool clear_depth    = false;
+        bool clear_stencil  = false;
+        if (pipeline_state.render_target_depth_texture)
+        {
+            clear_depth     = pipeline_state.clear_depth    != state_depth_load     && pipeline_state.clear_depth   != state_depth_dont_care;
+            clear_stencil   = pipeline_state.clear_stencil  != state_stencil_load   && pipeline_state.clear_stencil != state_stencil_dont_care;
+
+            if ((clear_depth || clear_stencil) && pipeline_state.render_target_depth_texture_read_only)
+            {
+                NULL_VALIDATION_ERROR("\"%s\" clears \"%s\", which is bound as read only", _Null_CommandList::pass_name(&pipeline_state), pipeline_state.render_target_depth_texture->GetName().c_str());
+            }
+        }
+
+        if (color_mask != 0 || clear_depth || clear_stencil)
+        {
+            null_utility::command& cmd = static_cast<null_utility::command_buffer*>(m_cmd_buffer)->record(null_utility::command_type::clear);
+            cmd.args = { color_mask, clear_depth ? 1u : 0u, clear_stencil ? 1u : 0u, 0 };
+        }
+    }
+
+    bool RHI_CommandList::Draw(const uint32_t vertex_count)
+    {
+        // Ensure correct state before attempting to draw
+        if (!OnDraw())
+            return false;
+
+        if (vertex_count == 0)
+        {
+            NULL_VALIDATION_ERROR("\"%s\" draws zero vertices", _Null_CommandList::pass_name(m_pipeline_state));
+            return false;
+        }
+
+        null_utility::command& cmd = static_cast<null_utility::command_buffer*>(m_cmd_buffer)->record(null_utility::command_type::draw);
+        cmd.args = { vertex_count, 0, 0, 0 };
+
+        m_profiler->m_rhi_draw_calls++;
+
+        return true;
+	}
+
+    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count /*= 1*/)
+    {
+        // Ensure correct state before attempting to draw
+        if (!OnDraw())
+            return false;
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        const RHI_IndexBuffer* index_buffer = cmd_buffer->index_buffer;
+
+        if (!cmd_buffer->vertex_buffer || !index_buffer)
+        {
+            NULL_VALIDATION_ERROR("\"%s\" draws indexed without a vertex and an index buffer bound", _Null_CommandList::pass_name(m_pipeline_state));
+            return false;
+        }
+
+        if (index_count == 0 || instance_count == 0)
+        {
+            NULL_VALIDATION_ERROR("\"%s\" draws %d indices and %d instances", _Null_CommandList::pass_name(m_pipeline_state), index_count, instance_count);
+            return false;
+        }
+
+        // The index range has to be within the bound index buffer (the bind offset is in bytes)
+        const uint64_t index_first  = m_index_buffer_offset / (index_buffer->Is16Bit() ? sizeof(uint16_t) : sizeof(uint32_t)) + index_offset;
+        const uint64_t index_last   = index_first + index_count;
+        if (index_last > index_buffer->GetIndexCount())
+        {
+            NULL_VALIDATION_ERROR("\"%s\" draws indices %llu to %llu, but \"%s\" has %d", _Null_CommandList::pass_name(m_pipeline_state), static_cast<unsigned long long>(index_first), static_cast<unsigned long long>(index_last), index_buffer->GetName().c_str(), index_buffer->GetIndexCount());
+            return false;
+        }
+
+        null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::draw_indexed);
+        cmd.args = { index_count, index_offset, vertex_offset, instance_count };
+
+        m_profiler->m_rhi_draw_calls++;
+
+        return true;
+	}
+
+    void RHI_CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z /*= 1*/) const
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+        if (!m_render_pass_active || !m_pipeline_state->shader_compute)
+        {
+            NULL_VALIDATION_ERROR("Can't dispatch without a compute shader");
+            return;
+        }
+
+        if (x == 0 || y == 0 || z == 0)
+        {
+            NULL_VALIDATION_ERROR("\"%s\" dispatches %dx%dx%d thread groups", _Null_CommandList::pass_name(m_pipeline_state), x, y, z);
+            return;
+        }
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        cmd_buffer->render_pass_drawn = true;
+
+        null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::dispatch);
+        cmd.args = { x, y, z, 0 };
+    }
+
+	void RHI_CommandList::SetViewport(const RHI_Viewport& viewport) const
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+        if (viewport.width <= 0.0f || viewport.height <= 0.0f || viewport.depth_min > viewport.depth_max)
+        {
+            NULL_VALIDATION_ERROR("Invalid viewport (%.0fx%.0f, depth %.2f to %.2f)", viewport.width, viewport.height, viewport.depth_min, viewport.depth_max);
+            return;
+        }
+
+        null_utility::command& cmd = static_cast<null_utility::command_buffer*>(m_cmd_buffer)->record(null_utility::command_type::viewport);
+        cmd.args =
+        {
+            static_cast<uint32_t>(static_cast<int32_t>(viewport.x)),
+            static_cast<uint32_t>(static_cast<int32_t>(viewport.y)),
+            static_cast<uint32_t>(viewport.width),
+            static_cast<uint32_t>(viewport.height)
+        };
+	}
+
+	void RHI_CommandList::SetScissorRectangle(const Math::Rectangle& scissor_rectangle) const
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+        if (scissor_rectangle.right < scissor_rectangle.left || scissor_rectangle.bottom < scissor_rectangle.top)
+        {
+            NULL_VALIDATION_ERROR("Invalid scissor rectangle");
+            return;
+        }
+
+        null_utility::command& cmd = static_cast<null_utility::command_buffer*>(m_cmd_buffer)->record(null_utility::command_type::scissor);
+        cmd.args =
+        {
+            static_cast<uint32_t>(static_cast<int32_t>(scissor_rectangle.left)),
+            static_cast<uint32_t>(static_cast<int32_t>(scissor_rectangle.top)),
+            static_cast<uint32_t>(static_cast<int32_t>(scissor_rectangle.right)),
+            static_cast<uint32_t>(static_cast<int32_t>(scissor_rectangle.bottom))
+        };
+	}
+
+	void RHI_CommandList::SetBufferVertex(const RHI_VertexBuffer* buffer, const uint64_t offset /*= 0*/)
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+		if (!buffer || !buffer->GetResource())
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        cmd_buffer->vertex_buffer = buffer;
+
+        // Skip if already set
+        if (m_vertex_buffer_id == buffer->GetId() && m_vertex_buffer_offset == offset)
+            return;
+
+        null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::vertex_buffer, buffer);
+        cmd.args = { static_cast<uint32_t>(offset), 0, 0, 0 };
+
+        m_profiler->m_rhi_bindings_buffer_vertex++;
+
+        m_vertex_buffer_id      = buffer->GetId();
+        m_vertex_buffer_offset  = offset;
+	}
+
+	void RHI_CommandList::SetBufferIndex(const RHI_IndexBuffer* buffer, const uint64_t offset /*= 0*/)
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+		if (!buffer || !buffer->GetResource())
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        cmd_buffer->index_buffer = buffer;
+
+        // Skip if already set
+        if (m_index_buffer_id == buffer->GetId() && m_index_buffer_offset == offset)
+            return;
+
+        null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::index_buffer, buffer);
+        cmd.args = { static_cast<uint32_t>(offset), 0, 0, 0 };
+
+        m_profiler->m_rhi_bindings_buffer_index++;
+
+        m_index_buffer_id       = buffer->GetId();
+        m_index_buffer_offset   = offset;
+	}
+
+    bool RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return false;
+        }
+
+        if (slot >= null_utility::slot_count_constant_buffer)
+        {
+            NULL_VALIDATION_ERROR("Constant buffer slot %d is out of range (%d slots)", slot, null_utility::slot_count_constant_buffer);
+            return false;
+        }
+
+        null_utility::command_buffer* cmd_buffer    = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        const void* resource                        = constant_buffer ? constant_buffer->GetResource() : nullptr;
+
+        for (const RHI_Shader_Type stage : { RHI_Shader_Vertex, RHI_Shader_Pixel, RHI_Shader_Compute })
+        {
+            if (!(scope & stage))
+                continue;
+
+            // Set only if not set
+            const void*& resource_set = cmd_buffer->constant_buffers[null_utility::stage_index(stage)][slot];
+            if (resource_set == resource)
+                continue;
+
+            resource_set = resource;
+
+            null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::constant_buffer, constant_buffer);
+            cmd.args = { slot, static_cast<uint32_t>(stage), 0, 0 };
+
+            m_profiler->m_rhi_bindings_buffer_constant++;
+        }
+
+        return true;
+    }
+
+    void RHI_CommandList::SetSampler(const uint32_t slot, RHI_Sampler* sampler) const
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+        if (slot >= null_utility::slot_count_sampler)
+        {
+            NULL_VALIDATION_ERROR("Sampler slot %d is out of range (%d slots)", slot, null_utility::slot_count_sampler);
+            return;
+        }
+
+        null_utility::command_buffer* cmd_buffer    = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+        const void* resource                        = sampler ? sampler->GetResource() : nullptr;
+
+        // Skip if already set
+        const void*& resource_set = cmd_buffer->samplers[slot];
+        if (resource_set == resource)
+            return;
+
+        resource_set = resource;
+
+        null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::sampler, sampler);
+        cmd.args = { slot, 0, 0, 0 };
+
+        m_profiler->m_rhi_bindings_sampler++;
+    }
+
+    void RHI_CommandList::SetTexture(const uint32_t slot, RHI_Texture* texture, const uint8_t scope /*= RHI_Shader_Pixel*/)
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return;
+        }
+
+        if (slot >= null_utility::slot_count_texture)
+        {
+            NULL_VALIDATION_ERROR("Texture slot %d is out of range (%d slots)", slot, null_utility::slot_count_texture);
+            return;
+        }
+
+        // Null textures are allowed, and get replaced with a black texture here
+        if (!texture || !texture->Get_Resource_View())
+        {
+            texture = m_renderer->GetBlackTexture();
+        }
+
+        null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(m_cmd_buffer);
+
+        if (m_render_pass_active)
+        {
+            // A texture can't be sampled by the pass which writes to it
+            if (_Null_CommandList::is_written(m_pipeline_state, texture))
+            {
+                NULL_VALIDATION_ERROR("\"%s\" samples \"%s\", which it also writes to", _Null_CommandList::pass_name(m_pipeline_state), texture->GetName().c_str());
+                return;
+            }
+
+            // The pass needs a shader for every stage the texture is bound to
+            const bool has_stage =
+                ((scope & RHI_Shader_Vertex)    && m_pipeline_state->shader_vertex)  ||
+                ((scope & RHI_Shader_Pixel)     && m_pipeline_state->shader_pixel)   ||
+                ((scope & RHI_Shader_Compute)   && m_pipeline_state->shader_compute);
+
+            if (!has_stage)
+            {
+                NULL_VALIDATION_ERROR("\"%s\" binds \"%s\" to a stage it has no shader for", _Null_CommandList::pass_name(m_pipeline_state), texture->GetName().c_str());
+            }
+        }
+
+        // Transition to a read only layout (if needed)
+        {
+            const RHI_Image_Layout target_layout = texture->IsDepthFormat() ? RHI_Image_Depth_Stencil_Read_Only_Optimal : RHI_Image_Shader_Read_Only_Optimal;
+            if (texture->GetLayout() != target_layout)
+            {
+                // Once a render pass has started drawing, transitions are no longer possible (Vulkan would skip them)
+                if (cmd_buffer->render_pass_drawn)
+                {
+                    NULL_VALIDATION_ERROR("\"%s\" needs a layout transition while \"%s\" is drawing", texture->GetName().c_str(), _Null_CommandList::pass_name(m_pipeline_state));
+                }
+
+                texture->SetLayout(target_layout, this);
+            }
+        }
+
+        const void* resource = texture->Get_Resource_View();
+        for (const RHI_Shader_Type stage : { RHI_Shader_Vertex, RHI_Shader_Pixel, RHI_Shader_Compute })
+        {
+            if (!(scope & stage))
+                continue;
+
+            // Set only if not set
+            const void*& resource_set = cmd_buffer->textures[null_utility::stage_index(stage)][slot];
+            if (resource_set == resource)
+                continue;
+
+            resource_set = resource;
+
+            null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::texture, texture);
+            cmd.args = { slot, static_cast<uint32_t>(stage), 0, 0 };
+
+            m_profiler->m_rhi_bindings_texture++;
+        }
+	}
+
+    bool RHI_CommandList::Timestamp_Start(void* query_disjoint /*= nullptr*/, void* query_start /*= nullptr*/)
+    {
+        return true;
+    }
+
+    bool RHI_CommandList::Timestamp_End(void* query_disjoint /*= nullptr*/, void* query_end /*= nullptr*/)
+    {
+        return true;
+    }
+
+    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index)
+    {
+        return 0.0f;
+    }
+
+    uint32_t RHI_CommandList::Gpu_GetMemory(RHI_Device* rhi_device)
+    {
+        return 0;
+    }
+
+    uint32_t RHI_CommandList::Gpu_GetMemoryUsed(RHI_Device* rhi_device)
+    {
+        return 0;
+    }
+
+    bool RHI_CommandList::Gpu_QueryCreate(RHI_Device* rhi_device, void** query, const RHI_Query_Type type)
+    {
+        return true;
+    }
+
+    void RHI_CommandList::Gpu_QueryRelease(void*& query_object)
+    {
+
+    }
+
+    bool RHI_CommandList::IsRecording() const
+    {
+        return m_cmd_state == RHI_Cmd_List_Recording;
+    }
+
+    bool RHI_CommandList::IsPending() const
+    {
+        return m_cmd_state == RHI_Cmd_List_Pending;
+    }
+
+    bool RHI_CommandList::IsIdle() const
+    {
+        return m_cmd_state == RHI_Cmd_List_Idle;
+    }
+
+    void RHI_CommandList::Timeblock_Start(const RHI_PipelineState* pipeline_state)
+    {
+        if (!pipeline_state || !pipeline_state->pass_name)
+            return;
+
+        // Allowed to profile ?
+        RHI_Context* rhi_context = m_rhi_device->GetContextRhi();
+        if (rhi_context->profiler && pipeline_state->profile)
+        {
+            if (m_profiler)
+            {
+                m_profiler->TimeBlockStart(pipeline_state->pass_name, TimeBlock_Cpu, this);
+                m_profiler->TimeBlockStart(pipeline_state->pass_name, TimeBlock_Gpu, this);
+            }
+        }
+    }
+
+    void RHI_CommandList::Timeblock_End(const RHI_PipelineState* pipeline_state)
+    {
+        if (!pipeline_state)
+            return;
+
+        // Allowed to profile ?
+        RHI_Context* rhi_context = m_rhi_device->GetContextRhi();
+        if (rhi_context->profiler && pipeline_state->profile)
+        {
+            if (m_profiler)
+            {
+                m_profiler->TimeBlockEnd(); // cpu
+                m_profiler->TimeBlockEnd(); // gpu
+            }
+        }
+    }
+
+    bool RHI_CommandList::Deferred_BeginRenderPass()
+    {
+        return true;
+    }
+
+    bool RHI_CommandList::Deferred_BindPipeline()
+    {
+        return true;
+    }
+
+    bool RHI_CommandList::Deferred_BindDescriptorSet()
+    {
+        return true;
+    }
+
+    bool RHI_CommandList::OnDraw()
+    {
+        if (m_cmd_state != RHI_Cmd_List_Recording)
+        {
+            NULL_VALIDATION_ERROR("Can't record command, the command list is not recording");
+            return false;
+        }
+
+        if (!m_render_pass_active)
+        {
+            NULL_VALIDATION_ERROR("Can't draw outside of a render pass");
+            return false;
+        }
+
+        if (!m_pipeline_state->shader_vertex)
+        {
+            NULL_VALIDATION_ERROR("\"%s\" draws without a vertex shader", _Null_CommandList::pass_name(m_pipeline_state));
+            return false;
+        }
+
+        // From here on, the attachments are in use and can't change layout
+        static_cast<null_utility::command_buffer*>(m_cmd_buffer)->render_pass_drawn = true;
+
+        return true;
+    }
+}
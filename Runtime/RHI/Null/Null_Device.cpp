@@ -0,0 +1,72 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "Spartan.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+//=================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+	RHI_Device::RHI_Device(Context* context)
+	{
+        m_context                           = context;
+        m_rhi_context                       = make_shared<RHI_Context>();
+        null_utility::globals::rhi_context  = m_rhi_context.get();
+        null_utility::globals::rhi_device   = this;
+
+        // A single device which records and validates commands, nothing is executed and there is no video memory
+        RegisterPhysicalDevice(PhysicalDevice(0, 0, 0, RHI_PhysicalDevice_Cpu, "Null", 0, nullptr));
+        SetPrimaryPhysicalDevice(0);
+
+        // Display modes are not registered, there is no display and the frame rate should not be locked to one
+
+        LOG_INFO("Null RHI, command streams are recorded and validated but not executed");
+
+        m_initialized = true;
+	}
+
+	RHI_Device::~RHI_Device()
+	{
+        // Report the command stream violations of the session
+        const uint32_t validation_errors = m_rhi_context->validation_errors;
+        if (validation_errors != 0)
+        {
+            LOG_WARNING("%d command stream violation(s) were detected", validation_errors);
+        }
+	}
+
+    bool RHI_Device::Queue_Submit(const RHI_Queue_Type type, void* cmd_buffer, void* wait_semaphore /*= nullptr*/, void* signal_semaphore /*= nullptr*/, void* wait_fence /*= nullptr*/, uint32_t wait_flags /*= 0*/) const
+    {
+        return true;
+    }
+
+    bool RHI_Device::Queue_Wait(const RHI_Queue_Type type) const
+    {
+        return true;
+    }
+}
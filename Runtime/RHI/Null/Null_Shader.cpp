@@ -0,0 +1,105 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "Spartan.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+#include "../RHI_Shader.h"
+#include "../RHI_InputLayout.h"
+#include <fstream>
+#include <sstream>
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+	RHI_Shader::~RHI_Shader()
+	{
+        m_resource = nullptr;
+	}
+
+	bool RHI_Shader::_CompileBytecode(const string& shader, vector<uint8_t>& bytecode)
+	{
+		if (!m_rhi_device)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return false;
+		}
+
+        // There is no compiler, but the source can still be loaded and checked for the entry point
+        string source;
+		if (FileSystem::IsFile(shader)) // From file ?
+		{
+            ifstream fin(shader, ios::in);
+            if (!fin.is_open())
+            {
+                LOG_ERROR("Failed to open \"%s\"", shader.c_str());
+                return false;
+            }
+
+            stringstream buffer;
+            buffer << fin.rdbuf();
+            source = buffer.str();
+		}
+		else if (shader.find("return") != string::npos) // From source ?
+		{
+            source = shader;
+        }
+        else
+        {
+            LOG_ERROR("\"%s\" is not file or a source", shader.c_str());
+            return false;
+        }
+
+        if (source.find(GetEntryPoint()) == string::npos)
+        {
+            LOG_ERROR("Failed to find entry point \"%s\" in \"%s\"", GetEntryPoint(), m_name.c_str());
+            return false;
+        }
+
+        // The source stands in for the bytecode
+        bytecode.assign(source.begin(), source.end());
+
+		return true;
+	}
+
+	void* RHI_Shader::_CreateResource(const vector<uint8_t>& bytecode)
+	{
+        if (bytecode.empty())
+            return nullptr;
+
+        // Create input layout
+        if (m_shader_type == RHI_Shader_Vertex)
+        {
+            if (!m_input_layout->Create(m_vertex_type, const_cast<uint8_t*>(bytecode.data())))
+            {
+                LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(m_file_path).c_str());
+                return nullptr;
+            }
+        }
+
+		return null_utility::handle(m_resource);
+	}
+}
@@ -0,0 +1,189 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Spartan.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_SwapChain.h"
+#include "../RHI_Device.h"
+#include "../RHI_CommandList.h"
+#include "../../Rendering/Renderer.h"
+#include "../../Profiling/Profiler.h"
+//===================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace Spartan
+{
+	RHI_SwapChain::RHI_SwapChain(
+		void* window_handle,
+        const shared_ptr<RHI_Device>& rhi_device,
+		const uint32_t width,
+		const uint32_t height,
+		const RHI_Format format	    /*= Format_R8G8B8A8_UNORM*/,	
+		const uint32_t buffer_count	/*= 2 */,
+        const uint32_t flags	    /*= Present_Immediate */
+	)
+	{
+        // Validate device
+        if (!rhi_device || !rhi_device->IsInitialized())
+        {
+            LOG_ERROR("Invalid device.");
+            return;
+        }
+
+        // Validate resolution
+        if (!rhi_device->ValidateResolution(width, height))
+        {
+            LOG_WARNING("%dx%d is an invalid resolution", width, height);
+            return;
+        }
+
+        // Validate buffer count
+        if (buffer_count == 0 || buffer_count > state_max_render_target_count)
+        {
+            LOG_ERROR("%d is an invalid buffer count", buffer_count);
+            return;
+        }
+
+		// Save parameters (there is nothing to present to, so the window handle is allowed to be null)
+		m_format		= format;
+        m_rhi_device    = rhi_device.get();
+		m_buffer_count	= buffer_count;
+		m_windowed		= true;
+		m_width			= width;
+		m_height		= height;
+        m_flags         = flags;
+        m_window_handle = window_handle;
+
+        // Back buffers
+        m_swap_chain_view               = null_utility::handle(m_swap_chain_view);
+        m_resource_view_renderTarget    = null_utility::handle(m_resource_view_renderTarget);
+        for (uint32_t i = 0; i < m_buffer_count; i++)
+        {
+            m_resource[i]       = null_utility::handle(m_resource[i]);
+            m_resource_view[i]  = null_utility::handle(m_resource_view[i]);
+        }
+
+        // Create command lists
+        for (uint32_t i = 0; i < m_buffer_count; i++)
+        {
+            m_cmd_lists.emplace_back(make_shared<RHI_CommandList>(i, this, rhi_device->GetContext()));
+        }
+
+        m_initialized = AcquireNextImage();
+	}
+
+	RHI_SwapChain::~RHI_SwapChain()
+	{
+        m_cmd_lists.clear();
+	}
+
+	bool RHI_SwapChain::Resize(const uint32_t width, const uint32_t height, const bool force /*= false*/)
+	{	
+		if (!m_swap_chain_view)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return false;
+		}
+
+        // Validate resolution
+        m_present = m_rhi_device->ValidateResolution(width, height);
+        if (!m_present)
+        {
+            // Return true as when minimizing, a resolution
+            // of 0,0 can be passed in, and this is fine.
+            return true;
+        }
+
+        // Only resize if needed
+        if (!force)
+        {
+            if (m_width == width && m_height == height)
+                return true;
+        }
+
+        m_width     = width;
+        m_height    = height;
+
+		return true;
+	}
+
+    bool RHI_SwapChain::AcquireNextImage()
+    {
+        if (!m_present)
+            return true;
+
+        // Cycle through the command lists, the same way the Vulkan swapchain cycles through its images
+        const bool first_run    = !m_image_acquired;
+        m_image_index           = first_run ? 0 : (m_image_index + 1) % m_buffer_count;
+        m_cmd_index             = m_image_index;
+        m_image_acquired        = true;
+
+        return true;
+    }
+
+	bool RHI_SwapChain::Present()
+    {
+        if (!m_present)
+            return true;
+
+        if (!m_image_acquired)
+        {
+            LOG_ERROR("Image has not been acquired");
+            return false;
+        }
+
+        // Count down the frames which have to be traced
+        RHI_Context* rhi_context = m_rhi_device->GetContextRhi();
+        if (rhi_context->trace_frames != 0)
+        {
+            rhi_context->trace_frames--;
+
+            if (rhi_context->trace_frames == 0)
+            {
+                LOG_INFO("Frame trace written to \"%s\"", rhi_context->trace_file_path.c_str());
+            }
+        }
+
+        return AcquireNextImage();
+	}
+
+    void RHI_SwapChain::SetLayout(RHI_Image_Layout layout, RHI_CommandList* command_list /*= nullptr*/)
+    {
+        if (m_layout == layout)
+            return;
+
+        if (command_list)
+        {
+            null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(command_list->GetResource_CommandBuffer());
+            null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::barrier, this);
+            cmd.args = { static_cast<uint32_t>(m_layout), static_cast<uint32_t>(layout), 0, 0 };
+
+            m_rhi_device->GetContext()->GetSubsystem<Profiler>()->m_rhi_pipeline_barriers++;
+        }
+
+        m_layout = layout;
+    }
+}
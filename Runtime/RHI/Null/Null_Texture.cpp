@@ -0,0 +1,181 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================
+#include "Spartan.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Texture2D.h"
+#include "../RHI_TextureCube.h"
+#include "../RHI_CommandList.h"
+#include "../../Profiling/Profiler.h"
+//====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    // Same as the layout Vulkan transitions a freshly created image to
+    inline RHI_Image_Layout get_initial_layout(const RHI_Texture* texture)
+    {
+        RHI_Image_Layout layout = RHI_Image_Preinitialized;
+
+        if (texture->IsSampled() && texture->IsColorFormat())
+            layout = RHI_Image_Shader_Read_Only_Optimal;
+
+        if (texture->IsRenderTargetColor())
+            layout = RHI_Image_Color_Attachment_Optimal;
+
+        if (texture->IsRenderTargetDepthStencil())
+            layout = RHI_Image_Depth_Stencil_Attachment_Optimal;
+
+        return layout;
+    }
+
+    RHI_Texture2D::~RHI_Texture2D()
+    {
+        DestroyResourceGpu();
+    }
+
+    function<void()> RHI_Texture2D::DetachResourceGpu()
+    {
+        m_resource                      = nullptr;
+        m_resource_view[0]              = nullptr;
+        m_resource_view[1]              = nullptr;
+        m_resource_view_unorderedAccess = nullptr;
+        m_resource_view_renderTarget.fill(nullptr);
+        m_resource_view_depthStencil.fill(nullptr);
+        m_resource_view_depthStencilReadOnly.fill(nullptr);
+
+        return nullptr;
+    }
+
+    void RHI_Texture::SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* command_list /*= nullptr*/)
+    {
+        // The texture is most likely still initialising
+        if (m_layout == RHI_Image_Undefined)
+            return;
+
+        if (m_layout == new_layout)
+            return;
+
+        // If a command list is provided, this means we should insert a pipeline barrier
+        if (command_list)
+        {
+            null_utility::command_buffer* cmd_buffer = static_cast<null_utility::command_buffer*>(command_list->GetResource_CommandBuffer());
+            null_utility::command& cmd = cmd_buffer->record(null_utility::command_type::barrier, this);
+            cmd.args = { static_cast<uint32_t>(m_layout), static_cast<uint32_t>(new_layout), 0, 0 };
+
+            m_context->GetSubsystem<Profiler>()->m_rhi_pipeline_barriers++;
+        }
+
+        m_layout = new_layout;
+    }
+
+	bool RHI_Texture2D::CreateResourceGpu()
+	{
+        // There is no image, only handles for the views which the flags ask for
+        m_resource = null_utility::handle(m_resource);
+
+        if (IsSampled())
+        {
+            m_resource_view[0] = null_utility::handle(m_resource_view[0]);
+
+            if (IsStencilFormat())
+            {
+                m_resource_view[1] = null_utility::handle(m_resource_view[1]);
+            }
+        }
+
+        if (IsRenderTargetCompute())
+        {
+            m_resource_view_unorderedAccess = null_utility::handle(m_resource_view_unorderedAccess);
+        }
+
+        for (uint32_t i = 0; i < m_array_size && i < state_max_render_target_count; i++)
+        {
+            if (IsRenderTargetColor())
+            {
+                m_resource_view_renderTarget[i] = null_utility::handle(m_resource_view_renderTarget[i]);
+            }
+
+            if (IsRenderTargetDepthStencil())
+            {
+                m_resource_view_depthStencil[i] = null_utility::handle(m_resource_view_depthStencil[i]);
+
+                if (m_flags & RHI_Texture_DepthStencilViewReadOnly)
+                {
+                    m_resource_view_depthStencilReadOnly[i] = null_utility::handle(m_resource_view_depthStencilReadOnly[i]);
+                }
+            }
+        }
+
+        m_layout = get_initial_layout(this);
+
+        return true;
+	}
+
+	// TEXTURE CUBE
+
+    RHI_TextureCube::~RHI_TextureCube()
+    {
+        m_resource = nullptr;
+    }
+
+	bool RHI_TextureCube::CreateResourceGpu()
+	{
+        m_resource = null_utility::handle(m_resource);
+
+        if (IsSampled())
+        {
+            m_resource_view[0] = null_utility::handle(m_resource_view[0]);
+        }
+
+        if (IsRenderTargetCompute())
+        {
+            m_resource_view_unorderedAccess = null_utility::handle(m_resource_view_unorderedAccess);
+        }
+
+        for (uint32_t i = 0; i < m_array_size && i < state_max_render_target_count; i++)
+        {
+            if (IsRenderTargetColor())
+            {
+                m_resource_view_renderTarget[i] = null_utility::handle(m_resource_view_renderTarget[i]);
+            }
+
+            if (IsRenderTargetDepthStencil())
+            {
+                m_resource_view_depthStencil[i] = null_utility::handle(m_resource_view_depthStencil[i]);
+
+                if (m_flags & RHI_Texture_DepthStencilViewReadOnly)
+                {
+                    m_resource_view_depthStencilReadOnly[i] = null_utility::handle(m_resource_view_depthStencilReadOnly[i]);
+                }
+            }
+        }
+
+        m_layout = get_initial_layout(this);
+
+        return true;
+	}
+}
@@ -0,0 +1,153 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =================
+#include <array>
+#include <vector>
+#include <cstring>
+#include "../RHI_Device.h"
+#include "../../Logging/Log.h"
+//============================
+
+// Reports a violation of the command stream, which is what a validation layer would catch on a real device
+#define NULL_VALIDATION_ERROR(text, ...) { LOG_ERROR(text, __VA_ARGS__); Spartan::null_utility::globals::rhi_context->validation_errors++; }
+
+namespace Spartan::null_utility
+{
+    struct globals
+    {
+        static inline RHI_Device* rhi_device;
+        static inline RHI_Context* rhi_context;
+    };
+
+    // Slot limits, they match D3D11 so that bindings which wouldn't work there are caught here
+    static const uint32_t slot_count_constant_buffer    = 14;
+    static const uint32_t slot_count_sampler            = 16;
+    static const uint32_t slot_count_texture            = 128;
+    static const uint32_t stage_count                   = 3; // vertex, pixel, compute
+
+    // There are no API objects, so the address of the member which would hold one serves as a unique (and non-null) handle
+    inline void* handle(void*& api_object)
+    {
+        return &api_object;
+    }
+
+    inline uint32_t stage_index(const RHI_Shader_Type stage)
+    {
+        return stage == RHI_Shader_Vertex ? 0 : stage == RHI_Shader_Pixel ? 1 : 2;
+    }
+
+    namespace buffer
+    {
+        // Buffers live in system memory, mapping them simply returns that memory
+        inline void* create(const uint64_t size, const void* data = nullptr)
+        {
+            std::byte* memory = new std::byte[size != 0 ? size : 1];
+
+            if (data && size != 0)
+            {
+                memcpy(memory, data, size);
+            }
+
+            return memory;
+        }
+
+        inline void destroy(void*& memory)
+        {
+            delete[] static_cast<std::byte*>(memory);
+            memory = nullptr;
+        }
+    }
+
+    enum class command_type
+    {
+        render_pass_begin,
+        render_pass_end,
+        clear,
+        draw,
+        draw_indexed,
+        dispatch,
+        viewport,
+        scissor,
+        vertex_buffer,
+        index_buffer,
+        constant_buffer,
+        sampler,
+        texture,
+        barrier
+    };
+
+    struct command
+    {
+        command_type type               = command_type::draw;
+        const Spartan_Object* object    = nullptr;  // the resource the command refers to (if any)
+        const char* label               = nullptr;  // render pass name (if any)
+        std::array<uint32_t, 4> args    = { 0, 0, 0, 0 };
+    };
+
+    // What a null command list records into, along with the state that's bound, so that redundant bindings can be skipped
+    struct command_buffer
+    {
+        command& record(const command_type type, const Spartan_Object* object = nullptr, const char* label = nullptr)
+        {
+            command& cmd    = commands.emplace_back();
+            cmd.type        = type;
+            cmd.object      = object;
+            cmd.label       = label;
+
+            return cmd;
+        }
+
+        void reset()
+        {
+            commands.clear();
+            render_pass_drawn   = false;
+            render_targets      = {};
+            shader_vertex       = nullptr;
+            shader_pixel        = nullptr;
+            shader_compute      = nullptr;
+            vertex_buffer       = nullptr;
+            index_buffer        = nullptr;
+            constant_buffers    = {};
+            samplers            = {};
+            textures            = {};
+        }
+
+        uint32_t index = 0;
+        std::vector<command> commands;
+
+        // Render pass
+        bool render_pass_drawn = false; // once drawing starts, the attachments can't change layout anymore
+        std::array<const void*, state_max_render_target_count + 1> render_targets = {}; // +1 for depth-stencil
+
+        // Bound state
+        const void* shader_vertex               = nullptr;
+        const void* shader_pixel                = nullptr;
+        const void* shader_compute              = nullptr;
+        const RHI_VertexBuffer* vertex_buffer   = nullptr;
+        const RHI_IndexBuffer* index_buffer     = nullptr;
+        std::array<std::array<const void*, slot_count_constant_buffer>, stage_count> constant_buffers = {};
+        std::array<const void*, slot_count_sampler> samplers = {};
+        std::array<std::array<const void*, slot_count_texture>, stage_count> textures = {};
+    };
+}
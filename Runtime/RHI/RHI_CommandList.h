@@ -99,7 +99,7 @@ namespace Spartan
 
 		// Draw/Dispatch
         bool Draw(uint32_t vertex_count);
-		bool DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0);
+		bool DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0, uint32_t instance_count = 1);
         void Dispatch(uint32_t x, uint32_t y, uint32_t z = 1) const;
 
 		// Viewport
@@ -157,9 +157,11 @@ namespace Spartan
         Renderer* m_renderer                        = nullptr;
         RHI_PipelineCache* m_pipeline_cache         = nullptr;
         RHI_DescriptorCache* m_descriptor_cache     = nullptr;
+        RHI_DescriptorSetLayout* m_descriptor_layout_current = nullptr;
         RHI_PipelineState* m_pipeline_state         = nullptr;
         RHI_Device* m_rhi_device                    = nullptr;
         Profiler* m_profiler                        = nullptr;
+        void* m_cmd_pool                            = nullptr;
         void* m_cmd_buffer                          = nullptr;
         void* m_processed_fence                     = nullptr;
         void* m_processed_semaphore                 = nullptr;
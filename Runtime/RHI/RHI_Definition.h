@@ -70,7 +70,8 @@ namespace Spartan
     {
         RHI_Api_D3d11,
         RHI_Api_D3d12,
-        RHI_Api_Vulkan
+        RHI_Api_Vulkan,
+        RHI_Api_Null
     };
 
 	enum RHI_Present_Mode : uint32_t
@@ -327,4 +328,13 @@ namespace Spartan
 		Shader_Compilation_Succeeded,
 		Shader_Compilation_Failed
 	};
+
+    // Queued compilations run highest priority first
+    enum Shader_Compile_Priority : uint8_t
+    {
+        Shader_Compile_Priority_Low,    // speculative
+        Shader_Compile_Priority_Normal,
+        Shader_Compile_Priority_High,   // something is waiting on it (e.g. the loaded world or a draw)
+        Shader_Compile_Priority_Count
+    };
 }
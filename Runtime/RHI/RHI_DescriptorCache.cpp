@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_Texture.h"
 #include "RHI_PipelineState.h"
 #include "RHI_ConstantBuffer.h"
+#include "RHI_CommandList.h"
 #include "RHI_Implementation.h"
 #include "RHI_DescriptorSetLayout.h"
 #include "..\Utilities\Hash.h"
@@ -46,8 +47,10 @@ namespace Spartan
         SetDescriptorSetCapacity(m_descriptor_set_capacity);
     }
 
-    void RHI_DescriptorCache::SetPipelineState(RHI_PipelineState& pipeline_state)
+    RHI_DescriptorSetLayout* RHI_DescriptorCache::GetDescriptorSetLayout(const RHI_CommandList* cmd_list, RHI_PipelineState& pipeline_state)
     {
+        lock_guard<mutex> lock(m_mutex);
+
         // Name this resource, very useful for Vulkan debugging
         if (m_name.empty())
         {
@@ -73,6 +76,9 @@ namespace Spartan
            {
                Utility::Hash::hash_combine(hash, pipeline_state.shader_pixel->GetId());
            }
+
+           // Command lists can record on different threads, so they don't share the bound resources
+           Utility::Hash::hash_combine(hash, cmd_list->GetId());
        }
 
        // If there is no descriptor set layout for this particular hash, create one
@@ -87,63 +93,10 @@ namespace Spartan
        }
 
        // Get the descriptor set layout we will be using
-        m_descriptor_layout_current = it->second.get();
-        m_descriptor_layout_current->NeedsToBind();
-    }
-
-    bool RHI_DescriptorCache::SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer)
-    {
-        if (!m_descriptor_layout_current)
-        {
-            LOG_ERROR("Invalid descriptor set layout");
-            return false;
-        }
-
-        return m_descriptor_layout_current->SetConstantBuffer(slot, constant_buffer);
-    }
-
-    void RHI_DescriptorCache::SetSampler(const uint32_t slot, RHI_Sampler* sampler)
-    {
-        if (!m_descriptor_layout_current)
-        {
-            LOG_ERROR("Invalid descriptor set layout");
-            return;
-        }
-
-        m_descriptor_layout_current->SetSampler(slot, sampler);
-    }
-
-    void RHI_DescriptorCache::SetTexture(const uint32_t slot, RHI_Texture* texture)
-    {
-        if (!m_descriptor_layout_current)
-        {
-            LOG_ERROR("Invalid descriptor set layout");
-            return;
-        }
-
-        m_descriptor_layout_current->SetTexture(slot, texture);
-    }
-
-    void* RHI_DescriptorCache::GetResource_DescriptorSetLayout() const
-    {
-        if (!m_descriptor_layout_current)
-        {
-            LOG_ERROR("Invalid descriptor set layout");
-            return nullptr;
-        }
-
-        return m_descriptor_layout_current->GetResource_DescriptorSetLayout();
-    }
-
-    bool RHI_DescriptorCache::GetResource_DescriptorSet(void*& descriptor_set)
-    {
-        if (!m_descriptor_layout_current)
-        {
-            LOG_ERROR("Invalid descriptor set layout");
-            return nullptr;
-        }
+        RHI_DescriptorSetLayout* descriptor_set_layout = it->second.get();
+        descriptor_set_layout->NeedsToBind();
 
-        return m_descriptor_layout_current->GetResource_DescriptorSet(this, descriptor_set);
+        return descriptor_set_layout;
     }
 
     bool RHI_DescriptorCache::HasEnoughCapacity() const
@@ -153,6 +106,8 @@ namespace Spartan
 
     void RHI_DescriptorCache::GrowIfNeeded()
     {
+        lock_guard<mutex> lock(m_mutex);
+
         // If there is room for at least one more descriptor set (hence +1), we don't need to re-allocate yet
         const uint32_t required_capacity = GetDescriptorSetCount() + 1;
 
@@ -165,6 +120,15 @@ namespace Spartan
         }
     }
 
+    void RHI_DescriptorCache::RemoveDescriptorSets(const vector<void*>& texture_views)
+    {
+        lock_guard<mutex> lock(m_mutex);
+        for (const auto& it : m_descriptor_set_layouts)
+        {
+            it.second->RemoveDescriptorSets(texture_views);
+        }
+    }
+
     uint32_t RHI_DescriptorCache::GetDescriptorSetCount() const
     {
         uint32_t descriptor_set_count = 0;
@@ -224,33 +188,17 @@ namespace Spartan
             }
         }
 
-        // Change constant buffers to dynamic (if requested) - This is a hack and not flexible, must improve
+        // Change constant buffers to dynamic (if requested)
+        for (const int slot : pipeline_state.dynamic_constant_buffer_slots)
         {
-            if (pipeline_state.dynamic_constant_buffer_slot != -1)
-            {
-                for (RHI_Descriptor& descriptor : descriptors)
-                {
-                    if (descriptor.type == RHI_Descriptor_ConstantBuffer)
-                    {
-                        if (descriptor.slot == pipeline_state.dynamic_constant_buffer_slot + m_rhi_device->GetContextRhi()->shader_shift_buffer)
-                        {
-                            descriptor.type = RHI_Descriptor_ConstantBufferDynamic;
-                        }
-                    }
-                }
-            }
+            if (slot == -1)
+                continue;
 
-            if (pipeline_state.dynamic_constant_buffer_slot_2 != -1)
+            for (RHI_Descriptor& descriptor : descriptors)
             {
-                for (RHI_Descriptor& descriptor : descriptors)
+                if (descriptor.type == RHI_Descriptor_ConstantBuffer && descriptor.slot == slot + m_rhi_device->GetContextRhi()->shader_shift_buffer)
                 {
-                    if (descriptor.type == RHI_Descriptor_ConstantBuffer)
-                    {
-                        if (descriptor.slot == pipeline_state.dynamic_constant_buffer_slot_2 + m_rhi_device->GetContextRhi()->shader_shift_buffer)
-                        {
-                            descriptor.type = RHI_Descriptor_ConstantBufferDynamic;
-                        }
-                    }
+                    descriptor.type = RHI_Descriptor_ConstantBufferDynamic;
                 }
             }
         }
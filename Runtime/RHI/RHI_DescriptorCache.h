@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
 //=================================
 
 namespace Spartan
@@ -37,23 +38,20 @@ namespace Spartan
         RHI_DescriptorCache(const RHI_Device* rhi_device);
         ~RHI_DescriptorCache();
 
-        void SetPipelineState(RHI_PipelineState& pipeline_state);
-        RHI_DescriptorSetLayout* GetCurrentDescriptorSetLayout() { return m_descriptor_layout_current; }
-
-        // Descriptor resource updating
-        bool SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer);
-        void SetSampler(const uint32_t slot, RHI_Sampler* sampler);
-        void SetTexture(const uint32_t slot, RHI_Texture* texture);
+        // Descriptor set layouts hold the bound resources, so every command list gets its own
+        RHI_DescriptorSetLayout* GetDescriptorSetLayout(const RHI_CommandList* cmd_list, RHI_PipelineState& pipeline_state);
 
         // Properties
         void* GetResource_DescriptorSetPool() const { return m_descriptor_pool; }
-        void* GetResource_DescriptorSetLayout() const;
-        bool GetResource_DescriptorSet(void*& descriptor_set);
+        std::mutex& GetPoolMutex()                  { return m_mutex; }
 
         // Capacity
         bool HasEnoughCapacity() const;
         void GrowIfNeeded();
 
+        // Removes the descriptor sets which reference any of the given texture views (e.g. after those were replaced)
+        void RemoveDescriptorSets(const std::vector<void*>& texture_views);
+
     private:
         uint32_t GetDescriptorSetCount() const;
         void SetDescriptorSetCapacity(uint32_t descriptor_capacity);
@@ -62,12 +60,14 @@ namespace Spartan
 
         // Descriptor set layouts 
         std::unordered_map<std::size_t, std::shared_ptr<RHI_DescriptorSetLayout>> m_descriptor_set_layouts;
-        RHI_DescriptorSetLayout* m_descriptor_layout_current = nullptr;
 
         // Descriptor pool
         uint32_t m_descriptor_set_capacity = 16;
         void* m_descriptor_pool = nullptr;
 
+        // Guards the layouts and the pool, command lists can be recorded from multiple threads
+        std::mutex m_mutex;
+
         // Dependencies
         const RHI_Device* m_rhi_device;
     };
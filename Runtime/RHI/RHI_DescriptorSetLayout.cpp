@@ -130,6 +130,10 @@ namespace Spartan
         // Get the hash of the current state of the descriptors
         const size_t hash = ComputeDescriptorSetHash(m_descriptors);
 
+        // The pool is shared by all command lists, and the sets are removed from the thread which
+        // replaces a texture (see RemoveDescriptorSets()), so the lookup has to be guarded as well.
+        lock_guard<mutex> lock(descriptor_cache->GetPoolMutex());
+
         // If we don't have a descriptor set to match that state, create one
         auto it = m_descriptor_sets.find(hash);
         if (it == m_descriptor_sets.end())
@@ -138,6 +142,15 @@ namespace Spartan
             if (descriptor_cache->HasEnoughCapacity())
             {
                 descriptor_set = CreateDescriptorSet(hash, descriptor_cache);
+
+                // Keep track of the textures it references, so that it can be removed if they get replaced
+                for (const RHI_Descriptor& descriptor : m_descriptors)
+                {
+                    if (descriptor.type == RHI_Descriptor_Texture && descriptor.resource)
+                    {
+                        m_descriptor_set_textures.emplace(descriptor.resource, hash);
+                    }
+                }
             }
             else
             {
@@ -156,6 +169,26 @@ namespace Spartan
         return true;
     }
 
+    void RHI_DescriptorSetLayout::RemoveDescriptorSets(const vector<void*>& texture_views)
+    {
+        // Command lists in flight might still be using the sets, so they are only forgotten (the pool is reset
+        // eventually), which keeps a view that the driver hands out again from matching a stale set.
+        for (void* texture_view : texture_views)
+        {
+            const auto range = m_descriptor_set_textures.equal_range(texture_view);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (m_descriptor_sets.erase(it->second) != 0)
+                {
+                    m_descriptor_sets_removed++;
+                }
+            }
+            m_descriptor_set_textures.erase(range.first, range.second);
+        }
+
+        m_needs_to_bind = true;
+    }
+
     const std::array<uint32_t, Spartan::state_max_constant_buffer_count> RHI_DescriptorSetLayout::GetDynamicOffsets() const
     {
         // vkCmdBindDescriptorSets expects an array without empty values
@@ -46,8 +46,11 @@ namespace Spartan
         const std::array<uint32_t, state_max_constant_buffer_count> GetDynamicOffsets() const;
         uint32_t GetDynamicOffsetCount() const;
         void* GetResource_DescriptorSetLayout() const { return m_descriptor_set_layout; }      
-        uint32_t GetDescriptorSetCount()        const { return static_cast<uint32_t>(m_descriptor_sets.size()); }
+        uint32_t GetDescriptorSetCount()        const { return static_cast<uint32_t>(m_descriptor_sets.size()) + m_descriptor_sets_removed; }
         void NeedsToBind()                            { m_needs_to_bind = true; }
+        void ClearDescriptorSets()                    { m_descriptor_sets.clear(); m_descriptor_set_textures.clear(); m_descriptor_sets_removed = 0; m_needs_to_bind = true; }
+        // The descriptor cache calls this with the pool mutex held
+        void RemoveDescriptorSets(const std::vector<void*>& texture_views);
 
     private:
         std::size_t ComputeDescriptorSetHash(const std::vector<RHI_Descriptor>& descriptors);
@@ -74,6 +77,8 @@ namespace Spartan
 
         // Descriptor sets
         std::unordered_map<std::size_t, void*> m_descriptor_sets;
+        std::unordered_multimap<void*, std::size_t> m_descriptor_set_textures;    // texture view to the hashes of the sets which reference it
+        uint32_t m_descriptor_sets_removed = 0;                                     // still allocated from the pool, until it's reset
 
         // Descriptor set layout
         void* m_descriptor_set_layout = nullptr;
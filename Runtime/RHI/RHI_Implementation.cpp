@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==================
 #include "Spartan.h"
 #include "RHI_Implementation.h"
+#include "../IO/FileStream.h"
 //=============================
 
 //= NAMESPACES =====
@@ -50,5 +51,89 @@ namespace Spartan
             allocator = nullptr;
         }
     }
+
+    bool RHI_Context::initialise_pipeline_cache(const string& file_path)
+    {
+        pipeline_cache_file_path = file_path;
+
+        // Load the data of the previous run (if any)
+        vector<unsigned char> data;
+        if (FileSystem::Exists(file_path))
+        {
+            FileStream file(file_path, FileStream_Read);
+            if (file.IsOpen())
+            {
+                file.Read(&data);
+            }
+        }
+
+        // Only use it if it was created by the same driver and device, some drivers don't like foreign data
+        if (!data.empty())
+        {
+            // Header (version one) - size, version, vendor id, device id and the cache uuid
+            struct header_version_one
+            {
+                uint32_t size;
+                uint32_t version;
+                uint32_t vendor_id;
+                uint32_t device_id;
+                uint8_t uuid[VK_UUID_SIZE];
+            } header = {};
+
+            if (data.size() >= sizeof(header))
+            {
+                memcpy(&header, data.data(), sizeof(header));
+            }
+
+            // The size is that of the header itself, which is 32 bytes for version one and can't exceed the file
+            const bool compatible =
+                header.size         >= sizeof(header)                       &&
+                header.size         <= data.size()                          &&
+                header.version      == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                header.vendor_id    == device_properties.vendorID           &&
+                header.device_id    == device_properties.deviceID           &&
+                memcmp(header.uuid, device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+            if (!compatible)
+            {
+                LOG_INFO("The pipeline cache is invalid or was created by a different driver or device, starting from scratch");
+                data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo create_info   = {};
+        create_info.sType                       = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        create_info.initialDataSize             = data.size();
+        create_info.pInitialData                = data.empty() ? nullptr : data.data();
+
+        return vulkan_utility::error::check(vkCreatePipelineCache(device, &create_info, nullptr, &pipeline_cache));
+    }
+
+    void RHI_Context::destroy_pipeline_cache()
+    {
+        if (pipeline_cache == nullptr)
+            return;
+
+        // Save it, so that the next run doesn't have to compile the pipelines all over again
+        size_t size = 0;
+        if (vkGetPipelineCacheData(device, pipeline_cache, &size, nullptr) == VK_SUCCESS && size != 0)
+        {
+            vector<unsigned char> data(size);
+            if (vkGetPipelineCacheData(device, pipeline_cache, &size, data.data()) == VK_SUCCESS)
+            {
+                data.resize(size);
+
+                FileSystem::CreateDirectory_(FileSystem::GetDirectoryFromFilePath(pipeline_cache_file_path));
+                FileStream file(pipeline_cache_file_path, FileStream_Write);
+                if (file.IsOpen())
+                {
+                    file.Write(data);
+                }
+            }
+        }
+
+        vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+        pipeline_cache = nullptr;
+    }
 #endif
 }
@@ -315,6 +315,10 @@ static const VkImageLayout vulkan_image_layout[] =
     #include <vector>
     #include <unordered_map>
 #endif
+#if defined (API_GRAPHICS_NULL)
+    #include <atomic>
+    #include <string>
+#endif
 
 // RHI_Context
 namespace Spartan
@@ -345,6 +349,8 @@ namespace Spartan
             VkColorSpaceKHR surface_color_space             = VK_COLOR_SPACE_MAX_ENUM_KHR;
             VmaAllocator allocator                          = nullptr;
             std::unordered_map<uint64_t, VmaAllocation> allocations;
+            VkPipelineCache pipeline_cache                  = nullptr;
+            std::string pipeline_cache_file_path;
 
             // Extensions
             #ifdef DEBUG
@@ -375,6 +381,19 @@ namespace Spartan
 
                 bool initalise_allocator();
                 void destroy_allocator();
+                bool initialise_pipeline_cache(const std::string& file_path);
+                void destroy_pipeline_cache();
+        #endif
+
+        #if defined(API_GRAPHICS_NULL)
+            RHI_Api_Type api_type = RHI_Api_Null;
+
+            // Command stream violations reported by the command lists (there is no GPU to catch them)
+            std::atomic<uint32_t> validation_errors = { 0 };
+
+            // The command streams of the next trace_frames frames get appended to trace_file_path
+            uint32_t trace_frames       = 0;
+            std::string trace_file_path = "rhi_null_trace.txt";
         #endif
 
         // Debugging
@@ -400,6 +419,13 @@ namespace Spartan
         static const uint32_t descriptor_max_samplers                   = 10;
         static const uint32_t descriptor_max_textures                   = 10;
 
+        // Command lists - D3D11 records everything on the immediate context, so only one thread can record at a time
+        #if defined(API_GRAPHICS_VULKAN) || defined(API_GRAPHICS_NULL)
+            static const bool parallel_recording = true;
+        #else
+            static const bool parallel_recording = false;
+        #endif
+
         // Device limits
         uint32_t max_texture_dimension_2d   = 16384;
         uint32_t max_msaa_level             = 0;
@@ -421,6 +447,8 @@ namespace Spartan
     #include "D3D12/D3D12_Utility.h"
 #elif defined (API_GRAPHICS_VULKAN)
     #include "Vulkan/Vulkan_Utility.h"
+#elif defined (API_GRAPHICS_NULL)
+    #include "Null/Null_Utility.h"
 #endif
 
 #endif // RUNTIME
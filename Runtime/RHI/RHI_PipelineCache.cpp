@@ -81,6 +81,7 @@ namespace Spartan
         size_t hash = pipeline_state.GetHash();
 
         // If no pipeline exists for this state, create one
+        lock_guard<mutex> lock(m_mutex);
         auto it = m_cache.find(hash);
         if (it == m_cache.end())
         {
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ======================
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include "RHI_Definition.h"
 #include "../Core/Spartan_Object.h"
@@ -39,6 +40,7 @@ namespace Spartan
 	private:
         // <hash of pipeline state, pipeline state object>
         std::unordered_map<std::size_t, std::shared_ptr<RHI_Pipeline>> m_cache;
+        std::mutex m_mutex; // command lists can be recorded from multiple threads
 
         // Dependencies
         const RHI_Device* m_rhi_device;
@@ -104,9 +104,8 @@ namespace Spartan
         RHI_Texture* unordered_access_view         = nullptr;
         bool render_target_depth_texture_read_only = false;
 
-        // such a hack, must fix. Update: Came back to byte me in the ass
-        int dynamic_constant_buffer_slot    = 2;
-        int dynamic_constant_buffer_slot_2  = 3;
+        // Constant buffers which are bound with a dynamic offset (uber, object and instance), -1 disables a slot
+        std::array<int, 3> dynamic_constant_buffer_slots = { 2, 3, 5 };
 
         // Clear values
         
@@ -19,16 +19,22 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ======================
+//= INCLUDES =================================
 #include "Spartan.h"
 #include "RHI_Shader.h"
 #include "RHI_InputLayout.h"
+#include "RHI_Implementation.h"
+#include "RHI_Device.h"
+#include "../IO/FileStream.h"
 #include "../Threading/Threading.h"
 #include "../Rendering/Renderer.h"
+#include "../Rendering/ShaderCompileQueue.h"
+#include "../Resource/ResourceCache.h"
+#include "../Utilities/Hash.h"
 #pragma warning(push, 0) // Hide warnings belonging SPIRV-Cross 
 #include <spirv_hlsl.hpp>
 #pragma warning(pop)
-//=================================
+//============================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -36,6 +42,20 @@ using namespace std;
 
 namespace Spartan
 {
+    namespace _rhi_shader
+    {
+        // Bump this whenever the cache file layout or the compiler arguments change
+        static const uint32_t cache_version = 1;
+
+        static string read_file(const string& file_path)
+        {
+            ifstream in(file_path, ios::in | ios::binary);
+            stringstream buffer;
+            buffer << in.rdbuf();
+            return buffer.str();
+        }
+    }
+
 	RHI_Shader::RHI_Shader(Context* context) : Spartan_Object(context)
 	{
 		m_rhi_device	= context->GetSubsystem<Renderer>()->GetRhiDevice();
@@ -109,13 +129,203 @@ namespace Spartan
         }
 	}
 
+    void* RHI_Shader::_Compile(const string& shader)
+    {
+        // The descriptors are either reflected or loaded along with the bytecode
+        m_descriptors.clear();
+
+        // Without a context there is no project directory to cache to
+        const string file_path  = m_context ? _CacheFilePath(shader) : string();
+        const uint64_t key      = file_path.empty() ? 0 : _CacheKey(shader);
+
+        // Load the bytecode from the cache
+        vector<uint8_t> bytecode;
+        if (!file_path.empty() && _CacheLoad(file_path, key, bytecode))
+        {
+            if (void* resource = _CreateResource(bytecode))
+                return resource;
+
+            // The cached bytecode is unusable (e.g. a driver which doesn't like it), so compile it again
+            LOG_WARNING("Failed to create shader \"%s\" from the cache, re-compiling...", m_name.c_str());
+            m_descriptors.clear();
+        }
+
+        // Compile
+        if (!_CompileBytecode(shader, bytecode))
+            return nullptr;
+
+        void* resource = _CreateResource(bytecode);
+        if (resource && !file_path.empty())
+        {
+            _CacheSave(file_path, key, bytecode);
+        }
+
+        return resource;
+    }
+
+    uint64_t RHI_Shader::_CacheKey(const string& shader) const
+    {
+        using namespace Utility::Hash;
+
+        // Everything that ends up in the bytecode, the compiler arguments are covered by the API, the version and the build configuration
+        uint64_t key = fnv1a(&_rhi_shader::cache_version, sizeof(_rhi_shader::cache_version));
+        key = fnv1a(&m_rhi_device->GetContextRhi()->api_type, sizeof(RHI_Api_Type), key);
+        key = fnv1a(&m_shader_type, sizeof(m_shader_type), key);
+        const auto to_string = [](const char* str) { return string(str ? str : ""); };
+        key = fnv1a(to_string(GetEntryPoint()) + to_string(GetTargetProfile()) + to_string(GetShaderModel()), key);
+        #ifdef DEBUG
+        key = fnv1a(string("debug"), key);
+        #endif
+        const uint32_t shifts[] = { RHI_Context::shader_shift_buffer, RHI_Context::shader_shift_texture, RHI_Context::shader_shift_sampler, RHI_Context::shader_shift_rw_buffer };
+        key = fnv1a(shifts, sizeof(shifts), key);
+
+        // Defines, in a stable order
+        const map<string, string> defines(m_defines.begin(), m_defines.end());
+        for (const auto& define : defines)
+        {
+            key = fnv1a(define.first + "=" + define.second + ";", key);
+        }
+
+        // Source
+        if (!FileSystem::IsFile(shader))
+            return fnv1a(shader, key);
+
+        key = fnv1a(_rhi_shader::read_file(shader), key);
+
+        // Includes, the whole closure, so that a change anywhere invalidates every shader which uses it
+        vector<string> includes = FileSystem::GetIncludedFiles(shader);
+        sort(includes.begin(), includes.end());
+        includes.erase(unique(includes.begin(), includes.end()), includes.end());
+        for (const string& include : includes)
+        {
+            key = fnv1a(FileSystem::GetFileNameFromFilePath(include), key);
+            key = fnv1a(_rhi_shader::read_file(include), key);
+        }
+
+        return key;
+    }
+
+    string RHI_Shader::_CacheFilePath(const string& shader) const
+    {
+        // One file per shader and set of defines, it's overwritten whenever any of the inputs change
+        string defines;
+        for (const auto& define : map<string, string>(m_defines.begin(), m_defines.end()))
+        {
+            defines += define.first + "=" + define.second + ";";
+        }
+
+        const bool is_file      = FileSystem::IsFile(shader);
+        const string name       = is_file ? FileSystem::GetFileNameNoExtensionFromFilePath(shader) : "source";
+        uint64_t identity       = Utility::Hash::fnv1a(shader);
+        identity                = Utility::Hash::fnv1a(defines, identity);
+        identity                = Utility::Hash::fnv1a(&m_shader_type, sizeof(m_shader_type), identity);
+
+        char identity_str[17];
+        snprintf(identity_str, sizeof(identity_str), "%016llx", static_cast<unsigned long long>(identity));
+
+        return m_context->GetSubsystem<ResourceCache>()->GetProjectDirectory() + "Cache/Shaders/" + name + "_" + identity_str + ".bin";
+    }
+
+    bool RHI_Shader::_CacheLoad(const string& file_path, const uint64_t key, vector<uint8_t>& bytecode)
+    {
+        if (!FileSystem::Exists(file_path))
+            return false;
+
+        FileStream file(file_path, FileStream_Read);
+        if (!file.IsOpen())
+            return false;
+
+        // Key and descriptor count, anything shorter is truncated
+        const uint64_t file_size = file.GetSize();
+        if (file_size < sizeof(uint64_t) + sizeof(uint32_t))
+            return false;
+
+        // A different key means that some input changed
+        if (file.ReadAs<uint64_t>() != key)
+            return false;
+
+        // Reflection, a count which the rest of the file can't hold means that it's truncated or corrupt
+        const uint32_t descriptor_count = file.ReadAs<uint32_t>();
+        const uint64_t descriptor_size  = 3 * sizeof(uint32_t);
+        if (descriptor_count > (file_size - file.GetPosition()) / descriptor_size)
+            return false;
+
+        m_descriptors.reserve(descriptor_count);
+        for (uint32_t i = 0; i < descriptor_count; i++)
+        {
+            const RHI_Descriptor_Type type  = static_cast<RHI_Descriptor_Type>(file.ReadAs<uint32_t>());
+            const uint32_t slot             = file.ReadAs<uint32_t>();
+            const uint32_t stage            = file.ReadAs<uint32_t>();
+            m_descriptors.emplace_back(type, slot, stage);
+        }
+
+        // Bytecode (a short read is a miss as well)
+        const uint64_t bytecode_size_max = file_size - file.GetPosition();
+        file.Read(&bytecode);
+
+        if (bytecode.empty() || sizeof(uint32_t) + bytecode.size() > bytecode_size_max)
+        {
+            bytecode.clear();
+            m_descriptors.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void RHI_Shader::_CacheSave(const string& file_path, const uint64_t key, const vector<uint8_t>& bytecode) const
+    {
+        FileSystem::CreateDirectory_(FileSystem::GetDirectoryFromFilePath(file_path));
+
+        FileStream file(file_path, FileStream_Write);
+        if (!file.IsOpen())
+        {
+            LOG_WARNING("Failed to cache shader \"%s\"", m_name.c_str());
+            return;
+        }
+
+        file.Write(key);
+
+        // Reflection
+        file.Write(static_cast<uint32_t>(m_descriptors.size()));
+        for (const RHI_Descriptor& descriptor : m_descriptors)
+        {
+            file.Write(static_cast<uint32_t>(descriptor.type));
+            file.Write(descriptor.slot);
+            file.Write(descriptor.stage);
+        }
+
+        // Bytecode
+        file.Write(bytecode);
+    }
+
 	template <typename T>
-	void RHI_Shader::CompileAsync(const RHI_Shader_Type type, const string& shader)
+	void RHI_Shader::CompileAsync(const RHI_Shader_Type type, const string& shader, const Shader_Compile_Priority priority /*= Shader_Compile_Priority_Normal*/)
 	{
-		m_context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
-		{
-			Compile<T>(type, shader);
-		});
+        // Considered compiling from now on, so that anything waiting on it waits for the queue as well
+        m_compilation_state = Shader_Compilation_Compiling;
+
+        const auto compile = [this, type, shader]()
+        {
+            Compile<T>(type, shader);
+        };
+
+        // The queue is created by the renderer, shaders compiled before that go straight to the thread pool
+        Renderer* renderer = m_context->GetSubsystem<Renderer>();
+        if (renderer && renderer->GetShaderCompileQueue())
+        {
+            // Dropped compilations fail, so that WaitForCompilation() returns
+            const auto cancel = [this]()
+            {
+                m_compilation_state = Shader_Compilation_Failed;
+            };
+
+            renderer->GetShaderCompileQueue()->Add(this, compile, cancel, priority);
+        }
+        else
+        {
+            m_context->GetSubsystem<Threading>()->AddTask(compile);
+        }
 	}
 
 	void RHI_Shader::WaitForCompilation()
@@ -165,6 +375,10 @@ namespace Spartan
         static const char* target_profile_vs = "vs_6_0";
         static const char* target_profile_ps = "ps_6_0";
         static const char* target_profile_cs = "cs_6_0";
+        #elif defined(API_GRAPHICS_NULL)
+        static const char* target_profile_vs = "vs_6_0";
+        static const char* target_profile_ps = "ps_6_0";
+        static const char* target_profile_cs = "cs_6_0";
         #endif
 
         if (m_shader_type == RHI_Shader_Vertex)     return target_profile_vs;
@@ -182,6 +396,8 @@ namespace Spartan
         static const char* shader_model = "6_0";
         #elif defined(API_GRAPHICS_VULKAN)
         static const char* shader_model = "6_0";
+        #elif defined(API_GRAPHICS_NULL)
+        static const char* shader_model = "6_0";
         #endif
 
         return shader_model;
@@ -229,12 +445,12 @@ namespace Spartan
 		}
 	}
 
-    //= Explicit template instantiation =======================================================================
-    template void RHI_Shader::CompileAsync<RHI_Vertex_Undefined>(const RHI_Shader_Type, const std::string&);
-    template void RHI_Shader::CompileAsync<RHI_Vertex_Pos>(const RHI_Shader_Type, const std::string&);
-    template void RHI_Shader::CompileAsync<RHI_Vertex_PosTex>(const RHI_Shader_Type, const std::string&);
-    template void RHI_Shader::CompileAsync<RHI_Vertex_PosCol>(const RHI_Shader_Type, const std::string&);
-    template void RHI_Shader::CompileAsync<RHI_Vertex_Pos2dTexCol8>(const RHI_Shader_Type, const std::string&);
-    template void RHI_Shader::CompileAsync<RHI_Vertex_PosTexNorTan>(const RHI_Shader_Type, const std::string&);
-    //=========================================================================================================
+    //= Explicit template instantiation ==================================================================================================
+    template void RHI_Shader::CompileAsync<RHI_Vertex_Undefined>(const RHI_Shader_Type, const std::string&, const Shader_Compile_Priority);
+    template void RHI_Shader::CompileAsync<RHI_Vertex_Pos>(const RHI_Shader_Type, const std::string&, const Shader_Compile_Priority);
+    template void RHI_Shader::CompileAsync<RHI_Vertex_PosTex>(const RHI_Shader_Type, const std::string&, const Shader_Compile_Priority);
+    template void RHI_Shader::CompileAsync<RHI_Vertex_PosCol>(const RHI_Shader_Type, const std::string&, const Shader_Compile_Priority);
+    template void RHI_Shader::CompileAsync<RHI_Vertex_Pos2dTexCol8>(const RHI_Shader_Type, const std::string&, const Shader_Compile_Priority);
+    template void RHI_Shader::CompileAsync<RHI_Vertex_PosTexNorTan>(const RHI_Shader_Type, const std::string&, const Shader_Compile_Priority);
+    //====================================================================================================================================
 }
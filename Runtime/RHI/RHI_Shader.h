@@ -51,12 +51,12 @@ namespace Spartan
             Compile<RHI_Vertex_Undefined>(type, shader);
         }
 
-        // Asynchronous compilation
+        // Asynchronous compilation, goes through the renderer's compile queue
         template<typename T>
-        void CompileAsync(const RHI_Shader_Type type, const std::string& shader);
-        void CompileAsync(const RHI_Shader_Type type, const std::string& shader)
+        void CompileAsync(const RHI_Shader_Type type, const std::string& shader, const Shader_Compile_Priority priority = Shader_Compile_Priority_Normal);
+        void CompileAsync(const RHI_Shader_Type type, const std::string& shader, const Shader_Compile_Priority priority = Shader_Compile_Priority_Normal)
         {
-            CompileAsync<RHI_Vertex_Undefined>(type, shader);
+            CompileAsync<RHI_Vertex_Undefined>(type, shader, priority);
         }
 
         void WaitForCompilation();
@@ -82,8 +82,18 @@ namespace Spartan
 		std::shared_ptr<RHI_Device> m_rhi_device;
 
 	private:
-        // All compile functions resolve to this, and this is the underlying API implements
+        // All compile functions resolve to this, it loads the bytecode from the cache (if none of the inputs changed) or compiles it
 		void* _Compile(const std::string& shader);
+
+        // Cache
+        uint64_t _CacheKey(const std::string& shader) const;
+        std::string _CacheFilePath(const std::string& shader) const;
+        bool _CacheLoad(const std::string& file_path, uint64_t key, std::vector<uint8_t>& bytecode);
+        void _CacheSave(const std::string& file_path, uint64_t key, const std::vector<uint8_t>& bytecode) const;
+
+        // The underlying API implements these
+        bool _CompileBytecode(const std::string& shader, std::vector<uint8_t>& bytecode);
+        void* _CreateResource(const std::vector<uint8_t>& bytecode);
 		void _Reflect(const RHI_Shader_Type shader_type, const uint32_t* ptr, uint32_t size);
 
 		std::string m_name;
@@ -70,7 +70,6 @@ namespace Spartan
         void* Get_Resource(uint32_t i = 0)          const { return m_resource[i]; }
         void* Get_Resource_View(uint32_t i = 0)     const { return m_resource_view[i]; }
         void* Get_Resource_View_RenderTarget()      const { return m_resource_view_renderTarget; }
-        void*& GetCmdPool()                               { return m_cmd_pool; }
 
 	private:
         bool AcquireNextImage();
@@ -89,7 +88,6 @@ namespace Spartan
 		void* m_resource_view_renderTarget	= nullptr;
 		void* m_surface				        = nullptr;	
 		void* m_window_handle		        = nullptr;
-        void* m_cmd_pool                    = nullptr;
         bool m_image_acquired               = false;
         bool m_present                      = true;
         uint32_t m_cmd_index                = 0;
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_Device.h"
 #include "../IO/FileStream.h"
 #include "../Rendering/Renderer.h"
+#include "../Rendering/TextureStreamer.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/Import/ImageImporter.h"
 //===========================================
@@ -35,6 +36,45 @@ using namespace std;
 
 namespace Spartan
 {
+    namespace _rhi_texture
+    {
+        // Mips are stored most detailed first, each one prefixed with its byte count
+        void skip_mips(FileStream* file, const uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                file->Skip(file->ReadAs<uint32_t>());
+            }
+        }
+
+        bool read_mips(const string& file_path, const uint32_t mip_first, const uint32_t mip_count, vector<vector<std::byte>>* mips)
+        {
+            auto file = make_unique<FileStream>(file_path, FileStream_Read);
+            if (!file->IsOpen())
+            {
+                LOG_ERROR("Unable to open \"%s\"", file_path.c_str());
+                return false;
+            }
+
+            file->Skip(sizeof(uint32_t)); // byte count
+            const auto file_mip_count = file->ReadAs<uint32_t>();
+            if (mip_first + mip_count > file_mip_count)
+            {
+                LOG_ERROR("Invalid mip range");
+                return false;
+            }
+
+            skip_mips(file.get(), mip_first);
+            mips->resize(mip_count);
+            for (auto& mip : *mips)
+            {
+                file->Read(&mip);
+            }
+
+            return true;
+        }
+    }
+
 	RHI_Texture::RHI_Texture(Context* context) : IResource(context, Resource_Texture)
 	{
 		m_rhi_device = context->GetSubsystem<Renderer>()->GetRhiDevice();
@@ -48,8 +88,9 @@ namespace Spartan
 
 	bool RHI_Texture::SaveToFile(const string& file_path)
 	{
-		// Check to see if the file already exists (if so, get the byte count)
+		// Check to see if the file already exists (if so, get the byte and mipmap count)
 		uint32_t byte_count = 0;
+		uint32_t mip_count  = 0;
 		{
 			if (FileSystem::Exists(file_path))
 			{
@@ -57,12 +98,13 @@ namespace Spartan
 				if (file->IsOpen())
 				{
 					file->Read(&byte_count);
+					file->Read(&mip_count);
 				}
 			}
 		}
 
 		auto append = true;
-		auto file = make_unique<FileStream>(file_path, FileStream_Write | FileStream_Append);
+		auto file = make_unique<FileStream>(file_path, FileStream_Write);
 		if (!file->IsOpen())
 			return false;
 
@@ -74,6 +116,7 @@ namespace Spartan
 			(
 				sizeof(uint32_t) +	// byte count
 				sizeof(uint32_t) +	// mipmap count
+				mip_count * sizeof(uint32_t) +	// mipmap byte counts
 				byte_count			// bytes
 			);
 		}
@@ -96,10 +139,10 @@ namespace Spartan
 			m_data.shrink_to_fit();
 		}
 
-		// Write properties
+		// Write properties (a streaming texture writes the dimensions of its full chain)
 		file->Write(m_bits_per_channel);
-		file->Write(m_width);
-		file->Write(m_height);
+		file->Write(IsStreamable() ? m_stream_width : m_width);
+		file->Write(IsStreamable() ? m_stream_height : m_height);
         file->Write(static_cast<uint32_t>(m_format));
 		file->Write(m_channel_count);
 		file->Write(m_flags);
@@ -159,19 +202,7 @@ namespace Spartan
 		}
 		m_load_state = LoadState_Completed;
 
-        // Compute memory usage
-        {
-            m_size_cpu = 0;
-            m_size_gpu = 0;
-            for (uint8_t mip_index = 0; mip_index < m_mip_levels; mip_index++)
-            {
-                const uint32_t mip_width  = m_width >> mip_index;
-                const uint32_t mip_height = m_height >> mip_index;
-
-                m_size_cpu += mip_index < m_data.size() ? m_data[mip_index].size() * sizeof(std::byte) : 0;
-                m_size_gpu += mip_width * mip_height * (m_bits_per_channel / 8);
-            }
-        }
+        ComputeMemoryUsage();
 
 		return true;
 	}
@@ -191,32 +222,18 @@ namespace Spartan
     {
         vector<std::byte> data;
 
-        // Use existing data, if it's there
-        if (index < m_data.size())
+        // Use existing data, if it's there (a streaming texture's data starts at its mip offset)
+        if (index >= m_stream_mip_offset && index - m_stream_mip_offset < m_data.size())
         {
-            data = m_data[index];
+            data = m_data[index - m_stream_mip_offset];
         }
         // Else attempt to load the data
         else
         {
-            auto file = make_unique<FileStream>(GetResourceFilePathNative(), FileStream_Read);
-            if (file->IsOpen())
+            vector<vector<std::byte>> mips;
+            if (_rhi_texture::read_mips(GetResourceFilePathNative(), index, 1, &mips))
             {
-                auto byte_count = file->ReadAs<uint32_t>();
-                const auto mip_count  = file->ReadAs<uint32_t>();
-
-                if (index < mip_count)
-                {
-                    for (uint32_t i = 0; i <= index; i++)
-                    {
-                        file->Read(&data);
-                    }
-                }
-                else
-                {
-                    LOG_ERROR("Invalid index");
-                }
-                file->Close();
+                data = move(mips.front());
             }
             else
             {
@@ -227,6 +244,61 @@ namespace Spartan
         return data;
     }
 
+    uint64_t RHI_Texture::GetStreamSizeGpu(const uint32_t mip_offset) const
+    {
+        uint64_t size = 0;
+        for (uint32_t mip_index = mip_offset; mip_index < m_stream_mip_count; mip_index++)
+        {
+            const uint64_t mip_width  = (max)(m_stream_width >> mip_index, 1u);
+            const uint64_t mip_height = (max)(m_stream_height >> mip_index, 1u);
+            size += mip_width * mip_height * GetBytesPerPixel();
+        }
+
+        return size;
+    }
+
+    bool RHI_Texture::StreamRead(const uint32_t mip_offset, vector<vector<std::byte>>* mips) const
+    {
+        if (!IsStreamable() || mip_offset >= m_stream_mip_count)
+        {
+            LOG_ERROR("Invalid mip offset");
+            return false;
+        }
+
+        return _rhi_texture::read_mips(GetResourceFilePathNative(), mip_offset, m_stream_mip_count - mip_offset, mips);
+    }
+
+    bool RHI_Texture::StreamApply(const uint32_t mip_offset, vector<vector<std::byte>>& mips, function<void()>& destroy_previous)
+    {
+        if (!IsStreamable() || mips.empty() || mip_offset + mips.size() != m_stream_mip_count)
+        {
+            LOG_ERROR("Invalid mips");
+            return false;
+        }
+
+        // The GPU might still be using the current resource, so it's up to the caller to destroy it when it's safe
+        destroy_previous = DetachResourceGpu();
+
+        m_stream_mip_offset = mip_offset;
+        m_width             = (max)(m_stream_width >> mip_offset, 1u);
+        m_height            = (max)(m_stream_height >> mip_offset, 1u);
+        m_mip_levels        = static_cast<uint32_t>(mips.size());
+        m_data              = move(mips);
+
+        const bool result = CreateResourceGpu();
+        if (!result)
+        {
+            LOG_ERROR("Failed to create shader resource for \"%s\".", GetResourceFilePathNative().c_str());
+        }
+
+        // The GPU has its own copy, the rest of the chain stays on disk
+        m_data.clear();
+        m_data.shrink_to_fit();
+        ComputeMemoryUsage();
+
+        return result;
+    }
+
     bool RHI_Texture::LoadFromFile_ForeignFormat(const string& file_path, const bool generate_mipmaps)
 	{
 		// Load texture
@@ -253,12 +325,8 @@ namespace Spartan
 		auto byte_count = file->ReadAs<uint32_t>();
         const auto mip_count  = file->ReadAs<uint32_t>();
 
-		// Read bytes
-		m_data.resize(mip_count);
-		for (auto& mip : m_data)
-		{
-			file->Read(&mip);
-		}
+        // Skip the bytes for now, the properties decide which mips are needed
+        _rhi_texture::skip_mips(file.get(), mip_count);
 
 		// Read properties
 		file->Read(&m_bits_per_channel);
@@ -270,6 +338,30 @@ namespace Spartan
 		SetId(file->ReadAs<uint32_t>());
 		SetResourceFilePath(file->ReadAs<string>());
 
+        // If streaming is enabled, start with the least detailed mips only and let the streamer bring in the rest (2D textures only,
+        // the data of a cube map holds the mips of every side)
+        m_stream_mip_count  = 0;
+        m_stream_mip_offset = 0;
+        m_stream_width      = m_width;
+        m_stream_height     = m_height;
+        const bool is_streamable = m_resource_type == Resource_Texture2d && m_array_size == 1 && mip_count > 1 && IsSampled();
+        if (is_streamable && m_context->GetSubsystem<Renderer>()->GetTextureStreamer())
+        {
+            m_stream_mip_count  = mip_count;
+            m_stream_mip_offset = TextureStreamer::GetInitialMipOffset(m_width, m_height, mip_count);
+            m_width             = (max)(m_stream_width >> m_stream_mip_offset, 1u);
+            m_height            = (max)(m_stream_height >> m_stream_mip_offset, 1u);
+        }
+
+		// Read bytes
+        file->Seek(sizeof(uint32_t) + sizeof(uint32_t));
+        _rhi_texture::skip_mips(file.get(), m_stream_mip_offset);
+		m_data.resize(mip_count - m_stream_mip_offset);
+		for (auto& mip : m_data)
+		{
+			file->Read(&mip);
+		}
+
 		return true;
 	}
 
@@ -306,4 +398,26 @@ namespace Spartan
 
 		return byte_count;
 	}
+
+    void RHI_Texture::DestroyResourceGpu()
+    {
+        if (const function<void()> destroy = DetachResourceGpu())
+        {
+            destroy();
+        }
+    }
+
+    void RHI_Texture::ComputeMemoryUsage()
+    {
+        m_size_cpu = 0;
+        m_size_gpu = 0;
+        for (uint32_t mip_index = 0; mip_index < m_mip_levels; mip_index++)
+        {
+            const uint64_t mip_width  = (max)(m_width >> mip_index, 1u);
+            const uint64_t mip_height = (max)(m_height >> mip_index, 1u);
+
+            m_size_cpu += mip_index < m_data.size() ? m_data[mip_index].size() * sizeof(std::byte) : 0;
+            m_size_gpu += mip_width * mip_height * GetBytesPerPixel();
+        }
+    }
 }
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <array>
+#include <functional>
 #include "RHI_Viewport.h"
 #include "RHI_Definition.h"
 #include "../Resource/IResource.h"
@@ -94,6 +95,17 @@ namespace Spartan
         std::vector<std::byte>* GetData(uint32_t mipmap_index);
         std::vector<std::byte> GetMipmap(uint32_t index);
 
+        // Streaming - a texture which streams only keeps its least detailed mips resident (and only on the GPU), in which case width,
+        // height, mip levels and data describe the resident mips. The full chain stays in the native file, mip indices below are relative to it.
+        bool IsStreamable()                                             const { return m_stream_mip_count > 1; }
+        uint32_t GetStreamMipCount()                                    const { return m_stream_mip_count; }
+        uint32_t GetStreamMipOffset()                                   const { return m_stream_mip_offset; }
+        uint32_t GetStreamWidth()                                       const { return m_stream_width; }
+        uint32_t GetStreamHeight()                                      const { return m_stream_height; }
+        uint64_t GetStreamSizeGpu(const uint32_t mip_offset) const;
+        bool StreamRead(const uint32_t mip_offset, std::vector<std::vector<std::byte>>* mips) const;
+        bool StreamApply(const uint32_t mip_offset, std::vector<std::vector<std::byte>>& mips, std::function<void()>& destroy_previous);
+
         // Binding type
         bool IsSampled()                    const { return m_flags & RHI_Texture_ShaderView; }
         bool IsRenderTargetCompute()        const { return m_flags & RHI_Texture_UnorderedAccessView; }
@@ -129,6 +141,10 @@ namespace Spartan
 		bool LoadFromFile_ForeignFormat(const std::string& file_path, bool generate_mipmaps);
 		static uint32_t GetChannelCountFromFormat(RHI_Format format);
         virtual bool CreateResourceGpu() { LOG_ERROR("Function not implemented by API"); return false; }
+        // Takes the API objects away from the texture, the returned function destroys them (e.g. once the GPU is done with them)
+        virtual std::function<void()> DetachResourceGpu() { LOG_ERROR("Function not implemented by API"); return nullptr; }
+        void DestroyResourceGpu();
+        void ComputeMemoryUsage();
 
 		uint32_t m_bits_per_channel = 8;
 		uint32_t m_width		    = 0;
@@ -143,6 +159,12 @@ namespace Spartan
 		std::vector<std::vector<std::byte>> m_data;
 		std::shared_ptr<RHI_Device> m_rhi_device;
 
+        // Streaming
+        uint32_t m_stream_mip_count     = 0; // mips in the native file, zero if the texture doesn't stream
+        uint32_t m_stream_mip_offset    = 0; // most detailed resident mip
+        uint32_t m_stream_width         = 0;
+        uint32_t m_stream_height        = 0;
+
         // API
         void* m_resource_view[2]                = { nullptr, nullptr }; // color/depth, stencil
         void* m_resource_view_unorderedAccess   = nullptr;
@@ -51,8 +51,11 @@ namespace Spartan
 
         RHI_Context* rhi_context = m_rhi_device->GetContextRhi();
 
+        // Command pool - Pools can't be used from multiple threads, so each command list has its own and can be recorded on any thread
+        vulkan_utility::command_pool::create(m_cmd_pool, RHI_Queue_Graphics);
+
         // Command buffer
-        vulkan_utility::command_buffer::create(m_swap_chain->GetCmdPool(), m_cmd_buffer, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        vulkan_utility::command_buffer::create(m_cmd_pool, m_cmd_buffer, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
         vulkan_utility::debug::set_name(static_cast<VkCommandBuffer>(m_cmd_buffer), "cmd_buffer");
 
         // Sync - Fence
@@ -90,7 +93,8 @@ namespace Spartan
         vulkan_utility::semaphore::destroy(m_processed_semaphore);
 
         // Command buffer
-        vulkan_utility::command_buffer::destroy(m_swap_chain->GetCmdPool(), m_cmd_buffer);
+        vulkan_utility::command_buffer::destroy(m_cmd_pool, m_cmd_buffer);
+        vulkan_utility::command_pool::destroy(m_cmd_pool);
 
         // Query pool
         if (m_query_pool)
@@ -191,12 +195,13 @@ namespace Spartan
             }
         }
 
-        RHI_PipelineState* state = m_pipeline->GetPipelineState();
+        // A command list which didn't begin any render pass has no pipeline
+        RHI_PipelineState* state = m_pipeline ? m_pipeline->GetPipelineState() : nullptr;
 
         // Get wait and signal semaphores
         void* wait_semaphore    = nullptr;
         void* signal_semaphore  = nullptr;
-        if (state->render_target_swapchain)
+        if (state && state->render_target_swapchain)
         {
             // If the swapchain is not presenting (e.g. minimised window), don't submit and work
             if (!state->render_target_swapchain->IsPresenting())
@@ -209,6 +214,9 @@ namespace Spartan
             signal_semaphore    = m_processed_semaphore;
         }
         
+        // Submit any pending uploads first, so that the resources this command list uses are populated
+        vulkan_utility::upload::flush();
+
         vulkan_utility::fence::reset(m_processed_fence);
 
         if (!m_rhi_device->Queue_Submit(
@@ -233,7 +241,6 @@ namespace Spartan
             if (!vulkan_utility::fence::wait(m_processed_fence))
                 return false;
 
-            m_descriptor_cache->GrowIfNeeded();
             m_cmd_state = RHI_Cmd_List_Idle;
         }
 
@@ -260,11 +267,11 @@ namespace Spartan
         {
             m_pipeline_active = false;
 
-            // Update the descriptor cache with the pipeline state and potentially create a new pipeline (if not already there)
-            m_descriptor_cache->SetPipelineState(pipeline_state);
+            // Get this command list's descriptor set layout for the pipeline state (it's created if not already there)
+            m_descriptor_layout_current = m_descriptor_cache->GetDescriptorSetLayout(this, pipeline_state);
 
             // Get a pipeline which matches the pipeline state
-            m_pipeline = m_pipeline_cache->GetPipeline(this, pipeline_state, m_descriptor_cache->GetResource_DescriptorSetLayout());
+            m_pipeline = m_pipeline_cache->GetPipeline(this, pipeline_state, m_descriptor_layout_current->GetResource_DescriptorSetLayout());
             if (!m_pipeline)
             {
                 LOG_ERROR("Failed to acquire appropriate pipeline");
@@ -390,7 +397,7 @@ namespace Spartan
         return true;
 	}
 
-    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count /*= 1*/)
 	{
         if (m_cmd_state != RHI_Cmd_List_Recording)
         {
@@ -405,7 +412,7 @@ namespace Spartan
 		vkCmdDrawIndexed(
             static_cast<VkCommandBuffer>(m_cmd_buffer), // commandBuffer
             index_count,                                // indexCount
-            1,                                          // instanceCount
+            instance_count,                             // instanceCount
             index_offset,                               // firstIndex
             vertex_offset,                              // vertexOffset
             0                                           // firstInstance
@@ -525,8 +532,14 @@ namespace Spartan
             return false;
         }
 
+        if (!m_descriptor_layout_current)
+        {
+            LOG_ERROR("Invalid descriptor set layout");
+            return false;
+        }
+
         // Set (will only happen if it's not already set)
-        return m_descriptor_cache->SetConstantBuffer(slot, constant_buffer);
+        return m_descriptor_layout_current->SetConstantBuffer(slot, constant_buffer);
     }
 
     void RHI_CommandList::SetSampler(const uint32_t slot, RHI_Sampler* sampler) const
@@ -537,8 +550,14 @@ namespace Spartan
             return;
         }
 
+        if (!m_descriptor_layout_current)
+        {
+            LOG_ERROR("Invalid descriptor set layout");
+            return;
+        }
+
         // Set (will only happen if it's not already set)
-        m_descriptor_cache->SetSampler(slot, sampler);
+        m_descriptor_layout_current->SetSampler(slot, sampler);
     }
 
     void RHI_CommandList::SetTexture(const uint32_t slot, RHI_Texture* texture, const uint8_t scope /*= RHI_Shader_Pixel*/)
@@ -592,8 +611,14 @@ namespace Spartan
             }
         }
 
+        if (!m_descriptor_layout_current)
+        {
+            LOG_ERROR("Invalid descriptor set layout");
+            return;
+        }
+
         // Set (will only happen if it's not already set)
-        m_descriptor_cache->SetTexture(slot, texture);
+        m_descriptor_layout_current->SetTexture(slot, texture);
     }
 
     uint32_t RHI_CommandList::Gpu_GetMemory(RHI_Device* rhi_device)
@@ -832,15 +857,20 @@ namespace Spartan
         // Descriptor set == null, result = true    -> the descriptor set is already bound
         // Descriptor set == null, result = false   -> a new descriptor was needed but we are out of memory (allocates next frame)
 
+        if (!m_descriptor_layout_current)
+        {
+            LOG_ERROR("Invalid descriptor set layout");
+            return false;
+        }
+
         void* descriptor_set = nullptr;
-        bool result = m_descriptor_cache->GetResource_DescriptorSet(descriptor_set);
+        bool result = m_descriptor_layout_current->GetResource_DescriptorSet(m_descriptor_cache, descriptor_set);
 
         if (result && descriptor_set != nullptr)
         {
             // Get dynamic offsets
-            RHI_DescriptorSetLayout* descriptor_set_layout = m_descriptor_cache->GetCurrentDescriptorSetLayout();
-            const std::array<uint32_t, state_max_constant_buffer_count> dynamic_offsets = descriptor_set_layout->GetDynamicOffsets();
-            uint32_t dynamic_offset_count = descriptor_set_layout->GetDynamicOffsetCount();
+            const std::array<uint32_t, state_max_constant_buffer_count> dynamic_offsets = m_descriptor_layout_current->GetDynamicOffsets();
+            uint32_t dynamic_offset_count = m_descriptor_layout_current->GetDynamicOffsetCount();
             
             // Bind descriptor set
             VkDescriptorSet descriptor_sets[1] = { static_cast<VkDescriptorSet>(descriptor_set) };
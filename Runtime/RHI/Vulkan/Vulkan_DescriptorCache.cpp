@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "../RHI_Implementation.h"
 #include "../RHI_DescriptorCache.h"
+#include "../RHI_DescriptorSetLayout.h"
 #include "../RHI_Shader.h"
 //=================================
 
@@ -55,9 +56,11 @@ namespace Spartan
         // Wait in case the pool is being used
         m_rhi_device->Queue_WaitAll();
 
-        // Destroy layouts (and descriptor sets)
-        m_descriptor_set_layouts.clear();
-        m_descriptor_layout_current = nullptr;
+        // Forget the descriptor sets, they are freed along with the pool (the layouts are kept, command lists point to them)
+        for (const auto& it : m_descriptor_set_layouts)
+        {
+            it.second->ClearDescriptorSets();
+        }
 
         // Destroy pool
         if (m_descriptor_pool)
@@ -19,10 +19,11 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====================
+//= INCLUDES ============================
 #include "Spartan.h"
 #include "../RHI_Implementation.h"
-//================================
+#include "../../Resource/ResourceCache.h"
+//=======================================
 
 //= NAMESPACES ===============
 using namespace std;
@@ -248,6 +249,9 @@ namespace Spartan
         // Initialise the memory allocator
         m_rhi_context->initalise_allocator();
 
+        // Initialise the pipeline cache, it's persisted in the project directory so that pipelines are only compiled once
+        m_rhi_context->initialise_pipeline_cache(m_context->GetSubsystem<ResourceCache>()->GetProjectDirectory() + "Cache/pipeline_cache.bin");
+
 		// Detect and log version
 		string version_major	= to_string(VK_VERSION_MAJOR(app_info.apiVersion));
 		string version_minor	= to_string(VK_VERSION_MINOR(app_info.apiVersion));
@@ -268,6 +272,8 @@ namespace Spartan
         // Release resources
 		if (Queue_Wait(RHI_Queue_Graphics))
 		{
+            vulkan_utility::upload::shutdown();
+            m_rhi_context->destroy_pipeline_cache();
             m_rhi_context->destroy_allocator();
 
             if (m_rhi_context->debug)
@@ -35,7 +35,12 @@ namespace Spartan
 {
     void RHI_IndexBuffer::_destroy()
     {
-        // Wait in case the buffer is still in use
+        // Nothing to destroy (e.g. the first _create()), so no need to stall the device
+        if (!m_buffer)
+            return;
+
+        // Wait in case the buffer is still in use, or a pending upload still references it
+        vulkan_utility::upload::flush();
         m_rhi_device->Queue_WaitAll();
 
         // Unmap
@@ -83,37 +88,14 @@ namespace Spartan
         {
             // The reason we use staging is because memory with VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT is not mappable but it's fast, we want that.
 
-            // Create staging/source buffer and copy the indices to it
-            void* staging_buffer = nullptr;
-            VmaAllocation allocation_staging = vulkan_utility::buffer::create(staging_buffer, m_size_gpu, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, false, indices);
-            if (!allocation_staging)
-                return false;
-
             // Create destination buffer
             VmaAllocation allocation = vulkan_utility::buffer::create(m_buffer, m_size_gpu, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
             if (!allocation)
                 return false;
 
-            // Copy staging buffer to destination buffer
-            {
-                // Create command buffer
-                VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Transfer);
-
-                VkBuffer* buffer_vk         = reinterpret_cast<VkBuffer*>(&m_buffer);
-                VkBuffer* buffer_staging_vk = reinterpret_cast<VkBuffer*>(&staging_buffer);
-
-                // Copy
-                VkBufferCopy copy_region = {};
-                copy_region.size = m_size_gpu;
-                vkCmdCopyBuffer(cmd_buffer, *buffer_staging_vk, *buffer_vk, 1, &copy_region);
-
-                // Flush and free command buffer
-                if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Transfer))
-                    return false;
-
-                // Destroy staging buffer
-                vulkan_utility::buffer::destroy(staging_buffer);
-            }
+            // Copy through the upload queue's staging ring, recorded now and submitted before any command list which could use the buffer
+            if (!vulkan_utility::upload::copy_to_buffer(m_buffer, indices, m_size_gpu))
+                return false;
 
             m_allocation    = static_cast<void*>(allocation);
             m_is_mappable   = false;
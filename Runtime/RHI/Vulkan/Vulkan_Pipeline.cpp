@@ -313,7 +313,7 @@ namespace Spartan
 
             // Create
             auto pipeline = reinterpret_cast<VkPipeline*>(&m_pipeline);
-            vulkan_utility::error::check(vkCreateGraphicsPipelines(m_rhi_device->GetContextRhi()->device, nullptr, 1, &pipeline_info, nullptr, pipeline));
+            vulkan_utility::error::check(vkCreateGraphicsPipelines(m_rhi_device->GetContextRhi()->device, m_rhi_device->GetContextRhi()->pipeline_cache, 1, &pipeline_info, nullptr, pipeline));
 
             // Name
             vulkan_utility::debug::set_name(*pipeline, m_state.pass_name);
@@ -334,7 +334,7 @@ namespace Spartan
 		};
 	}
 	
-	void* RHI_Shader::_Compile(const string& shader)
+	bool RHI_Shader::_CompileBytecode(const string& shader, vector<uint8_t>& bytecode)
 	{
 		// Deduce some things
         const auto is_file	    = FileSystem::IsSupportedShaderFile(shader);
@@ -414,7 +414,7 @@ namespace Spartan
 			if (FAILED(result))
 			{
 				LOG_ERROR("Failed to create source buffer.");
-				return nullptr;
+				return false;
 			}
 		}
 
@@ -437,52 +437,61 @@ namespace Spartan
 			if (!DxShaderCompiler::ValidateOperationResult(compilation_result))
 			{
 				LOG_ERROR("Failed to compile %s", shader.c_str());
-				return nullptr;
+				return false;
 			}
 		}
 		
-		// Create shader module
-		CComPtr<IDxcBlob> shader_compiled	= nullptr;
-		VkShaderModule shader_module		= nullptr;
-        if (SUCCEEDED(compilation_result->GetResult(&shader_compiled)))
+		// Get the SPIR-V
+		CComPtr<IDxcBlob> shader_compiled = nullptr;
+        if (FAILED(compilation_result->GetResult(&shader_compiled)) || !shader_compiled)
+		{
+            LOG_ERROR("Failed to get shader buffer.");
+            return false;
+		}
+
+        const uint8_t* ptr = static_cast<const uint8_t*>(shader_compiled->GetBufferPointer());
+        bytecode.assign(ptr, ptr + shader_compiled->GetBufferSize());
+
+		return true;
+	}
+
+    void* RHI_Shader::_CreateResource(const vector<uint8_t>& bytecode)
+    {
+        // Create shader module
+        VkShaderModuleCreateInfo create_info   = {};
+        create_info.sType                       = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        create_info.codeSize                    = static_cast<size_t>(bytecode.size());
+        create_info.pCode                       = reinterpret_cast<const uint32_t*>(bytecode.data());
+
+        VkShaderModule shader_module = nullptr;
+        if (vkCreateShaderModule(m_rhi_device->GetContextRhi()->device, &create_info, nullptr, &shader_module) != VK_SUCCESS)
         {
-			VkShaderModuleCreateInfo create_info = {};
-			create_info.sType		= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-			create_info.codeSize	= static_cast<size_t>(shader_compiled->GetBufferSize());
-			create_info.pCode		= reinterpret_cast<const uint32_t*>(shader_compiled->GetBufferPointer());
-	
-			if (vkCreateShaderModule(m_rhi_device->GetContextRhi()->device, &create_info, nullptr, &shader_module) == VK_SUCCESS)
-			{
-				// Reflect shader resources (so that descriptor sets can be created later)
-				_Reflect
-				(
-                    m_shader_type,
-					reinterpret_cast<uint32_t*>(shader_compiled->GetBufferPointer()),
-					static_cast<uint32_t>(shader_compiled->GetBufferSize() / 4)
-				);
+            LOG_ERROR("Failed to create shader module.");
+            return nullptr;
+        }
 
-                // Create input layout
-                if (m_vertex_type != RHI_Vertex_Type_Unknown)
-                {
-                    if (!m_input_layout->Create(m_vertex_type, nullptr))
-                    {
-                        LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(shader).c_str());
-                        return nullptr;
-                    }
-                }
-			}
-            else
+        // Reflect shader resources (so that descriptor sets can be created later), unless they came from the cache
+        if (m_descriptors.empty())
+        {
+            _Reflect
+            (
+                m_shader_type,
+                reinterpret_cast<const uint32_t*>(bytecode.data()),
+                static_cast<uint32_t>(bytecode.size() / 4)
+            );
+        }
+
+        // Create input layout
+        if (m_vertex_type != RHI_Vertex_Type_Unknown)
+        {
+            if (!m_input_layout->Create(m_vertex_type, nullptr))
             {
-                LOG_ERROR("Failed to create shader module.");
+                LOG_ERROR("Failed to create input layout for %s", m_name.c_str());
+                vkDestroyShaderModule(m_rhi_device->GetContextRhi()->device, shader_module, nullptr);
                 return nullptr;
             }
-		}	
-        else
-		{
-            LOG_ERROR("Failed to get shader buffer.");
-            return nullptr;
-		}
+        }
 
-		return static_cast<void*>(shader_module);
-	}		
+        return static_cast<void*>(shader_module);
+    }
 }
@@ -67,111 +67,20 @@ namespace Spartan
         }
     }
 
-    inline bool copy_to_staging_buffer(RHI_Texture* texture, std::vector<VkBufferImageCopy>& buffer_image_copies, void*& staging_buffer)
+    inline RHI_Image_Layout get_target_layout(const RHI_Texture* texture)
     {
-        if (!texture->HasData())
-        {
-            LOG_WARNING("No data to stage");
-            return true;
-        }
-
-        const uint32_t width            = texture->GetWidth();
-        const uint32_t height           = texture->GetHeight();
-        const uint32_t array_size       = texture->GetArraySize();
-        const uint32_t mip_levels       = texture->GetMiplevels();
-        const uint32_t bytes_per_pixel  = texture->GetBytesPerPixel();
-
-        // Fill out VkBufferImageCopy structs describing the array and the mip levels   
-        VkDeviceSize buffer_offset = 0;
-        for (uint32_t array_index = 0; array_index < array_size; array_index++)
-        {
-            for (uint32_t mip_index = 0; mip_index < mip_levels; mip_index++)
-            {
-                uint32_t mip_width  = width >> mip_index;
-                uint32_t mip_height = height >> mip_index;
-
-                VkBufferImageCopy region				= {};
-                region.bufferOffset						= buffer_offset;
-                region.bufferRowLength					= 0;
-                region.bufferImageHeight				= 0;
-                region.imageSubresource.aspectMask      = vulkan_utility::image::get_aspect_mask(texture);
-                region.imageSubresource.mipLevel		= mip_index;
-                region.imageSubresource.baseArrayLayer	= array_index;
-                region.imageSubresource.layerCount		= array_size;
-                region.imageOffset						= { 0, 0, 0 };
-                region.imageExtent						= { mip_width, mip_height, 1 };
-
-                buffer_image_copies[mip_index] = region;
-
-                // Update staging buffer memory requirement (in bytes)
-                buffer_offset += mip_width * mip_height * bytes_per_pixel;
-            }
-        }
-
-        // Create staging buffer
-        VmaAllocation allocation = vulkan_utility::buffer::create(staging_buffer, buffer_offset, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        // Copy array and mip level data to the staging buffer
-        void* data = nullptr;
-        buffer_offset = 0;
-        if (vulkan_utility::error::check(vmaMapMemory(vulkan_utility::globals::rhi_context->allocator, allocation, &data)))
-        {
-            for (uint32_t array_index = 0; array_index < array_size; array_index++)
-            {
-                for (uint32_t mip_index = 0; mip_index < mip_levels; mip_index++)
-                {
-                    uint64_t buffer_size = (width >> mip_index) * (height >> mip_index) * bytes_per_pixel;
-                    memcpy(static_cast<std::byte*>(data) + buffer_offset, texture->GetData(array_index + mip_index)->data(), buffer_size);
-                    buffer_offset += buffer_size;
-                }
-            }
+        RHI_Image_Layout target_layout = RHI_Image_Preinitialized;
 
-            vmaUnmapMemory(vulkan_utility::globals::rhi_context->allocator, allocation);
-        }
+        if (texture->IsSampled() && texture->IsColorFormat())
+            target_layout = RHI_Image_Shader_Read_Only_Optimal;
 
-        return true;
-    }
-
-    inline bool stage(RHI_Texture* texture, RHI_Image_Layout& texture_layout)
-    {
-        // Copy the texture's data to a staging buffer
-        void* staging_buffer = nullptr;
-        std::vector<VkBufferImageCopy> buffer_image_copies(texture->GetMiplevels());
-        if (!copy_to_staging_buffer(texture, buffer_image_copies, staging_buffer))
-            return false;
+        if (texture->IsRenderTargetColor())
+            target_layout = RHI_Image_Color_Attachment_Optimal;
 
-        // Copy the staging buffer into the image
-        if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
-        {
-            // Optimal layout for images which are the destination of a transfer format
-            RHI_Image_Layout layout = RHI_Image_Transfer_Dst_Optimal;
-
-            // Transition to layout
-            if (!vulkan_utility::image::set_layout(cmd_buffer, texture, layout))
-                return false;
-
-            // Copy the staging buffer to the image
-            vkCmdCopyBufferToImage(
-                cmd_buffer,
-                static_cast<VkBuffer>(staging_buffer),
-                static_cast<VkImage>(texture->Get_Resource()),
-                vulkan_image_layout[layout],
-                static_cast<uint32_t>(buffer_image_copies.size()),
-                buffer_image_copies.data()
-            );
-
-            // End/flush
-            if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
-                return false;
-
-            // Free staging buffer
-            vulkan_utility::buffer::destroy(staging_buffer);
-
-            // Let the texture know about it's new layout
-            texture_layout = layout;
-        }
+        if (texture->IsRenderTargetDepthStencil())
+            target_layout = RHI_Image_Depth_Stencil_Attachment_Optimal;
 
-        return true;
+        return target_layout;
     }
 
     RHI_Texture2D::~RHI_Texture2D()
@@ -179,17 +88,35 @@ namespace Spartan
         if (!m_rhi_device->IsInitialized())
             return;
 
+        // Pending uploads might still reference the image
+        vulkan_utility::upload::flush();
         m_rhi_device->Queue_WaitAll();
         m_data.clear();
 
-        vulkan_utility::image::view::destroy(m_resource_view[0]);
-        vulkan_utility::image::view::destroy(m_resource_view[1]);
-        for (uint32_t i = 0; i < state_max_render_target_count; i++)
+        DestroyResourceGpu();
+	}
+
+    function<void()> RHI_Texture2D::DetachResourceGpu()
+    {
+        // Take the image and the views, the texture is left without any
+        void* resource                  = nullptr;
+        const VmaAllocation allocation  = vulkan_utility::image::detach(this, resource);
+        array<void*, 2> views           = { m_resource_view[0], m_resource_view[1] };
+        auto views_depth_stencil        = m_resource_view_depthStencil;
+        auto views_render_target        = m_resource_view_renderTarget;
+        m_resource_view[0]              = nullptr;
+        m_resource_view[1]              = nullptr;
+        m_resource_view_depthStencil.fill(nullptr);
+        m_resource_view_renderTarget.fill(nullptr);
+
+        return [resource, allocation, views, views_depth_stencil, views_render_target]() mutable
         {
-            vulkan_utility::image::view::destroy(m_resource_view_depthStencil[i]);
-            vulkan_utility::image::view::destroy(m_resource_view_renderTarget[i]);
-        }
-        vulkan_utility::image::destroy(this);
+            vulkan_utility::image::view::destroy(views[0]);
+            vulkan_utility::image::view::destroy(views[1]);
+            vulkan_utility::image::view::destroy(views_depth_stencil);
+            vulkan_utility::image::view::destroy(views_render_target);
+            vulkan_utility::image::destroy(resource, allocation);
+        };
 	}
 
     void RHI_Texture::SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* command_list /*= nullptr*/)
@@ -222,46 +149,12 @@ namespace Spartan
             return false;
         }
 
-        // If the texture has any data, stage it
-        if (HasData())
+        // Stage the texture's data (if any) and transition to the target layout, this is only recorded, the
+        // upload queue submits it before any command list which could use the texture.
+        if (!vulkan_utility::upload::copy_to_image(this, m_layout, get_target_layout(this)))
         {
-            if (!stage(this, m_layout))
-            {
-                LOG_ERROR("Failed to stage");
-                return false;
-            }
-        }
-
-        // Transition to target layout
-        if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
-        {    
-            RHI_Image_Layout target_layout = RHI_Image_Preinitialized;
-        
-            if (IsSampled() && IsColorFormat())
-                target_layout = RHI_Image_Shader_Read_Only_Optimal;
-        
-            if (IsRenderTargetColor())
-                target_layout = RHI_Image_Color_Attachment_Optimal;
-        
-            if (IsRenderTargetDepthStencil())
-                target_layout = RHI_Image_Depth_Stencil_Attachment_Optimal;
-        
-            // Transition to the final layout
-            if (!vulkan_utility::image::set_layout(cmd_buffer, this, target_layout))
-            {
-                LOG_ERROR("Failed to transition layout");
-                return false;
-            }
-        
-            // Flush
-            if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
-            {
-                LOG_ERROR("Failed to end command buffer");
-                return false;
-            }
-
-            // Update this texture with the new layout
-            m_layout = target_layout;
+            LOG_ERROR("Failed to upload");
+            return false;
         }
 
         // Create image views
@@ -318,6 +211,8 @@ namespace Spartan
         if (!m_rhi_device->IsInitialized())
             return;
 
+        // Pending uploads might still reference the image
+        vulkan_utility::upload::flush();
         m_rhi_device->Queue_WaitAll();
         m_data.clear();
 
@@ -340,38 +235,9 @@ namespace Spartan
             return false;
         }
 
-        // If the texture has any data, stage it
-        if (HasData())
-        {
-            if (!stage(this, m_layout))
-                return false;
-        }
-
-        // Transition to target layout
-        if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
-        {
-            RHI_Image_Layout target_layout = RHI_Image_Preinitialized;
-
-            if (IsSampled() && IsColorFormat())
-                target_layout = RHI_Image_Shader_Read_Only_Optimal;
-
-            if (IsRenderTargetColor())
-                target_layout = RHI_Image_Color_Attachment_Optimal;
-
-            if (IsRenderTargetDepthStencil())
-                target_layout = RHI_Image_Depth_Stencil_Attachment_Optimal;
-
-            // Transition to the final layout
-            if (!vulkan_utility::image::set_layout(cmd_buffer, this, target_layout))
-                return false;
-
-            // Flush
-            if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
-                return false;
-
-            // Update this texture with the new layout
-            m_layout = target_layout;
-        }
+        // Stage the texture's data (if any) and transition to the target layout
+        if (!vulkan_utility::upload::copy_to_image(this, m_layout, get_target_layout(this)))
+            return false;
 
         // Create image views
         {
@@ -43,6 +43,20 @@ namespace Spartan::vulkan_utility
     mutex                                                                   command_buffer_immediate::m_mutex_begin;
     mutex                                                                   command_buffer_immediate::m_mutex_end;
     unordered_map<RHI_Queue_Type, command_buffer_immediate::cmdbi_object>   command_buffer_immediate::m_objects;
+    mutex                                                                   upload::m_mutex;
+    upload::_batch                                                          upload::m_batch;
+    bool                                                                    upload::m_recording                         = false;
+    deque<upload::_batch>                                                   upload::m_batches_in_flight;
+    vector<upload::_batch>                                                  upload::m_batches_free;
+    uint64_t                                                                upload::m_batch_id                          = 1;
+    atomic<uint64_t>                                                        upload::m_batch_id_complete                 = 0;
+    RHI_Queue_Type                                                          upload::m_queue_type                        = RHI_Queue_Undefined;
+    void*                                                                   upload::m_ring_buffer                       = nullptr;
+    VmaAllocation                                                           upload::m_ring_allocation                   = nullptr;
+    std::byte*                                                              upload::m_ring_mapped                       = nullptr;
+    uint64_t                                                                upload::m_ring_size                         = 64 * 1024 * 1024; // 64 MB
+    uint64_t                                                                upload::m_ring_head                         = 0;
+    uint64_t                                                                upload::m_ring_used                         = 0;
 
 	bool image::create(RHI_Texture* texture)
 	{
@@ -104,17 +118,32 @@ namespace Spartan::vulkan_utility
 
     void image::destroy(RHI_Texture* texture)
     {
-        void* resource          = texture->Get_Resource();
-        uint64_t allocation_id  = texture->GetId();
+        void* resource                  = nullptr;
+        const VmaAllocation allocation  = detach(texture, resource);
+        destroy(resource, allocation);
+    }
 
-        auto it = globals::rhi_context->allocations.find(allocation_id);
-        if (it != globals::rhi_context->allocations.end())
-        {
-            VmaAllocation allocation = it->second;
-            vmaDestroyImage(globals::rhi_context->allocator, static_cast<VkImage>(resource), allocation);
-            globals::rhi_context->allocations.erase(allocation_id);
-            texture->Set_Resource(nullptr);
-        }
+    VmaAllocation image::detach(RHI_Texture* texture, void*& resource)
+    {
+        // The allocation is keyed by the texture id, so it has to go before the texture creates another image
+        auto it = globals::rhi_context->allocations.find(texture->GetId());
+        if (it == globals::rhi_context->allocations.end())
+            return nullptr;
+
+        VmaAllocation allocation = it->second;
+        globals::rhi_context->allocations.erase(it);
+        resource = texture->Get_Resource();
+        texture->Set_Resource(nullptr);
+
+        return allocation;
+    }
+
+    void image::destroy(void* resource, VmaAllocation allocation)
+    {
+        if (!resource || !allocation)
+            return;
+
+        vmaDestroyImage(globals::rhi_context->allocator, static_cast<VkImage>(resource), allocation);
     }
 
     VmaAllocation buffer::create(void*& _buffer, const uint64_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags memory_property_flags, const bool written_frequently /*= false*/, const void* data /*= nullptr*/)
@@ -202,4 +231,366 @@ namespace Spartan::vulkan_utility
             _buffer = nullptr;
         }
     }
+
+    bool upload::copy_to_buffer(void* dst_buffer, const void* data, const uint64_t size, const uint64_t dst_offset /*= 0*/)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        // Stage
+        void* src_buffer    = nullptr;
+        uint64_t src_offset = 0;
+        if (!allocate(data, size, 16, src_buffer, src_offset))
+            return false;
+
+        // Copy
+        VkBufferCopy copy_region    = {};
+        copy_region.srcOffset       = src_offset;
+        copy_region.dstOffset       = dst_offset;
+        copy_region.size            = size;
+        vkCmdCopyBuffer(static_cast<VkCommandBuffer>(m_batch.cmd_buffer), static_cast<VkBuffer>(src_buffer), static_cast<VkBuffer>(dst_buffer), 1, &copy_region);
+
+        return true;
+    }
+
+    bool upload::copy_to_image(RHI_Texture* texture, RHI_Image_Layout& texture_layout, const RHI_Image_Layout target_layout)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        if (texture->HasData())
+        {
+            const uint32_t width            = texture->GetWidth();
+            const uint32_t height           = texture->GetHeight();
+            const uint32_t array_size       = texture->GetArraySize();
+            const uint32_t mip_levels       = texture->GetMiplevels();
+            const uint32_t bytes_per_pixel  = texture->GetBytesPerPixel();
+
+            // Optimal layout for images which are the destination of a transfer format
+            if (!begin() || !image::set_layout(m_batch.cmd_buffer, texture, RHI_Image_Transfer_Dst_Optimal))
+                return false;
+
+            texture_layout = RHI_Image_Transfer_Dst_Optimal;
+
+            // Stage and copy every mip level of every array slice, a copy can end up in a later batch than
+            // the transition if the ring fills up in between, that's fine since batches execute in order.
+            for (uint32_t array_index = 0; array_index < array_size; array_index++)
+            {
+                for (uint32_t mip_index = 0; mip_index < mip_levels; mip_index++)
+                {
+                    const uint32_t mip_width    = (std::max)(width >> mip_index, 1u);
+                    const uint32_t mip_height   = (std::max)(height >> mip_index, 1u);
+                    const uint64_t size         = static_cast<uint64_t>(mip_width) * mip_height * bytes_per_pixel;
+
+                    const vector<std::byte>* data = texture->GetData(array_index * mip_levels + mip_index);
+                    if (!data || data->size() < size)
+                    {
+                        LOG_ERROR("Missing data for mip %d of array slice %d", mip_index, array_index);
+                        return false;
+                    }
+
+                    // Buffer offsets of image copies have to be a multiple of 4 and of the texel size
+                    void* src_buffer    = nullptr;
+                    uint64_t src_offset = 0;
+                    if (!allocate(data->data(), size, bytes_per_pixel * 4, src_buffer, src_offset))
+                        return false;
+
+                    VkBufferImageCopy region				= {};
+                    region.bufferOffset						= src_offset;
+                    region.bufferRowLength					= 0;
+                    region.bufferImageHeight				= 0;
+                    region.imageSubresource.aspectMask      = image::get_aspect_mask(texture);
+                    region.imageSubresource.mipLevel		= mip_index;
+                    region.imageSubresource.baseArrayLayer	= array_index;
+                    region.imageSubresource.layerCount		= 1;
+                    region.imageOffset						= { 0, 0, 0 };
+                    region.imageExtent						= { mip_width, mip_height, 1 };
+
+                    vkCmdCopyBufferToImage(
+                        static_cast<VkCommandBuffer>(m_batch.cmd_buffer),
+                        static_cast<VkBuffer>(src_buffer),
+                        static_cast<VkImage>(texture->Get_Resource()),
+                        vulkan_image_layout[texture_layout],
+                        1,
+                        &region
+                    );
+                }
+            }
+        }
+
+        // Transition to the layout the texture will be used with
+        if (!begin() || !image::set_layout(m_batch.cmd_buffer, texture, target_layout))
+            return false;
+
+        texture_layout = target_layout;
+
+        return true;
+    }
+
+    uint64_t upload::flush()
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        if (m_recording)
+        {
+            submit();
+        }
+
+        // Recycle whatever the GPU is done with
+        retire(false);
+
+        return m_batch_id - 1;
+    }
+
+    bool upload::is_complete(const uint64_t batch_id)
+    {
+        if (m_batch_id_complete.load(memory_order_acquire) >= batch_id)
+            return true;
+
+        lock_guard<mutex> lock(m_mutex);
+        retire(false);
+        return m_batch_id_complete.load(memory_order_acquire) >= batch_id;
+    }
+
+    bool upload::wait(const uint64_t batch_id)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        // The batch might still be recording
+        if (m_recording && batch_id >= m_batch_id)
+        {
+            if (!submit())
+                return false;
+        }
+
+        while (m_batch_id_complete.load(memory_order_acquire) < batch_id && !m_batches_in_flight.empty())
+        {
+            retire(true);
+        }
+
+        return m_batch_id_complete.load(memory_order_acquire) >= batch_id;
+    }
+
+    void upload::shutdown()
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        if (m_recording)
+        {
+            submit();
+        }
+
+        // Wait for the GPU
+        for (_batch& batch : m_batches_in_flight)
+        {
+            fence::wait(batch.fence);
+        }
+        retire(false);
+
+        // Release batches
+        for (_batch& batch : m_batches_free)
+        {
+            fence::destroy(batch.fence);
+            command_buffer::destroy(batch.cmd_pool, batch.cmd_buffer);
+            command_pool::destroy(batch.cmd_pool);
+        }
+        m_batches_free.clear();
+
+        // Release ring buffer
+        if (m_ring_buffer)
+        {
+            vmaUnmapMemory(globals::rhi_context->allocator, m_ring_allocation);
+            buffer::destroy(m_ring_buffer);
+            m_ring_allocation   = nullptr;
+            m_ring_mapped       = nullptr;
+        }
+        m_ring_head = 0;
+        m_ring_used = 0;
+    }
+
+    bool upload::initialise()
+    {
+        if (m_ring_buffer)
+            return true;
+
+        // Prefer the transfer queue, but only if it belongs to the graphics family. Otherwise every resource would need a queue
+        // family ownership transfer and the transfer queue wouldn't be able to transition images to layouts meant for shaders.
+        const bool transfer_is_graphics = globals::rhi_context->queue_transfer_index == globals::rhi_context->queue_graphics_index;
+        m_queue_type                    = transfer_is_graphics ? RHI_Queue_Transfer : RHI_Queue_Graphics;
+
+        // Create the ring buffer and keep it mapped
+        m_ring_allocation = buffer::create(m_ring_buffer, m_ring_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        if (!m_ring_allocation)
+        {
+            LOG_ERROR("Failed to create staging ring buffer");
+            return false;
+        }
+
+        void* mapped = nullptr;
+        if (!error::check(vmaMapMemory(globals::rhi_context->allocator, m_ring_allocation, &mapped)))
+        {
+            buffer::destroy(m_ring_buffer);
+            m_ring_allocation = nullptr;
+            return false;
+        }
+        m_ring_mapped = static_cast<std::byte*>(mapped);
+
+        debug::set_name(static_cast<VkBuffer>(m_ring_buffer), "staging_ring");
+
+        return true;
+    }
+
+    bool upload::begin()
+    {
+        if (m_recording)
+            return true;
+
+        if (!initialise())
+            return false;
+
+        // Reuse a batch which the GPU is done with, or create a new one
+        retire(false);
+        if (!m_batches_free.empty())
+        {
+            m_batch = move(m_batches_free.back());
+            m_batches_free.pop_back();
+        }
+        else
+        {
+            m_batch = _batch();
+
+            if (!command_pool::create(m_batch.cmd_pool, m_queue_type))
+                return false;
+
+            if (!command_buffer::create(m_batch.cmd_pool, m_batch.cmd_buffer, VK_COMMAND_BUFFER_LEVEL_PRIMARY))
+                return false;
+
+            if (!fence::create(m_batch.fence))
+                return false;
+        }
+
+        // Begin
+        VkCommandBufferBeginInfo begin_info = {};
+        begin_info.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (!error::check(vkBeginCommandBuffer(static_cast<VkCommandBuffer>(m_batch.cmd_buffer), &begin_info)))
+            return false;
+
+        m_batch.id          = m_batch_id;
+        m_batch.ring_bytes  = 0;
+        m_recording         = true;
+
+        return true;
+    }
+
+    bool upload::allocate(const void* data, const uint64_t size, const uint64_t alignment, void*& src_buffer, uint64_t& src_offset)
+    {
+        // Data which doesn't fit in the ring gets a staging buffer of its own, destroyed once the batch retires
+        if (size > m_ring_size)
+        {
+            if (!begin())
+                return false;
+
+            void* staging_buffer = nullptr;
+            if (!buffer::create(staging_buffer, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, false, data))
+                return false;
+
+            m_batch.staging_buffers.emplace_back(staging_buffer);
+            src_buffer = staging_buffer;
+            src_offset = 0;
+            return true;
+        }
+
+        while (true)
+        {
+            // Allocate after the head, or wrap around if there isn't enough space before the end of the ring
+            const uint64_t offset_aligned   = (m_ring_head + alignment - 1) / alignment * alignment;
+            const bool wrap                 = offset_aligned + size > m_ring_size;
+            const uint64_t offset           = wrap ? 0 : offset_aligned;
+            const uint64_t consumed         = wrap ? (m_ring_size - m_ring_head) + size : (offset_aligned - m_ring_head) + size;
+
+            if (m_ring_used + consumed <= m_ring_size)
+            {
+                if (!begin())
+                    return false;
+
+                memcpy(m_ring_mapped + offset, data, size);
+
+                m_ring_head         = offset + size;
+                m_ring_used        += consumed;
+                m_batch.ring_bytes += consumed;
+                src_buffer          = m_ring_buffer;
+                src_offset          = offset;
+                return true;
+            }
+
+            // The ring is full, submit what has been recorded so far and wait for the oldest batch to free up its part
+            if (m_recording && !submit())
+                return false;
+
+            retire(true);
+        }
+    }
+
+    bool upload::submit()
+    {
+        VkCommandBuffer cmd_buffer = static_cast<VkCommandBuffer>(m_batch.cmd_buffer);
+
+        // Make the copies visible to any work which is submitted afterwards
+        VkMemoryBarrier barrier = {};
+        barrier.sType           = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask   = VK_ACCESS_MEMORY_READ_BIT;
+        vkCmdPipelineBarrier(cmd_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        m_recording = false;
+
+        if (!error::check(vkEndCommandBuffer(cmd_buffer)))
+        {
+            LOG_ERROR("Failed to end command buffer");
+            return false;
+        }
+
+        if (!globals::rhi_device->Queue_Submit(m_queue_type, m_batch.cmd_buffer, nullptr, nullptr, m_batch.fence))
+        {
+            LOG_ERROR("Failed to submit to queue");
+            return false;
+        }
+
+        m_batches_in_flight.emplace_back(move(m_batch));
+        m_batch_id++;
+
+        return true;
+    }
+
+    void upload::retire(const bool wait_oldest)
+    {
+        if (wait_oldest && !m_batches_in_flight.empty())
+        {
+            fence::wait(m_batches_in_flight.front().fence);
+        }
+
+        // Batches complete in submission order
+        while (!m_batches_in_flight.empty() && fence::is_signaled(m_batches_in_flight.front().fence))
+        {
+            _batch& batch = m_batches_in_flight.front();
+
+            for (void*& staging_buffer : batch.staging_buffers)
+            {
+                buffer::destroy(staging_buffer);
+            }
+            batch.staging_buffers.clear();
+            fence::reset(batch.fence);
+
+            m_ring_used -= batch.ring_bytes;
+            m_batch_id_complete.store(batch.id, memory_order_release);
+
+            m_batches_free.emplace_back(move(batch));
+            m_batches_in_flight.pop_front();
+        }
+
+        // Nothing uses the ring, start from the beginning
+        if (m_ring_used == 0)
+        {
+            m_ring_head = 0;
+        }
+    }
 }
@@ -30,8 +30,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Logging/Log.h"
 #include "../../Math/Vector4.h"
 #include <array>
+#include <deque>
 #include <unordered_map>
 #include <atomic>
+#include <mutex>
 //===================================
 
 namespace Spartan::vulkan_utility
@@ -542,6 +544,10 @@ namespace Spartan::vulkan_utility
 
         void destroy(RHI_Texture* texture);
 
+        // Takes the image (and its allocation) away from the texture, so that it can be destroyed independently of it
+        VmaAllocation detach(RHI_Texture* texture, void*& resource);
+        void destroy(void* resource, VmaAllocation allocation);
+
         inline VkPipelineStageFlags access_flags_to_pipeline_stage(VkAccessFlags access_flags, const VkPipelineStageFlags enabled_graphics_shader_stages)
         {
             VkPipelineStageFlags stages = 0;
@@ -835,6 +841,62 @@ namespace Spartan::vulkan_utility
         }
     }
 
+    // Thread-safe uploader which copies data to device local resources through a persistent staging ring buffer.
+    // Copies are recorded into a shared command buffer (a batch) which is submitted when the ring fills up, or when
+    // flush() is called (command lists call it before they submit). Since batches go to a queue of the graphics family,
+    // anything submitted afterwards sees the uploaded data, a batch's fence only decides when its part of the ring can be reused.
+    class upload
+    {
+    public:
+        // Copies data into a buffer (which must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        static bool copy_to_buffer(void* dst_buffer, const void* data, const uint64_t size, const uint64_t dst_offset = 0);
+
+        // Copies the texture's data (if any) into its image, then transitions it to target_layout
+        static bool copy_to_image(RHI_Texture* texture, RHI_Image_Layout& texture_layout, const RHI_Image_Layout target_layout);
+
+        // Submits the batch which is being recorded, if any, and returns its id
+        static uint64_t flush();
+
+        // A batch is complete once the GPU has executed it
+        static bool is_complete(const uint64_t batch_id);
+        static bool wait(const uint64_t batch_id);
+
+        // Waits for all batches and releases everything, has to happen before the device goes away
+        static void shutdown();
+
+    private:
+        struct _batch
+        {
+            uint64_t id             = 0;
+            void* cmd_pool          = nullptr;
+            void* cmd_buffer        = nullptr;
+            void* fence             = nullptr;
+            uint64_t ring_bytes     = 0;                // ring memory consumed by this batch, including wrap-around padding
+            std::vector<void*> staging_buffers;         // dedicated staging buffers, for data larger than the ring
+        };
+
+        static bool initialise();
+        static bool begin();
+        static bool allocate(const void* data, const uint64_t size, const uint64_t alignment, void*& src_buffer, uint64_t& src_offset);
+        static bool submit();
+        static void retire(const bool wait_oldest);
+
+        static std::mutex m_mutex;
+        static _batch m_batch;                          // the batch which is being recorded
+        static bool m_recording;
+        static std::deque<_batch> m_batches_in_flight;  // oldest first
+        static std::vector<_batch> m_batches_free;
+        static uint64_t m_batch_id;                     // id of the next batch to be submitted
+        static std::atomic<uint64_t> m_batch_id_complete;
+        static RHI_Queue_Type m_queue_type;
+        static void* m_ring_buffer;
+        static VmaAllocation m_ring_allocation;
+        static std::byte* m_ring_mapped;
+        static uint64_t m_ring_size;
+        static uint64_t m_ring_head;
+        static uint64_t m_ring_used;
+    };
+
     namespace surface
     {
         inline VkSurfaceCapabilitiesKHR capabilities(const VkSurfaceKHR surface)
@@ -197,6 +197,16 @@ namespace Spartan
 		return m_textures.at(type)->GetResourceFilePathNative();
 	}
 
+    RHI_Texture* Material::GetTexture_Ptr(const Material_Property type)
+    {
+        if (!HasTexture(type))
+            return nullptr;
+
+        // Textures which are still streaming in (or failed to load) have no GPU resource, so they are treated as missing
+        RHI_Texture* texture = m_textures[type].get();
+        return (texture && texture->GetLoadState() == LoadState_Completed) ? texture : nullptr;
+    }
+
 	vector<string> Material::GetTexturePaths()
 	{
 		vector<string> paths;
@@ -223,6 +233,11 @@ namespace Spartan
         // goes through the entities and makes the ones that use this material, render in the correct mode.
         if ((m_color_albedo.w != 1.0f && color.w == 1.0f) || (m_color_albedo.w == 1.0f && color.w != 1.0f))
         {
+            if (Renderer* renderer = m_context->GetSubsystem<Renderer>())
+            {
+                renderer->OnMaterialTransparencyChanged(this);
+            }
+
             m_context->GetSubsystem<World>()->MakeDirty();
         }
 
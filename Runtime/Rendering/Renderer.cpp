@@ -24,12 +24,18 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer.h"
 #include "Model.h"
 #include "ShaderGBuffer.h"
+#include "ShaderLight.h"
+#include "ShaderCompileQueue.h"
+#include "TextureStreamer.h"
 #include "Font/Font.h"
 #include "Gizmos/Grid.h"
 #include "Gizmos/Transform_Gizmo.h"
 #include "../Utilities/Sampling.h"
+#include "../Utilities/Sort.h"
 #include "../Profiling/Profiler.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -51,6 +57,41 @@ using namespace std;
 using namespace Spartan::Math;
 //============================
 
+namespace _sort_key
+{
+    // Bits per field, most significant first
+    static const uint32_t bits_pass         = 2;
+    static const uint32_t bits_variation    = 14;
+    static const uint32_t bits_material     = 14;
+    static const uint32_t bits_geometry     = 10;
+    static const uint32_t bits_depth        = 24;
+
+    // Positive floats order the same way as their bit patterns, so dropping the low mantissa bits quantizes without needing a range
+    static uint64_t depth(const float distance_squared, const bool back_to_front)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &distance_squared, sizeof(float));
+        const uint32_t depth = (bits >> (31 - bits_depth)) & ((1u << bits_depth) - 1);
+        return back_to_front ? (~depth & ((1u << bits_depth) - 1)) : depth;
+    }
+
+    // Indices which don't fit are clamped, that only costs some redundant state changes
+    static uint64_t field(const uint32_t value, const uint32_t bits)
+    {
+        return (std::min)(value, (1u << bits) - 1);
+    }
+
+    static uint64_t pack(const uint32_t pass, const uint32_t variation, const uint32_t material, const uint32_t geometry, const uint64_t depth)
+    {
+        uint64_t key = field(pass, bits_pass);
+        key = (key << bits_variation)   | field(variation, bits_variation);
+        key = (key << bits_material)    | field(material, bits_material);
+        key = (key << bits_geometry)    | field(geometry, bits_geometry);
+        key = (key << bits_depth)       | depth;
+        return key;
+    }
+}
+
 namespace Spartan
 {
     Renderer::Renderer(Context* context) : ISubsystem(context)
@@ -81,18 +122,29 @@ namespace Spartan
         m_option_values[Option_Value_Bloom_Intensity]   = 0.1f;
 
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Complete,    EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Complete,    EVENT_HANDLER(RenderablesAcquire));
         SUBSCRIBE_TO_EVENT(Event_World_Unload,              EVENT_HANDLER(ClearEntities));
+        SUBSCRIBE_TO_EVENT(Event_World_Loaded,              EVENT_HANDLER(ShaderVariationsPrecompile));
 	}
 
 	Renderer::~Renderer()
 	{
 		// Unsubscribe from events
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Resolve_Complete, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Resolve_Complete, EVENT_HANDLER(RenderablesAcquire));
+        UNSUBSCRIBE_FROM_EVENT(Event_World_Loaded, EVENT_HANDLER(ShaderVariationsPrecompile));
+
+        // Compilations in flight reference their shaders, so let them finish first
+        m_shader_compile_queue.reset();
+
+        // Same goes for texture reads
+        m_texture_streamer.reset();
 
 		m_entities.clear();
 		m_camera = nullptr;
 
+        // The jobs' command lists wait for the GPU when destroyed, so they have to go before the device does
+        m_record_jobs.clear();
+
 		// Log to file as the renderer is no more
 		LOG_TO_FILE(true);
 	}
@@ -102,6 +154,7 @@ namespace Spartan
         // Get required systems		
         m_resource_cache    = m_context->GetSubsystem<ResourceCache>();
         m_profiler          = m_context->GetSubsystem<Profiler>();
+        m_threading         = m_context->GetSubsystem<Threading>();
 
         // Resolution, viewport and swapchain default to whatever the window size is
         const WindowData& window_data = m_context->m_engine->GetWindowData();
@@ -159,6 +212,12 @@ namespace Spartan
         m_gizmo_grid = make_unique<Grid>(m_rhi_device);
         m_gizmo_transform = make_unique<Transform_Gizmo>(m_context);
 
+        // Shader compile queue, the shaders below and any variations compile through it
+        m_shader_compile_queue = make_unique<ShaderCompileQueue>(m_context);
+
+        // Texture streamer, native textures which load from now on start with their least detailed mips
+        m_texture_streamer = make_unique<TextureStreamer>(m_context);
+
         CreateConstantBuffers();
 		CreateShaders();
 		CreateDepthStencilStates();
@@ -207,13 +266,29 @@ namespace Spartan
 			return;
 		}
 
+        // Resolve any transforms which changed since World::Tick() (e.g. by the editor, or because the world isn't ticking),
+        // so that visibility, streaming and command recording below only read them, some of which do so in parallel.
+        for (const auto& it : m_entities)
+        {
+            for (Entity* entity : it.second)
+            {
+                entity->GetTransform()->UpdateTransform();
+            }
+        }
+
         // Reset dynamic buffer indices when the swapchain resets to first buffer/command list
         if (m_swap_chain->GetCmdIndex() == 0)
         {
             m_buffer_uber_offset_index      = 0;
             m_buffer_object_offset_index    = 0;
+            m_buffer_instance_offset_index  = 0;
         }
 
+        // Stream texture mips for what was visible last frame
+        m_texture_streamer->RequestMips(m_camera.get(), m_visible_camera.opaque, m_resolution.y);
+        m_texture_streamer->RequestMips(m_camera.get(), m_visible_camera.transparent, m_resolution.y);
+        m_texture_streamer->Tick();
+
 		// Get camera matrices
 		{
             if (m_update_ortho_proj || m_near_plane != m_camera->GetNearPlane() || m_far_plane != m_camera->GetFarPlane())
@@ -496,7 +571,7 @@ namespace Spartan
         return buffer_gpu->Unmap(offset, size);
     }
 
-    bool Renderer::UpdateUberBuffer(RHI_CommandList* cmd_list)
+    bool Renderer::UpdateUberBuffer(RHI_CommandList* cmd_list, _record_job* job /*= nullptr*/)
     {
         if (!cmd_list)
         {
@@ -504,14 +579,16 @@ namespace Spartan
             return false;
         }
 
-        if (!update_dynamic_buffer<BufferUber>(cmd_list, m_buffer_uber_gpu.get(), m_buffer_uber_cpu, m_buffer_uber_cpu_previous, m_buffer_uber_offset_index))
+        // Jobs update their own buffer, so that they don't race each other for offsets
+        RHI_ConstantBuffer* buffer_gpu = job ? job->buffer_uber_gpu.get() : m_buffer_uber_gpu.get();
+        if (!update_dynamic_buffer<BufferUber>(cmd_list, buffer_gpu, job ? job->buffer_uber_cpu : m_buffer_uber_cpu, job ? job->buffer_uber_cpu_previous : m_buffer_uber_cpu_previous, job ? job->buffer_uber_offset_index : m_buffer_uber_offset_index))
             return false;
 
         // Dynamic buffers with offsets have to be rebound whenever the offset changes
-        return cmd_list->SetConstantBuffer(2, RHI_Shader_Pixel | RHI_Shader_Vertex, m_buffer_uber_gpu);
+        return cmd_list->SetConstantBuffer(2, RHI_Shader_Pixel | RHI_Shader_Vertex, buffer_gpu);
 	}
 
-    bool Renderer::UpdateObjectBuffer(RHI_CommandList* cmd_list)
+    bool Renderer::UpdateObjectBuffer(RHI_CommandList* cmd_list, _record_job* job /*= nullptr*/)
     {
         if (!cmd_list)
         {
@@ -519,11 +596,28 @@ namespace Spartan
             return false;
         }
 
-        if (!update_dynamic_buffer<BufferObject>(cmd_list, m_buffer_object_gpu.get(), m_buffer_object_cpu, m_buffer_object_cpu_previous, m_buffer_object_offset_index))
+        RHI_ConstantBuffer* buffer_gpu = job ? job->buffer_object_gpu.get() : m_buffer_object_gpu.get();
+        if (!update_dynamic_buffer<BufferObject>(cmd_list, buffer_gpu, job ? job->buffer_object_cpu : m_buffer_object_cpu, job ? job->buffer_object_cpu_previous : m_buffer_object_cpu_previous, job ? job->buffer_object_offset_index : m_buffer_object_offset_index))
             return false;
 
         // Dynamic buffers with offsets have to be rebound whenever the offset changes
-        return cmd_list->SetConstantBuffer(3, RHI_Shader_Vertex, m_buffer_object_gpu);
+        return cmd_list->SetConstantBuffer(3, RHI_Shader_Vertex, buffer_gpu);
+    }
+
+    bool Renderer::UpdateInstanceBuffer(RHI_CommandList* cmd_list, _record_job* job /*= nullptr*/)
+    {
+        if (!cmd_list)
+        {
+            LOG_ERROR("Invalid command list");
+            return false;
+        }
+
+        RHI_ConstantBuffer* buffer_gpu = job ? job->buffer_instance_gpu.get() : m_buffer_instance_gpu.get();
+        if (!update_dynamic_buffer<BufferInstance>(cmd_list, buffer_gpu, job ? job->buffer_instance_cpu : m_buffer_instance_cpu, job ? job->buffer_instance_cpu_previous : m_buffer_instance_cpu_previous, job ? job->buffer_instance_offset_index : m_buffer_instance_offset_index))
+            return false;
+
+        // Dynamic buffers with offsets have to be rebound whenever the offset changes
+        return cmd_list->SetConstantBuffer(5, RHI_Shader_Vertex, buffer_gpu);
     }
 
     bool Renderer::UpdateLightBuffer(const Light* light)
@@ -561,73 +655,509 @@ namespace Spartan
         return m_buffer_light_gpu->Unmap();
     }
 
-	void Renderer::RenderablesAcquire(const Variant& entities_variant)
+    void Renderer::OnMaterialTransparencyChanged(const Material* material)
+    {
+        // Materials can be loaded (and modified) by worker threads
+        lock_guard<mutex> lock(m_mutex_materials_changed);
+        m_materials_changed.insert(material);
+    }
+
+	void Renderer::RenderablesAcquire()
 	{
         SCOPED_TIME_BLOCK(m_profiler);
 
-		// Clear previous state
-		m_entities.clear();
-		m_camera = nullptr;
+        World* world                            = m_context->GetSubsystem<World>();
+        const vector<Entity*>& entities_changed = world->EntityGetChanged();
+        const vector<Entity*>& entities_removed = world->EntityGetRemoved();
 
-		vector<shared_ptr<Entity>> entities = entities_variant.Get<vector<shared_ptr<Entity>>>();
-		for (const auto& entity : entities)
-		{
-			if (!entity || !entity->IsActive())
-				continue;
+        unordered_set<const Material*> materials_changed;
+        {
+            lock_guard<mutex> lock(m_mutex_materials_changed);
+            materials_changed.swap(m_materials_changed);
+        }
+
+        // Without any deltas, the world was made dirty for reasons we can't narrow down (or it's the first resolve), so start over
+        if (!m_entities_registered || (entities_changed.empty() && entities_removed.empty() && materials_changed.empty()))
+        {
+            RenderablesRebuild();
+            return;
+        }
 
-			// Get all the components we are interested in
+        // Everything that changed is unregistered and then registered again, removed entities are only unregistered
+        unordered_set<Entity*> entities_dirty;
+        entities_dirty.insert(entities_removed.begin(), entities_removed.end());
+        entities_dirty.insert(entities_changed.begin(), entities_changed.end());
+
+        // Entities using a material which switched between opaque and transparent have to move to the other registry
+        if (!materials_changed.empty())
+        {
+            for (const auto& it : m_entity_proxies)
+            {
+                if (it.second.is_renderable && materials_changed.count(it.second.material))
+                {
+                    entities_dirty.insert(it.first);
+                }
+            }
+        }
+
+        RenderablesUnregister(entities_dirty);
+
+        // Register what still exists
+        for (Entity* entity : entities_removed)
+        {
+            entities_dirty.erase(entity);
+        }
+        for (Entity* entity : entities_dirty)
+        {
+            RenderablesRegister(entity);
+        }
+	}
+
+    void Renderer::RenderablesRebuild()
+    {
+        // Clear previous state
+        m_entities.clear();
+        m_entity_proxies.clear();
+        m_visible_light_slices.clear();
+        m_camera = nullptr;
+
+        for (const auto& entity : m_context->GetSubsystem<World>()->EntityGetAll())
+        {
+            if (!entity || !entity->IsActive())
+                continue;
+
+            // Get all the components we are interested in
             Renderable* renderable  = entity->GetComponent<Renderable>();
             Light* light            = entity->GetComponent<Light>();
             Camera* camera          = entity->GetComponent<Camera>();
 
-			if (renderable)
-			{
-                bool is_transparent = false;
+            if (!renderable && !light && !camera)
+                continue;
 
-                if (const Material* material = renderable->GetMaterial())
+            _entity_proxy& proxy = m_entity_proxies[entity.get()];
+
+            if (renderable)
+            {
+                proxy.is_renderable     = true;
+                proxy.material          = renderable->GetMaterial();
+                proxy.is_transparent    = proxy.material && proxy.material->GetColorAlbedo().w < 1.0f;
+
+                m_entities[proxy.is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity.get());
+            }
+
+            if (light)
+            {
+                proxy.light = light;
+                m_entities[Renderer_Object_Light].emplace_back(entity.get());
+            }
+
+            if (camera)
+            {
+                proxy.is_camera = true;
+                m_entities[Renderer_Object_Camera].emplace_back(entity.get());
+                m_camera = camera->GetPtrShared<Camera>();
+            }
+        }
+
+        m_entities_registered = true;
+    }
+
+    void Renderer::RenderablesRegister(Entity* entity)
+    {
+        if (!entity->IsActive())
+            return;
+
+        Renderable* renderable  = entity->GetComponent<Renderable>();
+        Light* light            = entity->GetComponent<Light>();
+        Camera* camera          = entity->GetComponent<Camera>();
+
+        if (!renderable && !light && !camera)
+            return;
+
+        _entity_proxy& proxy = m_entity_proxies[entity];
+
+        if (renderable)
+        {
+            proxy.is_renderable     = true;
+            proxy.material          = renderable->GetMaterial();
+            proxy.is_transparent    = proxy.material && proxy.material->GetColorAlbedo().w < 1.0f;
+
+            m_entities[proxy.is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity);
+        }
+
+        if (light)
+        {
+            proxy.light = light;
+            m_entities[Renderer_Object_Light].emplace_back(entity);
+        }
+
+        if (camera)
+        {
+            proxy.is_camera = true;
+            m_entities[Renderer_Object_Camera].emplace_back(entity);
+            m_camera = camera->GetPtrShared<Camera>();
+        }
+    }
+
+    void Renderer::RenderablesUnregister(const unordered_set<Entity*>& entities)
+    {
+        // Only the proxies are looked at, removed entities are already destroyed
+        bool is_registered[Renderer_Object_Camera + 1] = { false };
+        for (Entity* entity : entities)
+        {
+            auto it = m_entity_proxies.find(entity);
+            if (it == m_entity_proxies.end())
+                continue;
+
+            const _entity_proxy& proxy = it->second;
+            if (proxy.is_renderable)
+            {
+                is_registered[proxy.is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque] = true;
+            }
+
+            if (proxy.light)
+            {
+                is_registered[Renderer_Object_Light] = true;
+                m_visible_light_slices.erase(proxy.light);
+            }
+
+            if (proxy.is_camera)
+            {
+                is_registered[Renderer_Object_Camera] = true;
+                if (m_camera && m_camera->GetEntity() == entity)
                 {
-                    is_transparent = material->GetColorAlbedo().w < 1.0f;
+                    m_camera = nullptr;
                 }
+            }
 
-                m_entities[is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity.get());
-			}
+            m_entity_proxies.erase(it);
+        }
 
-			if (light)
-			{
-				m_entities[Renderer_Object_Light].emplace_back(entity.get());
-			}
+        // A single pass over each affected registry, the relative order of the remaining entities is preserved
+        for (const Renderer_Object_Type object_type : { Renderer_Object_Opaque, Renderer_Object_Transparent, Renderer_Object_Light, Renderer_Object_Camera })
+        {
+            if (!is_registered[object_type])
+                continue;
 
-			if (camera)
-			{
-				m_entities[Renderer_Object_Camera].emplace_back(entity.get());
-				m_camera = camera->GetPtrShared<Camera>();
-			}
-		}
+            vector<Entity*>& registry = m_entities[object_type];
+            registry.erase(remove_if(registry.begin(), registry.end(), [&entities](Entity* entity) { return entities.count(entity) != 0; }), registry.end());
+        }
 
-		RenderablesSort(&m_entities[Renderer_Object_Opaque]);
-		RenderablesSort(&m_entities[Renderer_Object_Transparent]);
-	}
+        // Fall back to any other camera
+        if (!m_camera && !m_entities[Renderer_Object_Camera].empty())
+        {
+            m_camera = m_entities[Renderer_Object_Camera].back()->GetComponent<Camera>()->GetPtrShared<Camera>();
+        }
+    }
 
-	void Renderer::RenderablesSort(vector<Entity*>* renderables)
-	{
-		if (!m_camera || renderables->size() <= 2)
-			return;
+    void Renderer::VisibilityCompute()
+    {
+        SCOPED_TIME_BLOCK(m_profiler);
 
-		auto comparison_op = [this](Entity* entity)
-		{
-			auto renderable = entity->GetRenderable();
-			if (!renderable)
-				return 0.0f;
+        // Clear the previous frame's lists (their memory is kept around)
+        m_visible_camera.Clear();
+        m_visible_camera_draws.Clear();
+        m_sort_material_indices.clear();
+        m_sort_geometry_indices.clear();
+        for (auto& it : m_visible_light_slices)
+        {
+            for (_visible_entities& slice : it.second)
+            {
+                slice.Clear();
+            }
+        }
 
-			return (renderable->GetAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
-		};
+        if (!m_camera)
+            return;
 
-		// Sort by depth (front to back)
-		sort(renderables->begin(), renderables->end(), [&comparison_op](Entity* a, Entity* b)
-		{
-            return comparison_op(a) < comparison_op(b);
-		});
-	}
+        // Views - The camera comes first, followed by every shadow slice of every shadow casting light
+        struct view_light
+        {
+            const Light* light;
+            uint32_t slice;
+            _visible_entities* visible;
+        };
+        vector<view_light> views_light;
+        for (Entity* entity : m_entities[Renderer_Object_Light])
+        {
+            const Light* light = entity->GetComponent<Light>();
+            if (!light || !light->GetShadowsEnabled() || !light->GetDepthTexture())
+                continue;
+
+            vector<_visible_entities>& slices = m_visible_light_slices[light];
+            slices.resize(light->GetShadowArraySize());
+            for (uint32_t i = 0; i < static_cast<uint32_t>(slices.size()); i++)
+            {
+                views_light.push_back({ light, i, &slices[i] });
+            }
+        }
+        const uint32_t view_count       = static_cast<uint32_t>(views_light.size()) + 1;
+        const Vector3 position_camera   = m_camera->GetTransform()->GetPosition();
+
+        // Per entity flags
+        const uint8_t flag_drawable         = 1 << 0;
+        const uint8_t flag_shadow_caster    = 1 << 1;
+
+        for (const Renderer_Object_Type object_type : { Renderer_Object_Opaque, Renderer_Object_Transparent })
+        {
+            const vector<Entity*>& entities = m_entities[object_type];
+            const uint32_t entity_count     = static_cast<uint32_t>(entities.size());
+            const uint32_t block_count      = (entity_count + 31) / 32;
+            const bool is_transparent       = object_type == Renderer_Object_Transparent;
+
+            // Gather the bounding boxes - Renderable::GetAabb() updates lazily, so each entity is only touched by one thread
+            m_visibility_boxes.Resize(entity_count);
+            m_visibility_flags.assign(entity_count, 0);
+            m_threading->ParallelFor(0, entity_count, 256, [&](uint32_t start, uint32_t end)
+            {
+                for (uint32_t i = start; i < end; i++)
+                {
+                    Renderable* renderable = entities[i]->GetRenderable();
+                    if (!renderable)
+                        continue;
+
+                    const Model* model = renderable->GeometryModel();
+                    if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
+                        continue;
+
+                    m_visibility_boxes.Set(i, renderable->GetAabb());
+                    m_visibility_flags[i] = flag_drawable | ((renderable->GetCastShadows() && renderable->GetMaterial()) ? flag_shadow_caster : 0);
+                }
+            });
+
+            // Cull - 32 entities at a time against every view, producing one mask per view
+            m_visibility_masks.assign(static_cast<size_t>(block_count) * view_count, 0);
+            m_threading->ParallelFor(0, block_count, 4, [&](uint32_t start, uint32_t end)
+            {
+                for (uint32_t block = start; block < end; block++)
+                {
+                    const uint32_t offset = block * 32;
+
+                    uint32_t mask_drawable      = 0;
+                    uint32_t mask_shadow_caster = 0;
+                    for (uint32_t i = 0; i < 32 && offset + i < entity_count; i++)
+                    {
+                        const uint8_t flags = m_visibility_flags[offset + i];
+                        mask_drawable       |= ((flags & flag_drawable) ? 1u : 0u) << i;
+                        mask_shadow_caster  |= ((flags & flag_shadow_caster) ? 1u : 0u) << i;
+                    }
+
+                    uint32_t* masks = &m_visibility_masks[static_cast<size_t>(block) * view_count];
+
+                    if (mask_drawable)
+                    {
+                        masks[0] = m_camera->IsInViewFrustrum(m_visibility_boxes, offset) & mask_drawable;
+                    }
+
+                    if (mask_shadow_caster)
+                    {
+                        for (uint32_t view_index = 1; view_index < view_count; view_index++)
+                        {
+                            const view_light& view = views_light[view_index - 1];
+
+                            // Skip lights that don't cast transparent shadows
+                            if (is_transparent && !view.light->GetShadowsTransparentEnabled())
+                                continue;
+
+                            masks[view_index] = view.light->IsInViewFrustrum(m_visibility_boxes, offset, view.slice) & mask_shadow_caster;
+                        }
+                    }
+                }
+            });
+
+            // Fill the lists, camera visible entities get a depth key (for the depth based passes) and a draw key (for the G-Buffer)
+            m_sort_depth.clear();
+            vector<_draw_item>& draws = m_visible_camera_draws.Get(object_type);
+            for (uint32_t block = 0; block < block_count; block++)
+            {
+                const uint32_t offset   = block * 32;
+                const uint32_t* masks   = &m_visibility_masks[static_cast<size_t>(block) * view_count];
+
+                for (uint32_t i = 0; i < 32 && (masks[0] >> i) != 0; i++)
+                {
+                    if (!(masks[0] & (1u << i)))
+                        continue;
+
+                    const uint32_t index    = offset + i;
+                    Entity* entity          = entities[index];
+                    const float distance    = (Vector3(m_visibility_boxes.center_x[index], m_visibility_boxes.center_y[index], m_visibility_boxes.center_z[index]) - position_camera).LengthSquared();
+                    m_sort_depth.push_back({ _sort_key::depth(distance, false), entity });
+
+                    // Skip objects without a material or transparent objects that won't contribute
+                    const Renderable* renderable    = entity->GetRenderable();
+                    const Material* material        = renderable->GetMaterial();
+                    if (material && !(is_transparent && material->GetColorAlbedo().w == 0.0f))
+                    {
+                        // Materials and geometry get small indices in the order they are first seen
+                        const uint32_t material_index   = m_sort_material_indices.emplace(material->GetId(), static_cast<uint32_t>(m_sort_material_indices.size())).first->second;
+                        const uint32_t geometry_index   = GeometryIndex(renderable);
+                        const uint64_t depth            = _sort_key::depth(distance, is_transparent);
+
+                        draws.push_back({ _sort_key::pack(is_transparent ? 1 : 0, material->GetFlags(), material_index, geometry_index, depth), entity });
+                    }
+                }
+
+                for (uint32_t view_index = 1; view_index < view_count; view_index++)
+                {
+                    vector<Entity*>& visible = views_light[view_index - 1].visible->Get(object_type);
+                    for (uint32_t i = 0; i < 32 && (masks[view_index] >> i) != 0; i++)
+                    {
+                        if (masks[view_index] & (1u << i))
+                        {
+                            visible.emplace_back(entities[offset + i]);
+
+                            // Register the geometry here, so that the shadow jobs only have to look it up
+                            GeometryIndex(entities[offset + i]->GetRenderable());
+                        }
+                    }
+                }
+            }
+
+            // Sort front to back
+            Utility::Sort::Radix(m_sort_depth, m_sort_scratch, m_threading);
+            vector<Entity*>& visible_camera = m_visible_camera.Get(object_type);
+            visible_camera.reserve(m_sort_depth.size());
+            for (const _draw_item& item : m_sort_depth)
+            {
+                visible_camera.emplace_back(item.entity);
+            }
+
+            // Sort the draws, so that every shader variation, material and geometry gets bound once
+            Utility::Sort::Radix(draws, m_sort_scratch, m_threading);
+        }
+    }
+
+    uint32_t Renderer::GeometryIndex(const Renderable* renderable)
+    {
+        // Sub-meshes share the model's buffers, so the index range is part of the geometry
+        const uint64_t geometry = (static_cast<uint64_t>(renderable->GeometryModel()->GetId()) << 32) | renderable->GeometryIndexOffset();
+        return m_sort_geometry_indices.emplace(geometry, static_cast<uint32_t>(m_sort_geometry_indices.size())).first->second;
+    }
+
+    uint32_t Renderer::GeometryIndexFind(const Renderable* renderable) const
+    {
+        // Read only, so it's safe to call from the record jobs. Unknown geometry gets an index past every known one,
+        // which only affects its sort order, draw groups still compare the actual geometry.
+        const uint64_t geometry = (static_cast<uint64_t>(renderable->GeometryModel()->GetId()) << 32) | renderable->GeometryIndexOffset();
+        const auto it = m_sort_geometry_indices.find(geometry);
+        return it != m_sort_geometry_indices.end() ? it->second : static_cast<uint32_t>(m_sort_geometry_indices.size());
+    }
+
+    void Renderer::DrawItemsByGeometry(const vector<Entity*>& entities, vector<_draw_item>* draws, _record_job* job /*= nullptr*/)
+    {
+        // The sort is stable, so the entities of each geometry keep their relative order
+        draws->clear();
+        draws->reserve(entities.size());
+        for (Entity* entity : entities)
+        {
+            draws->push_back({ job ? GeometryIndexFind(entity->GetRenderable()) : GeometryIndex(entity->GetRenderable()), entity });
+        }
+
+        // Jobs already run on a worker thread, so they sort serially with their own scratch memory
+        if (job)
+        {
+            Utility::Sort::Radix(*draws, job->sort_scratch, nullptr);
+        }
+        else
+        {
+            Utility::Sort::Radix(*draws, m_sort_scratch, m_threading);
+        }
+    }
+
+    void Renderer::DrawGroupsBuild(const vector<_draw_item>& draws, const bool match_material, vector<_draw_group>* groups) const
+    {
+        groups->clear();
+
+        const uint32_t draw_count = static_cast<uint32_t>(draws.size());
+        for (uint32_t start = 0; start < draw_count;)
+        {
+            const Renderable* renderable = draws[start].entity->GetRenderable();
+
+            uint32_t end = start + 1;
+            while (end < draw_count && end - start < m_max_instances)
+            {
+                const Renderable* other = draws[end].entity->GetRenderable();
+
+                const bool same_geometry =
+                    other->GeometryModel()          == renderable->GeometryModel()          &&
+                    other->GeometryIndexOffset()    == renderable->GeometryIndexOffset()    &&
+                    other->GeometryIndexCount()     == renderable->GeometryIndexCount()     &&
+                    other->GeometryVertexOffset()   == renderable->GeometryVertexOffset();
+
+                if (!same_geometry || (match_material && other->GetMaterial() != renderable->GetMaterial()))
+                    break;
+
+                end++;
+            }
+
+            groups->push_back({ start, end - start });
+            start = end;
+        }
+    }
+
+    void Renderer::DrawGroup(RHI_CommandList* cmd_list, const vector<_draw_item>& draws, const _draw_group& group, const bool instanced, const Matrix& view_projection, const bool velocity, _record_job* job /*= nullptr*/)
+    {
+        BufferInstance& buffer_instance_cpu = job ? job->buffer_instance_cpu : m_buffer_instance_cpu;
+        BufferObject& buffer_object_cpu     = job ? job->buffer_object_cpu : m_buffer_object_cpu;
+
+        const Renderable* renderable    = draws[group.start].entity->GetRenderable();
+        const Model* model              = renderable->GeometryModel();
+
+        // Set geometry (will only happen if not already set)
+        cmd_list->SetBufferIndex(model->GetIndexBuffer());
+        cmd_list->SetBufferVertex(model->GetVertexBuffer());
+
+        if (instanced)
+        {
+            for (uint32_t i = 0; i < group.count; i++)
+            {
+                Transform* transform = draws[group.start + i].entity->GetTransform();
+
+                if (velocity)
+                {
+                    buffer_instance_cpu.transform[i]      = transform->GetMatrix();
+                    buffer_instance_cpu.wvp_previous[i]   = transform->GetWvpLastFrame();
+
+                    // Save matrix for velocity computation
+                    transform->SetWvpLastFrame(transform->GetMatrix() * view_projection);
+                }
+                else
+                {
+                    buffer_instance_cpu.transform[i] = transform->GetMatrix() * view_projection;
+                }
+            }
+
+            if (!UpdateInstanceBuffer(cmd_list, job))
+                return;
+
+            cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset(), group.count);
+            return;
+        }
+
+        for (uint32_t i = 0; i < group.count; i++)
+        {
+            Transform* transform = draws[group.start + i].entity->GetTransform();
+
+            if (velocity)
+            {
+                buffer_object_cpu.object          = transform->GetMatrix();
+                buffer_object_cpu.wvp_current     = transform->GetMatrix() * view_projection;
+                buffer_object_cpu.wvp_previous    = transform->GetWvpLastFrame();
+
+                // Save matrix for velocity computation
+                transform->SetWvpLastFrame(buffer_object_cpu.wvp_current);
+            }
+            else
+            {
+                buffer_object_cpu.object = transform->GetMatrix() * view_projection;
+            }
+
+            if (!UpdateObjectBuffer(cmd_list, job))
+                continue;
+
+            cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+        }
+    }
 
     void Renderer::ClearEntities()
     {
@@ -641,6 +1171,33 @@ namespace Spartan
         }
 
         m_entities.clear();
+        m_entity_proxies.clear();
+        m_entities_registered = false;
+        m_visible_camera.Clear();
+        m_visible_camera_draws.Clear();
+        m_visible_light_slices.clear();
+        m_texture_streamer->Clear();
+    }
+
+    void Renderer::ShaderVariationsPrecompile()
+    {
+        // Queue the variations which the loaded world uses ahead of anything else, materials request theirs
+        // while loading but at normal priority, so those get promoted, and lights only request theirs when drawn.
+        for (const shared_ptr<Entity>& entity : m_context->GetSubsystem<World>()->EntityGetAll())
+        {
+            if (const Renderable* renderable = entity->GetRenderable())
+            {
+                if (const Material* material = renderable->GetMaterial())
+                {
+                    ShaderGBuffer::GenerateVariation(m_context, material->GetFlags(), Shader_Compile_Priority_High);
+                }
+            }
+
+            if (const Light* light = entity->GetComponent<Light>())
+            {
+                ShaderLight::GetVariation(m_context, light, m_options, Shader_Compile_Priority_High);
+            }
+        }
     }
 
     const shared_ptr<Spartan::RHI_Texture>& Renderer::GetEnvironmentTexture()
@@ -723,6 +1280,9 @@ namespace Spartan
             return false;
         }
 
+        // No command list is recording at this point, so the descriptor pool can safely grow (if it ran out of sets)
+        m_descriptor_cache->GrowIfNeeded();
+
         return true;
     }
 
@@ -23,15 +23,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ========================
 #include <unordered_map>
+#include <unordered_set>
 #include <array>
 #include <atomic>
+#include <mutex>
 #include "Renderer_ConstantBuffers.h"
 #include "Material.h"
 #include "../Core/ISubsystem.h"
 #include "../Math/Rectangle.h"
+#include "../Math/Frustum.h"
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Viewport.h"
 #include "../RHI/RHI_Vertex.h"
+#include "../RHI/RHI_PipelineState.h"
 //===================================
 
 namespace Spartan
@@ -39,13 +43,16 @@ namespace Spartan
     // Forward declarations
 	class Entity;
 	class Camera;
+	class Renderable;
 	class Light;
 	class ResourceCache;
 	class Font;
-	class Variant;
 	class Grid;
 	class Transform_Gizmo;
 	class Profiler;
+	class Threading;
+    class ShaderCompileQueue;
+    class TextureStreamer;
 
 	namespace Math
 	{
@@ -111,8 +118,10 @@ namespace Spartan
 	enum Renderer_Shader_Type
 	{
 		Shader_Gbuffer_V,
+        Shader_Gbuffer_Instanced_V,
         Shader_Gbuffer_P,
 		Shader_Depth_V,
+        Shader_Depth_Instanced_V,
         Shader_Depth_P,
 		Shader_Quad_V,
 		Shader_Texture_P,
@@ -248,6 +257,8 @@ namespace Spartan
         const auto& GetCamera()                             const { return m_camera; }
         auto IsInitialized()                                const { return m_initialized; }
         auto& GetShaders()                                  const { return m_shaders; }
+        ShaderCompileQueue* GetShaderCompileQueue()         const { return m_shader_compile_queue.get(); }
+        TextureStreamer* GetTextureStreamer()               const { return m_texture_streamer.get(); }
         bool IsRendering()                                  const { return m_is_rendering; }
         uint32_t GetMaxResolution() const;
 
@@ -256,7 +267,57 @@ namespace Spartan
         void SetGlobalSamplersAndConstantBuffers(RHI_CommandList* cmd_list) const;
         RHI_Texture* GetBlackTexture() const { return m_tex_black_transparent.get(); }
 
+        // Called by materials whose albedo alpha crosses 1.0, the entities using them are re-classified on the next world resolve
+        void OnMaterialTransparencyChanged(const Material* material);
+
 	private:
+        // A draw and its sort key, packed as (most significant first) pass, shader variation, material, geometry and depth
+        struct _draw_item
+        {
+            uint64_t key;
+            Entity* entity;
+        };
+        struct _visible_draws
+        {
+            std::vector<_draw_item>& Get(const Renderer_Object_Type object_type) { return object_type == Renderer_Object_Transparent ? transparent : opaque; }
+            void Clear() { opaque.clear(); transparent.clear(); }
+
+            std::vector<_draw_item> opaque;
+            std::vector<_draw_item> transparent;
+        };
+        // A run of adjacent draws which share geometry (and material, when it matters) and can be issued as one instanced draw
+        struct _draw_group
+        {
+            uint32_t start;
+            uint32_t count;
+        };
+        // Everything a pass writes to while recording, so that jobs can record their own command lists in parallel
+        struct _record_job
+        {
+            RHI_CommandList* cmd_list   = nullptr;
+            const Light* light          = nullptr;
+            RHI_PipelineState pipeline_state;
+            std::vector<std::shared_ptr<RHI_CommandList>> cmd_lists; // one per swapchain buffer, same as the swapchain's own
+            std::vector<_draw_item> draw_items;
+            std::vector<_draw_item> sort_scratch;
+            std::vector<_draw_group> draw_groups;
+
+            BufferUber buffer_uber_cpu;
+            BufferUber buffer_uber_cpu_previous;
+            std::shared_ptr<RHI_ConstantBuffer> buffer_uber_gpu;
+            uint32_t buffer_uber_offset_index = 0;
+
+            BufferObject buffer_object_cpu;
+            BufferObject buffer_object_cpu_previous;
+            std::shared_ptr<RHI_ConstantBuffer> buffer_object_gpu;
+            uint32_t buffer_object_offset_index = 0;
+
+            BufferInstance buffer_instance_cpu;
+            BufferInstance buffer_instance_cpu_previous;
+            std::shared_ptr<RHI_ConstantBuffer> buffer_instance_gpu;
+            uint32_t buffer_instance_offset_index = 0;
+        };
+
         // Resource creation
         void CreateConstantBuffers();
 		void CreateDepthStencilStates();
@@ -270,7 +331,8 @@ namespace Spartan
 
 		// Passes
 		void Pass_Main(RHI_CommandList* cmd_list);
-		void Pass_LightDepth(RHI_CommandList* cmd_list, const Renderer_Object_Type object_type);
+		void Pass_LightDepth(RHI_CommandList* cmd_list);
+        void Pass_LightDepth(_record_job& job, const Renderer_Object_Type object_type);
         void Pass_DepthPrePass(RHI_CommandList* cmd_list);
 		void Pass_GBuffer(RHI_CommandList* cmd_list, const Renderer_Object_Type object_type);
 		void Pass_Hbao(RHI_CommandList* cmd_list, const bool use_stencil);
@@ -308,14 +370,26 @@ namespace Spartan
         // Constant buffers
         bool UpdateFrameBuffer();
         bool UpdateMaterialBuffer();
-        bool UpdateUberBuffer(RHI_CommandList* cmd_list);
-        bool UpdateObjectBuffer(RHI_CommandList* cmd_list);
+        bool UpdateUberBuffer(RHI_CommandList* cmd_list, _record_job* job = nullptr);
+        bool UpdateObjectBuffer(RHI_CommandList* cmd_list, _record_job* job = nullptr);
+        bool UpdateInstanceBuffer(RHI_CommandList* cmd_list, _record_job* job = nullptr);
         bool UpdateLightBuffer(const Light* light);
 
+        // Instancing
+        uint32_t GeometryIndex(const Renderable* renderable);
+        uint32_t GeometryIndexFind(const Renderable* renderable) const;
+        void DrawItemsByGeometry(const std::vector<Entity*>& entities, std::vector<_draw_item>* draws, _record_job* job = nullptr);
+        void DrawGroupsBuild(const std::vector<_draw_item>& draws, const bool match_material, std::vector<_draw_group>* groups) const;
+        void DrawGroup(RHI_CommandList* cmd_list, const std::vector<_draw_item>& draws, const _draw_group& group, const bool instanced, const Math::Matrix& view_projection, const bool velocity, _record_job* job = nullptr);
+
         // Misc
-        void RenderablesAcquire(const Variant& renderables);
-        void RenderablesSort(std::vector<Entity*>* renderables);
+        void RenderablesAcquire();
+        void RenderablesRebuild();
+        void RenderablesRegister(Entity* entity);
+        void RenderablesUnregister(const std::unordered_set<Entity*>& entities);
+        void VisibilityCompute();
         void ClearEntities();
+        void ShaderVariationsPrecompile();
 
         // Render textures
         std::unordered_map<Renderer_RenderTarget_Type, std::shared_ptr<RHI_Texture>> m_render_targets;
@@ -333,6 +407,10 @@ namespace Spartan
 
 		// Shaders
 		std::unordered_map<Renderer_Shader_Type, std::shared_ptr<RHI_Shader>> m_shaders;
+        std::unique_ptr<ShaderCompileQueue> m_shader_compile_queue;
+
+        // Texture streaming
+        std::unique_ptr<TextureStreamer> m_texture_streamer;
 
 		// Depth-stencil states
         std::shared_ptr<RHI_DepthStencilState> m_depth_stencil_off_off;
@@ -416,6 +494,11 @@ namespace Spartan
         std::shared_ptr<RHI_ConstantBuffer> m_buffer_object_gpu;
         uint32_t m_buffer_object_offset_index = 0;
 
+        BufferInstance m_buffer_instance_cpu;
+        BufferInstance m_buffer_instance_cpu_previous;
+        std::shared_ptr<RHI_ConstantBuffer> m_buffer_instance_gpu;
+        uint32_t m_buffer_instance_offset_index = 0;
+
         BufferLight m_buffer_light_cpu;
         BufferLight m_buffer_light_cpu_previous;
         std::shared_ptr<RHI_ConstantBuffer> m_buffer_light_gpu;
@@ -424,6 +507,43 @@ namespace Spartan
         // Entities and material references
         std::unordered_map<Renderer_Object_Type, std::vector<Entity*>> m_entities;
         std::array<Material*, m_max_material_instances> m_material_instances;
+
+        // What each registered entity was classified as, so that the registries can be updated from world deltas alone
+        struct _entity_proxy
+        {
+            const Material* material    = nullptr;
+            const Light* light          = nullptr;
+            bool is_renderable          = false;
+            bool is_transparent         = false;
+            bool is_camera              = false;
+        };
+        std::unordered_map<Entity*, _entity_proxy> m_entity_proxies;
+        bool m_entities_registered = false;
+        std::unordered_set<const Material*> m_materials_changed;
+        std::mutex m_mutex_materials_changed;
+
+        // Visible entities - Computed once per frame by VisibilityCompute() and consumed by every geometry pass
+        struct _visible_entities
+        {
+            std::vector<Entity*>& Get(const Renderer_Object_Type object_type) { return object_type == Renderer_Object_Transparent ? transparent : opaque; }
+            void Clear() { opaque.clear(); transparent.clear(); }
+
+            std::vector<Entity*> opaque;
+            std::vector<Entity*> transparent;
+        };
+        _visible_entities m_visible_camera;                                                         // front to back
+        _visible_draws m_visible_camera_draws;                                                      // sorted by key, transparent draws are back to front within a material
+        std::unordered_map<const Light*, std::vector<_visible_entities>> m_visible_light_slices;    // shadow casters, one list per shadow slice
+        Math::BoundingBoxSoA m_visibility_boxes;
+        std::vector<uint8_t> m_visibility_flags;
+        std::vector<uint32_t> m_visibility_masks;
+        std::vector<_draw_item> m_sort_depth;
+        std::vector<_draw_item> m_sort_scratch;
+        std::unordered_map<uint32_t, uint32_t> m_sort_material_indices;
+        std::unordered_map<uint64_t, uint32_t> m_sort_geometry_indices;
+        std::vector<_draw_item> m_draw_items;
+        std::vector<_draw_group> m_draw_groups;
+        std::vector<std::unique_ptr<_record_job>> m_record_jobs;
         
         std::shared_ptr<Camera> m_camera;
 
@@ -436,5 +556,6 @@ namespace Spartan
         // Dependencies
         Profiler* m_profiler            = nullptr;
         ResourceCache* m_resource_cache = nullptr;
+        Threading* m_threading          = nullptr;
     };
 }
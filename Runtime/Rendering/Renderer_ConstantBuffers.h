@@ -142,6 +142,27 @@ namespace Spartan
 
         bool operator!=(const BufferObject& rhs) const { return !(*this == rhs); }
     };
+
+    // High frequency - Updates per instanced draw
+    static const uint32_t m_max_instances = 32; // must match the shader
+    struct BufferInstance
+    {
+        Math::Matrix transform[m_max_instances];
+        Math::Matrix wvp_previous[m_max_instances];
+
+        bool operator==(const BufferInstance& rhs) const
+        {
+            for (uint32_t i = 0; i < m_max_instances; i++)
+            {
+                if (transform[i] != rhs.transform[i] || wvp_previous[i] != rhs.wvp_previous[i])
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool operator!=(const BufferInstance& rhs) const { return !(*this == rhs); }
+    };
     
     // Light buffer
     struct BufferLight
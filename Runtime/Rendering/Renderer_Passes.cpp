@@ -30,9 +30,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Gizmos/Transform_Gizmo.h"
 #include "../Profiling/Profiler.h"
 #include "../RHI/RHI_CommandList.h"
+#include "../RHI/RHI_ConstantBuffer.h"
 #include "../RHI/RHI_Implementation.h"
 #include "../RHI/RHI_VertexBuffer.h"
 #include "../RHI/RHI_PipelineState.h"
+#include "../RHI/RHI_SwapChain.h"
 #include "../RHI/RHI_Texture.h"
 #include "../World/Entity.h"
 #include "../World/Components/Light.h"
@@ -76,6 +78,9 @@ namespace Spartan
 
         // Updates onces, used almost everywhere
         UpdateFrameBuffer();
+
+        // Cull once, all the geometry passes below draw from the resulting lists
+        VisibilityCompute();
         
         // Runs only once
         Pass_BrdfSpecularLut(cmd_list);
@@ -84,11 +89,7 @@ namespace Spartan
         
         // Depth
         {
-            Pass_LightDepth(cmd_list, Renderer_Object_Opaque);
-            if (draw_transparent_objects)
-            {
-                Pass_LightDepth(cmd_list, Renderer_Object_Transparent);
-            }
+            Pass_LightDepth(cmd_list);
         
             if (GetOption(Render_DepthPrepass))
             {
@@ -131,115 +132,238 @@ namespace Spartan
         }
 	}
 
-	void Renderer::Pass_LightDepth(RHI_CommandList* cmd_list, const Renderer_Object_Type object_type)
+	void Renderer::Pass_LightDepth(RHI_CommandList* cmd_list)
 	{
-        // All opaque objects are rendered from the lights point of view.
-        // Opaque objects write their depth information to a depth buffer, using just a vertex shader.
-        // Transparent objects, read the opaque depth but don't write their own, instead, they write their color information using a pixel shader.
+        // Every shadow casting light is an independent job, recorded on its own command list (and thread, if the API allows it).
+        // The shadow maps are only read later in the frame, so the job command lists are simply submitted ahead of the main one.
 
-		// Acquire shader
-		RHI_Shader* shader_v = m_shaders[Shader_Depth_V].get();
-        RHI_Shader* shader_p = m_shaders[Shader_Depth_P].get();
-		if (!shader_v->IsCompiled() || !shader_p->IsCompiled())
+		// Ensure the shaders have compiled
+		if (!m_shaders[Shader_Depth_V]->IsCompiled() || !m_shaders[Shader_Depth_P]->IsCompiled())
 			return;
 
-        // Get entities
-        const auto& entities = m_entities[object_type];
-        if (entities.empty())
-            return;
-
-        const bool transparent_pass = object_type == Renderer_Object_Transparent;
+        const bool draw_transparent_objects = !m_entities[Renderer_Object_Transparent].empty();
 
-        // Go through all of the lights
-		const auto& entities_light = m_entities[Renderer_Object_Light];
-        for (uint32_t light_index = 0; light_index < entities_light.size(); light_index++)
+        // Gather the lights which have something to record
+        vector<const Light*> lights;
+        for (Entity* entity : m_entities[Renderer_Object_Light])
         {
-            const Light* light = entities_light[light_index]->GetComponent<Light>();
+            const Light* light = entity->GetComponent<Light>();
 
             // Skip some obvious cases
-            if (!light || !light->GetShadowsEnabled())
+            if (!light || !light->GetShadowsEnabled() || !light->GetDepthTexture())
                 continue;
 
-            // Skip lights that don't cast transparent shadows (if this is a transparent pass)
-            if (transparent_pass && !light->GetShadowsTransparentEnabled())
+            // Acquire the visible shadow casters (one list per slice)
+            if (m_visible_light_slices.find(light) == m_visible_light_slices.end())
                 continue;
 
-            // Acquire light's shadow maps
-            RHI_Texture* tex_depth = light->GetDepthTexture();
-            RHI_Texture* tex_color = light->GetColorTexture();
-            if (!tex_depth)
-                continue;
+            lights.emplace_back(light);
+        }
 
-            // Set render state
-            static RHI_PipelineState pipeline_state;
-            pipeline_state.shader_vertex                    = shader_v;
-            pipeline_state.vertex_buffer_stride             = static_cast<uint32_t>(sizeof(RHI_Vertex_PosTexNorTan)); // assume all vertex buffers have the same stride (which they do)
-            pipeline_state.shader_pixel                     = transparent_pass ? shader_p : nullptr;
-            pipeline_state.blend_state                      = transparent_pass ? m_blend_alpha.get() : m_blend_disabled.get();
-            pipeline_state.depth_stencil_state              = transparent_pass ? m_depth_stencil_on_off_r.get() : m_depth_stencil_on_off_w.get();
-            pipeline_state.render_target_color_textures[0]  = tex_color; // always bind so we can clear to white (in case there are now transparent objects)
-            pipeline_state.render_target_depth_texture      = tex_depth;
-            pipeline_state.clear_stencil                    = state_stencil_dont_care;
-            pipeline_state.viewport                         = tex_depth->GetViewport();
-            pipeline_state.primitive_topology               = RHI_PrimitiveTopology_TriangleList;
-            pipeline_state.pass_name                        = transparent_pass ? "Pass_LightDepthTransparent" : "Pass_LightDepth";
+        const uint32_t job_count = static_cast<uint32_t>(lights.size());
+        if (job_count == 0)
+            return;
+
+        // Create the jobs (they are kept around, along with their command lists and buffers)
+        while (m_record_jobs.size() < job_count)
+        {
+            unique_ptr<_record_job> job = make_unique<_record_job>();
 
-            for (uint32_t array_index = 0; array_index < tex_depth->GetArraySize(); array_index++)
+            if (RHI_Context::parallel_recording)
             {
-                // Set render target texture array index
-                pipeline_state.render_target_color_texture_array_index          = array_index;
-                pipeline_state.render_target_depth_stencil_texture_array_index  = array_index;
+                for (uint32_t i = 0; i < m_swap_chain->GetBufferCount(); i++)
+                {
+                    job->cmd_lists.emplace_back(make_shared<RHI_CommandList>(i, m_swap_chain.get(), m_context));
+                }
+            }
+
+            job->buffer_uber_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "uber", true);
+            job->buffer_uber_gpu->Create<BufferUber>(64);
+
+            job->buffer_object_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "object", true);
+            job->buffer_object_gpu->Create<BufferObject>();
+
+            job->buffer_instance_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "instance", true);
+            job->buffer_instance_gpu->Create<BufferInstance>();
+
+            m_record_jobs.emplace_back(move(job));
+        }
 
-                // Set clear values
-                pipeline_state.clear_color[0] = Vector4::One;
-                pipeline_state.clear_depth    = transparent_pass ? state_depth_load : GetClearDepth();
+        // Prepare the jobs - Anything that can't be done from a worker thread happens here
+        for (uint32_t i = 0; i < job_count; i++)
+        {
+            _record_job& job    = *m_record_jobs[i];
+            job.light           = lights[i];
+
+            // Reset dynamic buffer indices when the swapchain resets to first buffer/command list (same as the renderer's own)
+            if (m_swap_chain->GetCmdIndex() == 0)
+            {
+                job.buffer_uber_offset_index      = 0;
+                job.buffer_object_offset_index    = 0;
+                job.buffer_instance_offset_index  = 0;
+            }
 
-                const Matrix& view_projection = light->GetViewMatrix(array_index) * light->GetProjectionMatrix(array_index);
+            // Every draw updates at most one offset of each buffer, so size them up front, jobs can't flush to re-allocate
+            uint32_t item_count = 0;
+            for (const _visible_entities& slice : m_visible_light_slices[job.light])
+            {
+                item_count += static_cast<uint32_t>(slice.opaque.size() + slice.transparent.size());
+            }
 
-                // Set appropriate rasterizer state
-                if (light->GetLightType() == LightType_Directional)
+            const auto reserve = [this, item_count](RHI_ConstantBuffer* buffer, const uint32_t offset_index, const auto& buffer_cpu)
+            {
+                const uint32_t offset_count = offset_index + item_count + 2;
+                if (offset_count > buffer->GetOffsetCount())
                 {
-                    // "Pancaking" - https://www.gamedev.net/forums/topic/639036-shadow-mapping-and-high-up-objects/
-                    // It's basically a way to capture the silhouettes of potential shadow casters behind the light's view point.
-                    // Of course we also have to make sure that the light doesn't cull them in the first place (this is done automatically by the light)
-                    pipeline_state.rasterizer_state = m_rasterizer_cull_back_solid_no_clip.get();
+                    // Previous frames might still be using the buffer
+                    m_rhi_device->Queue_WaitAll();
+                    buffer->Create<std::decay_t<decltype(buffer_cpu)>>(Math::Helper::NextPowerOfTwo(offset_count));
                 }
-                else
+            };
+            reserve(job.buffer_uber_gpu.get(),        job.buffer_uber_offset_index,       job.buffer_uber_cpu);
+            reserve(job.buffer_object_gpu.get(),      job.buffer_object_offset_index,     job.buffer_object_cpu);
+            reserve(job.buffer_instance_gpu.get(),    job.buffer_instance_offset_index,   job.buffer_instance_cpu);
+
+            // Begin the job's command list
+            if (RHI_Context::parallel_recording)
+            {
+                job.cmd_list = job.cmd_lists[m_swap_chain->GetCmdIndex()].get();
+                job.cmd_list->Begin();
+            }
+            else
+            {
+                job.cmd_list = cmd_list;
+            }
+        }
+
+        // Record
+        const auto record = [this, draw_transparent_objects](_record_job& job)
+        {
+            Pass_LightDepth(job, Renderer_Object_Opaque);
+
+            if (draw_transparent_objects && job.light->GetShadowsTransparentEnabled())
+            {
+                Pass_LightDepth(job, Renderer_Object_Transparent);
+            }
+        };
+
+        if (RHI_Context::parallel_recording)
+        {
+            m_threading->ParallelFor(0, job_count, 1, [this, &record](uint32_t start, uint32_t end)
+            {
+                for (uint32_t i = start; i < end; i++)
                 {
-                    pipeline_state.rasterizer_state = m_rasterizer_cull_back_solid.get();
+                    record(*m_record_jobs[i]);
                 }
+            });
 
-                // State tracking
-                bool render_pass_active     = false;
-                uint32_t m_set_material_id  = 0;
-
-                for (uint32_t entity_index = 0; entity_index < static_cast<uint32_t>(entities.size()); entity_index++)
+            // Submit in order, ahead of the main command list (which reads the shadow maps)
+            for (uint32_t i = 0; i < job_count; i++)
+            {
+                if (!m_record_jobs[i]->cmd_list->Submit())
                 {
-                    Entity* entity = entities[entity_index];
+                    LOG_ERROR("Failed to submit");
+                }
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < job_count; i++)
+            {
+                record(*m_record_jobs[i]);
+            }
+        }
+	}
 
-                    // Acquire renderable component
-                    const auto& renderable = entity->GetRenderable();
-                    if (!renderable)
-                        continue;
+	void Renderer::Pass_LightDepth(_record_job& job, const Renderer_Object_Type object_type)
+	{
+        // All opaque objects are rendered from the lights point of view.
+        // Opaque objects write their depth information to a depth buffer, using just a vertex shader.
+        // Transparent objects, read the opaque depth but don't write their own, instead, they write their color information using a pixel shader.
+        // This can run on any thread, so only the job's state is written to.
 
-                    // Skip meshes that don't cast shadows
-                    if (!renderable->GetCastShadows())
-                        continue;
+		// Acquire shader
+		RHI_Shader* shader_v            = m_shaders[Shader_Depth_V].get();
+        RHI_Shader* shader_v_instanced  = m_shaders[Shader_Depth_Instanced_V].get();
+        RHI_Shader* shader_p            = m_shaders[Shader_Depth_P].get();
+        RHI_CommandList* cmd_list       = job.cmd_list;
+        const Light* light              = job.light;
 
-                    // Acquire geometry
-                    const auto& model = renderable->GeometryModel();
-                    if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
-                        continue;
+        // Until the instanced shader compiles, everything is drawn one by one
+        const bool can_instance = shader_v_instanced->IsCompiled();
 
-                    // Acquire material
-                    const auto& material = renderable->GetMaterial();
-                    if (!material)
-                        continue;
+        const bool transparent_pass = object_type == Renderer_Object_Transparent;
+
+        // Acquire light's shadow maps
+        RHI_Texture* tex_depth = light->GetDepthTexture();
+        RHI_Texture* tex_color = light->GetColorTexture();
+
+        // Acquire the visible shadow casters (one list per slice)
+        const vector<_visible_entities>& visible_slices = m_visible_light_slices.at(light);
+
+        // Set render state
+        RHI_PipelineState& pipeline_state               = job.pipeline_state;
+        pipeline_state.shader_vertex                    = shader_v;
+        pipeline_state.vertex_buffer_stride             = static_cast<uint32_t>(sizeof(RHI_Vertex_PosTexNorTan)); // assume all vertex buffers have the same stride (which they do)
+        pipeline_state.shader_pixel                     = transparent_pass ? shader_p : nullptr;
+        pipeline_state.blend_state                      = transparent_pass ? m_blend_alpha.get() : m_blend_disabled.get();
+        pipeline_state.depth_stencil_state              = transparent_pass ? m_depth_stencil_on_off_r.get() : m_depth_stencil_on_off_w.get();
+        pipeline_state.render_target_color_textures[0]  = tex_color; // always bind so we can clear to white (in case there are now transparent objects)
+        pipeline_state.render_target_depth_texture      = tex_depth;
+        pipeline_state.clear_stencil                    = state_stencil_dont_care;
+        pipeline_state.viewport                         = tex_depth->GetViewport();
+        pipeline_state.primitive_topology               = RHI_PrimitiveTopology_TriangleList;
+        pipeline_state.pass_name                        = transparent_pass ? "Pass_LightDepthTransparent" : "Pass_LightDepth";
 
-                    // Skip objects outside of the view frustum
-                    if (!light->IsInViewFrustrum(renderable, array_index))
+        for (uint32_t array_index = 0; array_index < tex_depth->GetArraySize() && array_index < visible_slices.size(); array_index++)
+        {
+            // Set render target texture array index
+            pipeline_state.render_target_color_texture_array_index          = array_index;
+            pipeline_state.render_target_depth_stencil_texture_array_index  = array_index;
+
+            // Set clear values
+            pipeline_state.clear_color[0] = Vector4::One;
+            pipeline_state.clear_depth    = transparent_pass ? state_depth_load : GetClearDepth();
+
+            const Matrix& view_projection = light->GetViewMatrix(array_index) * light->GetProjectionMatrix(array_index);
+
+            // Set appropriate rasterizer state
+            if (light->GetLightType() == LightType_Directional)
+            {
+                // "Pancaking" - https://www.gamedev.net/forums/topic/639036-shadow-mapping-and-high-up-objects/
+                // It's basically a way to capture the silhouettes of potential shadow casters behind the light's view point.
+                // Of course we also have to make sure that the light doesn't cull them in the first place (this is done automatically by the light)
+                pipeline_state.rasterizer_state = m_rasterizer_cull_back_solid_no_clip.get();
+            }
+            else
+            {
+                pipeline_state.rasterizer_state = m_rasterizer_cull_back_solid.get();
+            }
+
+            // Group the casters by geometry (and material, since transparent casters sample their albedo)
+            DrawItemsByGeometry(visible_slices[array_index].Get(object_type), &job.draw_items, &job);
+            DrawGroupsBuild(job.draw_items, transparent_pass, &job.draw_groups);
+
+            // Instanced groups and single draws use different vertex shaders, so each gets its own render pass
+            for (const bool instanced : { true, false })
+            {
+                if (instanced && !can_instance)
+                    continue;
+
+                pipeline_state.shader_vertex = instanced ? shader_v_instanced : shader_v;
+
+                // State tracking
+                bool render_pass_active     = false;
+                uint32_t m_set_material_id  = 0;
+
+                // Visibility, geometry and material have already been validated by VisibilityCompute()
+                for (const _draw_group& group : job.draw_groups)
+                {
+                    if ((can_instance && group.count > 1) != instanced)
                         continue;
 
+                    const auto& material = job.draw_items[group.start].entity->GetRenderable()->GetMaterial();
+
                     if (!render_pass_active)
                     {
                         render_pass_active = cmd_list->BeginRenderPass(pipeline_state);
@@ -253,32 +377,27 @@ namespace Spartan
                         cmd_list->SetTexture(28, tex_albedo ? tex_albedo : m_tex_white.get());
 
                         // Update uber buffer with material properties
-                        m_buffer_uber_cpu.mat_albedo    = material->GetColorAlbedo();
-                        m_buffer_uber_cpu.mat_tiling_uv = material->GetTiling();
-                        m_buffer_uber_cpu.mat_offset_uv = material->GetOffset();
+                        job.buffer_uber_cpu.mat_albedo    = material->GetColorAlbedo();
+                        job.buffer_uber_cpu.mat_tiling_uv = material->GetTiling();
+                        job.buffer_uber_cpu.mat_offset_uv = material->GetOffset();
 
                         // Update constant buffer
-                        UpdateUberBuffer(cmd_list);
+                        UpdateUberBuffer(cmd_list, &job);
 
                         m_set_material_id = material->GetId();
                     }
 
-                    // Bind geometry
-                    cmd_list->SetBufferIndex(model->GetIndexBuffer());
-                    cmd_list->SetBufferVertex(model->GetVertexBuffer());
-
-                    // Update uber buffer with cascade transform
-                    m_buffer_object_cpu.object = entity->GetTransform()->GetMatrix() * view_projection;
-                    if (!UpdateObjectBuffer(cmd_list))
-                        continue;
-
-                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
-
+                    // Draw with the cascade transform
+                    DrawGroup(cmd_list, job.draw_items, group, instanced, view_projection, false, &job);
                 }
 
                 if (render_pass_active)
                 {
                     cmd_list->EndRenderPass();
+
+                    // The second render pass continues where the first one left off
+                    pipeline_state.clear_color[0]   = state_color_load;
+                    pipeline_state.clear_depth      = state_depth_load;
                 }
             }
         }
@@ -290,17 +409,21 @@ namespace Spartan
         // just their depth information into a depth map.
 
         // Acquire required resources/data
-        const auto& shader_depth    = m_shaders[Shader_Depth_V];
-        const auto& tex_depth       = m_render_targets[RenderTarget_Gbuffer_Depth];
-        const auto& entities        = m_entities[Renderer_Object_Opaque];
+        RHI_Shader* shader_depth            = m_shaders[Shader_Depth_V].get();
+        RHI_Shader* shader_depth_instanced  = m_shaders[Shader_Depth_Instanced_V].get();
+        const auto& tex_depth               = m_render_targets[RenderTarget_Gbuffer_Depth];
+        const auto& entities                = m_visible_camera.opaque;
 
         // Ensure the shader has compiled
         if (!shader_depth->IsCompiled())
             return;
 
+        // Until the instanced shader compiles, everything is drawn one by one
+        const bool can_instance = shader_depth_instanced->IsCompiled();
+
         // Set render state
         static RHI_PipelineState pipeline_state;
-        pipeline_state.shader_vertex                = shader_depth.get();
+        pipeline_state.shader_vertex                = shader_depth;
         pipeline_state.shader_pixel                 = nullptr;
         pipeline_state.rasterizer_state             = m_rasterizer_cull_back_solid.get();
         pipeline_state.blend_state                  = m_blend_disabled.get();
@@ -311,65 +434,46 @@ namespace Spartan
         pipeline_state.primitive_topology           = RHI_PrimitiveTopology_TriangleList;
         pipeline_state.pass_name                    = "Pass_DepthPrePass";
 
-        // Record commands
-        if (cmd_list->BeginRenderPass(pipeline_state))
-        { 
-            if (!entities.empty())
-            {
-                // Variables that help reduce state changes
-                uint32_t currently_bound_geometry = 0;
-
-                // Draw opaque
-                for (const auto& entity : entities)
-                {
-                    // Get renderable
-                    const auto& renderable = entity->GetRenderable();
-                    if (!renderable)
-                        continue;
-
-                    // Get geometry
-                    const auto& model = renderable->GeometryModel();
-                    if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
-                        continue;
+        // Group the opaque entities by geometry, each entity keeps its front to back order within its group
+        DrawItemsByGeometry(entities, &m_draw_items);
+        DrawGroupsBuild(m_draw_items, false, &m_draw_groups);
 
-                    // Skip objects outside of the view frustum
-                    if (!m_camera->IsInViewFrustrum(renderable))
-                        continue;
+        // Instanced groups and single draws use different vertex shaders, so each gets its own render pass (the first one clears)
+        for (const bool instanced : { true, false })
+        {
+            if (instanced && !can_instance)
+                continue;
 
-                    // Bind geometry
-                    if (currently_bound_geometry != model->GetId())
-                    {
-                        cmd_list->SetBufferIndex(model->GetIndexBuffer());
-                        cmd_list->SetBufferVertex(model->GetVertexBuffer());
-                        currently_bound_geometry = model->GetId();
-                    }
+            pipeline_state.shader_vertex = instanced ? shader_depth_instanced : shader_depth;
 
-                    // Update uber buffer with entity transform
-                    if (Transform* transform = entity->GetTransform())
+            // Record commands
+            if (cmd_list->BeginRenderPass(pipeline_state))
+            {
+                for (const _draw_group& group : m_draw_groups)
+                {
+                    if ((can_instance && group.count > 1) == instanced)
                     {
-                        // Update uber buffer with cascade transform
-                        m_buffer_uber_cpu.transform = transform->GetMatrix() * m_buffer_frame_cpu.view_projection;
-                        UpdateUberBuffer(cmd_list);
+                        DrawGroup(cmd_list, m_draw_items, group, instanced, m_buffer_frame_cpu.view_projection, false);
                     }
-
-                    // Draw	
-                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
                 }
+                cmd_list->EndRenderPass();
             }
-            cmd_list->EndRenderPass();
+
+            pipeline_state.clear_depth = state_depth_load;
         }
     }
 
 	void Renderer::Pass_GBuffer(RHI_CommandList* cmd_list, const Renderer_Object_Type object_type)
 	{
         // Acquire required resources/shaders
-        RHI_Texture* tex_albedo       = m_render_targets[RenderTarget_Gbuffer_Albedo].get();
-        RHI_Texture* tex_normal       = m_render_targets[RenderTarget_Gbuffer_Normal].get();
-        RHI_Texture* tex_material     = m_render_targets[RenderTarget_Gbuffer_Material].get();
-        RHI_Texture* tex_velocity     = m_render_targets[RenderTarget_Gbuffer_Velocity].get();
-        RHI_Texture* tex_depth        = m_render_targets[RenderTarget_Gbuffer_Depth].get();
-        RHI_Shader* shader_v          = m_shaders[Shader_Gbuffer_V].get();
-        ShaderGBuffer* shader_p       = static_cast<ShaderGBuffer*>(m_shaders[Shader_Gbuffer_P].get());
+        RHI_Texture* tex_albedo         = m_render_targets[RenderTarget_Gbuffer_Albedo].get();
+        RHI_Texture* tex_normal         = m_render_targets[RenderTarget_Gbuffer_Normal].get();
+        RHI_Texture* tex_material       = m_render_targets[RenderTarget_Gbuffer_Material].get();
+        RHI_Texture* tex_velocity       = m_render_targets[RenderTarget_Gbuffer_Velocity].get();
+        RHI_Texture* tex_depth          = m_render_targets[RenderTarget_Gbuffer_Depth].get();
+        RHI_Shader* shader_v            = m_shaders[Shader_Gbuffer_V].get();
+        RHI_Shader* shader_v_instanced  = m_shaders[Shader_Gbuffer_Instanced_V].get();
+        ShaderGBuffer* shader_p         = static_cast<ShaderGBuffer*>(m_shaders[Shader_Gbuffer_P].get());
 
         // Validate that the shader has compiled
         if (!shader_v->IsCompiled())
@@ -404,139 +508,127 @@ namespace Spartan
         uint32_t material_bound_id = 0;
         m_material_instances.fill(nullptr);
 
-        // Iterate through all the G-Buffer shader variations
-        for (const auto& it : ShaderGBuffer::GetVariations())
-        {
-            // Skip the shader until it compiles or the users spots a compilation error
-            if (!it.second->IsCompiled())
-                continue;
+        // The draws are sorted by shader variation, then material, then geometry (see VisibilityCompute()), so identical draws are adjacent
+        const vector<_draw_item>& draws = m_visible_camera_draws.Get(object_type);
+        DrawGroupsBuild(draws, true, &m_draw_groups);
+        const auto& variations      = ShaderGBuffer::GetVariations();
+        const uint32_t group_count  = static_cast<uint32_t>(m_draw_groups.size());
 
-            // Set pixel shader
-            pso.shader_pixel = static_cast<RHI_Shader*>(it.second.get());
+        // Until the instanced shader compiles, everything is drawn one by one
+        const bool can_instance = shader_v_instanced->IsCompiled();
 
-            // Set pass name
-            pso.pass_name = pso.shader_pixel->GetName().c_str();
+        auto bind_material = [&](Material* material)
+        {
+            // Bind material
+            bool firs_run       = material_index == 0;
+            bool new_material   = material_bound_id != material->GetId();
+            if (!firs_run && !new_material)
+                return;
 
-            bool render_pass_active = false;
-            auto& entities = m_entities[object_type];
+            material_bound_id = material->GetId();
 
-            // Record commands
-            for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); i++)
+            // Keep track of used material instances (they get mapped to shaders)
+            if (material_index + 1 < m_material_instances.size())
             {
-                Entity* entity = entities[i];
+                // Advance index (0 is reserved for the sky)
+                material_index++;
 
-                // Get renderable
-                const auto& renderable = entity->GetRenderable();
-                if (!renderable)
-                    continue;
+                // Keep reference
+                m_material_instances[material_index] = material;
+            }
+            else
+            {
+                LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
+            }
 
-                // Get material
-                Material* material = renderable->GetMaterial();
-                if (!material)
-                    continue;
+            // Bind material textures		
+            cmd_list->SetTexture(0, material->GetTexture_Ptr(Material_Color));
+            cmd_list->SetTexture(1, material->GetTexture_Ptr(Material_Roughness));
+            cmd_list->SetTexture(2, material->GetTexture_Ptr(Material_Metallic));
+            cmd_list->SetTexture(3, material->GetTexture_Ptr(Material_Normal));
+            cmd_list->SetTexture(4, material->GetTexture_Ptr(Material_Height));
+            cmd_list->SetTexture(5, material->GetTexture_Ptr(Material_Occlusion));
+            cmd_list->SetTexture(6, material->GetTexture_Ptr(Material_Emission));
+            cmd_list->SetTexture(7, material->GetTexture_Ptr(Material_Mask));
+        
+            // Update uber buffer with material properties
+            m_buffer_uber_cpu.mat_id            = static_cast<float>(material_index);
+            m_buffer_uber_cpu.mat_albedo        = material->GetColorAlbedo();
+            m_buffer_uber_cpu.mat_tiling_uv     = material->GetTiling();
+            m_buffer_uber_cpu.mat_offset_uv     = material->GetOffset();
+            m_buffer_uber_cpu.mat_roughness_mul = material->GetProperty(Material_Roughness);
+            m_buffer_uber_cpu.mat_metallic_mul  = material->GetProperty(Material_Metallic);
+            m_buffer_uber_cpu.mat_normal_mul    = material->GetProperty(Material_Normal);
+            m_buffer_uber_cpu.mat_height_mul    = material->GetProperty(Material_Height);
+
+            // Update constant buffer
+            UpdateUberBuffer(cmd_list);
+        };
 
-                // Skip objects with different shader requirements
-                if (!static_cast<ShaderGBuffer*>(pso.shader_pixel)->IsSuitable(material->GetFlags()))
-                    continue;
+        // One shader variation at a time
+        for (uint32_t variation_start = 0; variation_start < group_count;)
+        {
+            const uint16_t variation = draws[m_draw_groups[variation_start].start].entity->GetRenderable()->GetMaterial()->GetFlags();
 
-                // Skip transparent objects that won't contribute
-                if (material->GetColorAlbedo().w == 0 && is_transparent)
-                    continue;
+            uint32_t variation_end = variation_start + 1;
+            while (variation_end < group_count && draws[m_draw_groups[variation_end].start].entity->GetRenderable()->GetMaterial()->GetFlags() == variation)
+            {
+                variation_end++;
+            }
 
-                // Get geometry
-                const auto& model = renderable->GeometryModel();
-                if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
-                    continue;
+            // Skip the shader until it compiles or the users spots a compilation error
+            const auto it = variations.find(variation);
+            if (it != variations.end() && it->second->IsCompiled())
+            {
+                // Set pixel shader
+                pso.shader_pixel = static_cast<RHI_Shader*>(it->second.get());
 
-                // Skip objects outside of the view frustum
-                if (!m_camera->IsInViewFrustrum(renderable))
-                    continue;
+                // Set pass name
+                pso.pass_name = pso.shader_pixel->GetName().c_str();
 
-                if (!render_pass_active)
+                // Instanced groups and single draws use different vertex shaders, so each gets its own render pass
+                for (const bool instanced : { true, false })
                 {
-                    render_pass_active = cmd_list->BeginRenderPass(pso);
-                }
-
-                // Set geometry (will only happen if not already set)
-                cmd_list->SetBufferIndex(model->GetIndexBuffer());
-                cmd_list->SetBufferVertex(model->GetVertexBuffer());
+                    if (instanced && !can_instance)
+                        continue;
 
-                // Bind material
-                bool firs_run       = material_index == 0;
-                bool new_material   = material_bound_id != material->GetId();
-                if (firs_run || new_material)
-                {
-                    material_bound_id = material->GetId();
+                    pso.shader_vertex = instanced ? shader_v_instanced : shader_v;
 
-                    // Keep track of used material instances (they get mapped to shaders)
-                    if (material_index + 1 < m_material_instances.size())
+                    // Record commands (visibility, geometry and material have already been validated by VisibilityCompute())
+                    bool render_pass_active = false;
+                    for (uint32_t group_index = variation_start; group_index < variation_end; group_index++)
                     {
-                        // Advance index (0 is reserved for the sky)
-                        material_index++;
+                        const _draw_group& group = m_draw_groups[group_index];
+                        if ((can_instance && group.count > 1) != instanced)
+                            continue;
 
-                        // Keep reference
-                        m_material_instances[material_index] = material;
-                    }
-                    else
-                    {
-                        LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
-                    }
+                        if (!render_pass_active)
+                        {
+                            render_pass_active = cmd_list->BeginRenderPass(pso);
+                        }
 
-                    // Bind material textures		
-                    cmd_list->SetTexture(0, material->GetTexture_Ptr(Material_Color));
-                    cmd_list->SetTexture(1, material->GetTexture_Ptr(Material_Roughness));
-                    cmd_list->SetTexture(2, material->GetTexture_Ptr(Material_Metallic));
-                    cmd_list->SetTexture(3, material->GetTexture_Ptr(Material_Normal));
-                    cmd_list->SetTexture(4, material->GetTexture_Ptr(Material_Height));
-                    cmd_list->SetTexture(5, material->GetTexture_Ptr(Material_Occlusion));
-                    cmd_list->SetTexture(6, material->GetTexture_Ptr(Material_Emission));
-                    cmd_list->SetTexture(7, material->GetTexture_Ptr(Material_Mask));
-                
-                    // Update uber buffer with material properties
-                    m_buffer_uber_cpu.mat_id            = static_cast<float>(material_index);
-                    m_buffer_uber_cpu.mat_albedo        = material->GetColorAlbedo();
-                    m_buffer_uber_cpu.mat_tiling_uv     = material->GetTiling();
-                    m_buffer_uber_cpu.mat_offset_uv     = material->GetOffset();
-                    m_buffer_uber_cpu.mat_roughness_mul = material->GetProperty(Material_Roughness);
-                    m_buffer_uber_cpu.mat_metallic_mul  = material->GetProperty(Material_Metallic);
-                    m_buffer_uber_cpu.mat_normal_mul    = material->GetProperty(Material_Normal);
-                    m_buffer_uber_cpu.mat_height_mul    = material->GetProperty(Material_Height);
-
-                    // Update constant buffer
-                    UpdateUberBuffer(cmd_list);
-                }
-                
-                // Update uber buffer with entity transform
-                if (Transform* transform = entity->GetTransform())
-                {
-                    m_buffer_object_cpu.object          = transform->GetMatrix();
-                    m_buffer_object_cpu.wvp_current     = transform->GetMatrix() * m_buffer_frame_cpu.view_projection;
-                    m_buffer_object_cpu.wvp_previous    = transform->GetWvpLastFrame();
+                        bind_material(draws[group.start].entity->GetRenderable()->GetMaterial());
 
-                    // Save matrix for velocity computation
-                    transform->SetWvpLastFrame(m_buffer_object_cpu.wvp_current);
+                        // Render
+                        DrawGroup(cmd_list, draws, group, instanced, m_buffer_frame_cpu.view_projection, true);
+                        m_profiler->m_renderer_meshes_rendered += group.count;
 
-                    // Update object buffer
-                    if (!UpdateObjectBuffer(cmd_list))
-                        continue;
-                }
-                
-                // Render	
-                cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
-                m_profiler->m_renderer_meshes_rendered++;
+                        // Clear only on first pass
+                        if (!cleared)
+                        {
+                            pso.ResetClearValues();
+                            cleared = true;
+                        }
+                    }
 
-                // Clear only on first pass
-                if (!cleared)
-                {
-                    pso.ResetClearValues();
-                    cleared = true;
+                    if (render_pass_active)
+                    {
+                        cmd_list->EndRenderPass();
+                    }
                 }
             }
 
-            if (render_pass_active)
-            {
-                cmd_list->EndRenderPass();
-            }
+            variation_start = variation_end;
         }
 
         // Update constant buffer (light pass will access it using material IDs)
@@ -2501,7 +2593,7 @@ namespace Spartan
             m_buffer_uber_cpu.resolution = Vector2(static_cast<float>(tex_out->GetWidth()), static_cast<float>(tex_out->GetHeight()));
             UpdateUberBuffer(cmd_list);
 
-            cmd_list->SetTexture(31, tex_in, true);
+            cmd_list->SetTexture(31, tex_in, RHI_Shader_Compute);
             cmd_list->Dispatch(static_cast<uint32_t>(Math::Helper::Ceil(m_buffer_uber_cpu.resolution.x / 32.0f)), static_cast<uint32_t>(Math::Helper::Ceil(m_buffer_uber_cpu.resolution.y / 32.0f)));
             cmd_list->EndRenderPass();
         }
@@ -60,6 +60,9 @@ namespace Spartan
         m_buffer_object_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "object", is_dynamic);
         m_buffer_object_gpu->Create<BufferObject>();
 
+        m_buffer_instance_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "instance", is_dynamic);
+        m_buffer_instance_gpu->Create<BufferInstance>();
+
         m_buffer_light_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "light");
         m_buffer_light_gpu->Create<BufferLight>();
     }
@@ -184,6 +187,9 @@ namespace Spartan
         // G-Buffer
         m_shaders[Shader_Gbuffer_V] = make_shared<RHI_Shader>(m_context);
         m_shaders[Shader_Gbuffer_V]->CompileAsync<RHI_Vertex_PosTexNorTan>(RHI_Shader_Vertex, dir_shaders + "GBuffer.hlsl");
+        m_shaders[Shader_Gbuffer_Instanced_V] = make_shared<RHI_Shader>(m_context);
+        m_shaders[Shader_Gbuffer_Instanced_V]->AddDefine("INSTANCED");
+        m_shaders[Shader_Gbuffer_Instanced_V]->CompileAsync<RHI_Vertex_PosTexNorTan>(RHI_Shader_Vertex, dir_shaders + "GBuffer.hlsl");
 
         // Quad - Used by almost everything
         m_shaders[Shader_Quad_V] = make_shared<RHI_Shader>(m_context);
@@ -192,6 +198,9 @@ namespace Spartan
         // Depth Vertex
         m_shaders[Shader_Depth_V] = make_shared<RHI_Shader>(m_context);
         m_shaders[Shader_Depth_V]->CompileAsync<RHI_Vertex_PosTex>(RHI_Shader_Vertex, dir_shaders + "Depth.hlsl");
+        m_shaders[Shader_Depth_Instanced_V] = make_shared<RHI_Shader>(m_context);
+        m_shaders[Shader_Depth_Instanced_V]->AddDefine("INSTANCED");
+        m_shaders[Shader_Depth_Instanced_V]->CompileAsync<RHI_Vertex_PosTex>(RHI_Shader_Vertex, dir_shaders + "Depth.hlsl");
         m_shaders[Shader_Depth_P] = make_shared<RHI_Shader>(m_context);
         m_shaders[Shader_Depth_P]->CompileAsync(RHI_Shader_Pixel, dir_shaders + "Depth.hlsl");
 
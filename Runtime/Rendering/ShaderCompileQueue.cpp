@@ -0,0 +1,172 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ================
+#include "Spartan.h"
+#include "ShaderCompileQueue.h"
+//===========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    ShaderCompileQueue::ShaderCompileQueue(Context* context)
+    {
+        m_threading = context->GetSubsystem<Threading>();
+
+        // Leave half of the threads to everything else
+        m_max_concurrency = (std::max)(m_threading->GetThreadCount() / 2, 1u);
+    }
+
+    ShaderCompileQueue::~ShaderCompileQueue()
+    {
+        // Cancel whatever didn't start yet (so that nothing waits on it forever) and wait for the rest, they reference this queue
+        {
+            lock_guard<mutex> lock(m_mutex);
+            for (auto& queue : m_queues)
+            {
+                for (_item& item : queue)
+                {
+                    item.cancel();
+                }
+
+                m_pending.fetch_sub(static_cast<uint32_t>(queue.size()), memory_order_acq_rel);
+                queue.clear();
+            }
+        }
+
+        m_threading->Wait(m_workers);
+    }
+
+    void ShaderCompileQueue::Add(const RHI_Shader* shader, function<void()>&& compile, function<void()>&& cancel, const Shader_Compile_Priority priority)
+    {
+        m_pending.fetch_add(1, memory_order_acq_rel);
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_queues[priority].push_back({ shader, move(compile), move(cancel) });
+        }
+
+        Dispatch();
+    }
+
+    void ShaderCompileQueue::Promote(const RHI_Shader* shader, const Shader_Compile_Priority priority)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(priority); i++)
+        {
+            deque<_item>& queue = m_queues[i];
+            const auto it = find_if(queue.begin(), queue.end(), [shader](const _item& item) { return item.shader == shader; });
+            if (it != queue.end())
+            {
+                m_queues[priority].push_back(move(*it));
+                queue.erase(it);
+                return;
+            }
+        }
+    }
+
+    void ShaderCompileQueue::Wait()
+    {
+        while (!IsReady())
+        {
+            // Helps out with queued tasks while waiting
+            m_threading->Wait(m_workers);
+
+            // Compilations can queue more compilations, which might not have been dispatched yet
+            if (!IsReady())
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+    }
+
+    void ShaderCompileQueue::SetMaxConcurrency(const uint32_t max_concurrency)
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_max_concurrency = (std::max)(max_concurrency, 1u);
+        }
+
+        Dispatch();
+    }
+
+    void ShaderCompileQueue::Dispatch()
+    {
+        // Decide how many workers are needed, under the lock, but start them outside of it
+        // since without worker threads, the task executes right away on this thread.
+        uint32_t worker_count = 0;
+        {
+            lock_guard<mutex> lock(m_mutex);
+
+            size_t queued = 0;
+            for (const auto& queue : m_queues)
+            {
+                queued += queue.size();
+            }
+
+            while (m_running < m_max_concurrency && worker_count < queued)
+            {
+                m_running++;
+                worker_count++;
+            }
+        }
+
+        for (uint32_t i = 0; i < worker_count; i++)
+        {
+            m_threading->AddTask([this]() { WorkerLoop(); }, &m_workers);
+        }
+    }
+
+    void ShaderCompileQueue::WorkerLoop()
+    {
+        // Keep compiling until the queues are empty, highest priority first
+        while (true)
+        {
+            _item item;
+            {
+                lock_guard<mutex> lock(m_mutex);
+
+                int32_t priority = Shader_Compile_Priority_Count - 1;
+                while (priority >= 0 && m_queues[priority].empty())
+                {
+                    priority--;
+                }
+
+                // Done, retire (under the lock, so that Dispatch() sees it)
+                if (priority < 0)
+                {
+                    m_running--;
+                    return;
+                }
+
+                item = move(m_queues[priority].front());
+                m_queues[priority].pop_front();
+            }
+
+            item.compile();
+            m_pending.fetch_sub(1, memory_order_acq_rel);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======================
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "../RHI/RHI_Definition.h"
+#include "../Threading/Threading.h"
+//=================================
+
+namespace Spartan
+{
+    class Context;
+
+    // Runs shader compilations on the thread pool, highest priority first, with a cap on how many run at once
+    // so that compiling a lot of shaders (e.g. the variations of a freshly loaded world) doesn't starve other work.
+    class SPARTAN_CLASS ShaderCompileQueue
+    {
+    public:
+        ShaderCompileQueue(Context* context);
+        ~ShaderCompileQueue();
+
+        // Queue a compilation, the shader identifies it so that it can be promoted later.
+        // If the queue is destroyed before the compilation starts, cancel is called instead.
+        void Add(const RHI_Shader* shader, std::function<void()>&& compile, std::function<void()>&& cancel, const Shader_Compile_Priority priority);
+
+        // Moves a queued compilation to a higher priority, does nothing if it's already running or done
+        void Promote(const RHI_Shader* shader, const Shader_Compile_Priority priority);
+
+        // Ready barrier - true once nothing is queued or compiling, Wait() blocks until then (e.g. behind a loading screen)
+        bool IsReady()              const { return m_pending.load(std::memory_order_acquire) == 0; }
+        uint32_t GetPendingCount()  const { return m_pending.load(std::memory_order_acquire); }
+        void Wait();
+
+        // Concurrency
+        void SetMaxConcurrency(const uint32_t max_concurrency);
+        uint32_t GetMaxConcurrency() const { return m_max_concurrency; }
+
+    private:
+        struct _item
+        {
+            const RHI_Shader* shader = nullptr;
+            std::function<void()> compile;
+            std::function<void()> cancel;
+        };
+
+        void Dispatch();
+        void WorkerLoop();
+
+        std::array<std::deque<_item>, Shader_Compile_Priority_Count> m_queues;
+        std::mutex m_mutex;
+        uint32_t m_running          = 0; // guarded by m_mutex
+        uint32_t m_max_concurrency  = 1; // guarded by m_mutex
+        std::atomic<uint32_t> m_pending = 0;
+        TaskCounter m_workers;
+
+        // Dependencies
+        Threading* m_threading = nullptr;
+    };
+}
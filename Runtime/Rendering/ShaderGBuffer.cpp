@@ -22,6 +22,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =========================
 #include "Spartan.h"
 #include "ShaderGBuffer.h"
+#include "ShaderCompileQueue.h"
+#include "Renderer.h"
 #include "Material.h"
 #include "../Resource/ResourceCache.h"
 //====================================
@@ -33,23 +35,35 @@ using namespace std;
 namespace Spartan
 {
 	unordered_map<uint16_t, shared_ptr<ShaderGBuffer>> ShaderGBuffer::m_variations;
+    mutex ShaderGBuffer::m_mutex;
 
 	ShaderGBuffer::ShaderGBuffer(Context* context, const uint16_t flags /*= 0*/) : RHI_Shader(context)
 	{
         m_flags = flags;
 	}
 
-    const ShaderGBuffer* ShaderGBuffer::GenerateVariation(Context* context, const uint16_t flags)
+    const ShaderGBuffer* ShaderGBuffer::GenerateVariation(Context* context, const uint16_t flags, const Shader_Compile_Priority priority /*= Shader_Compile_Priority_Normal*/)
     {
-        // Return existing shader, if it's already compiled
-        if (m_variations.find(flags) != m_variations.end())
-            return m_variations.at(flags).get();
+        // Materials can be loaded from multiple threads
+        lock_guard<mutex> guard(m_mutex);
+
+        // Return existing shader, if it's already compiled (or queued, in which case it can be bumped up)
+        const auto it = m_variations.find(flags);
+        if (it != m_variations.end())
+        {
+            if (ShaderCompileQueue* queue = context->GetSubsystem<Renderer>()->GetShaderCompileQueue())
+            {
+                queue->Promote(it->second.get(), priority);
+            }
+
+            return it->second.get();
+        }
 
         // Compile new shader
-        return Compile(context, flags);
+        return Compile(context, flags, priority);
     }
 
-    ShaderGBuffer* ShaderGBuffer::Compile(Context* context, const uint16_t flags)
+    ShaderGBuffer* ShaderGBuffer::Compile(Context* context, const uint16_t flags, const Shader_Compile_Priority priority)
 	{
         // Shader source file path
         string file_path = context->GetSubsystem<ResourceCache>()->GetDataDirectory(Asset_Shaders) + "/GBuffer.hlsl";
@@ -68,7 +82,7 @@ namespace Spartan
         shader->AddDefine("MASK_MAP",       (flags & Material_Mask)       ? "1" : "0");
 
         // Compile
-        shader->CompileAsync(RHI_Shader_Pixel, file_path);
+        shader->CompileAsync(RHI_Shader_Pixel, file_path, priority);
 
         // Save
         m_variations[flags] = shader;
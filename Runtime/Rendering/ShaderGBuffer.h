@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <unordered_map>
+#include <mutex>
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Shader.h"
 //================================
@@ -38,13 +39,14 @@ namespace Spartan
         
         bool IsSuitable(const uint16_t flags)  { return m_flags == flags; }
 
-        static const ShaderGBuffer* GenerateVariation(Context* context, const uint16_t flags);
+        static const ShaderGBuffer* GenerateVariation(Context* context, const uint16_t flags, const Shader_Compile_Priority priority = Shader_Compile_Priority_Normal);
         static const auto& GetVariations() { return m_variations; }
 
 	private:
-        static ShaderGBuffer* Compile(Context* context, const uint16_t flags);
+        static ShaderGBuffer* Compile(Context* context, const uint16_t flags, const Shader_Compile_Priority priority);
 
         uint16_t m_flags = 0;
         static std::unordered_map<uint16_t, std::shared_ptr<ShaderGBuffer>> m_variations;
+        static std::mutex m_mutex;
 	};
 }
@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =========================
 #include "Spartan.h"
 #include "ShaderLight.h"
+#include "ShaderCompileQueue.h"
 #include "Renderer.h"
 #include "../World/Components/Light.h"
 #include "../Resource/ResourceCache.h"
@@ -34,13 +35,14 @@ using namespace std;
 namespace Spartan
 {
     unordered_map<uint16_t, shared_ptr<ShaderLight>> ShaderLight::m_variations;
+    mutex ShaderLight::m_mutex;
 
     ShaderLight::ShaderLight(Context* context, const uint16_t flags /*= 0*/) : RHI_Shader(context)
     {
         m_flags = flags;
     }
 
-    ShaderLight* ShaderLight::GetVariation(Context* context, const Light* light, const uint64_t renderer_flags)
+    ShaderLight* ShaderLight::GetVariation(Context* context, const Light* light, const uint64_t renderer_flags, const Shader_Compile_Priority priority /*= Shader_Compile_Priority_High*/)
     {
         // Compute flags
         uint16_t flags = 0;
@@ -53,15 +55,26 @@ namespace Spartan
         flags |= (light->GetVolumetricEnabled() && (renderer_flags & Render_VolumetricLighting))            ? Shader_Light_Volumetric               : flags;
         flags |= (renderer_flags & Render_ScreenSpaceReflections)                                           ? Shader_Light_ScreenSpaceReflections   : flags;
 
-        // Return existing shader, if it's already compiled
-        if (m_variations.find(flags) != m_variations.end())
-            return m_variations.at(flags).get();
+        // Variations are also precompiled when a world finishes loading, on the loading thread
+        lock_guard<mutex> guard(m_mutex);
+
+        // Return existing shader, if it's already compiled (or queued, in which case it can be bumped up)
+        const auto it = m_variations.find(flags);
+        if (it != m_variations.end())
+        {
+            if (ShaderCompileQueue* queue = context->GetSubsystem<Renderer>()->GetShaderCompileQueue())
+            {
+                queue->Promote(it->second.get(), priority);
+            }
+
+            return it->second.get();
+        }
 
         // Compile new shader
-        return Compile(context, flags);
+        return Compile(context, flags, priority);
     }
 
-    ShaderLight* ShaderLight::Compile(Context* context, const uint16_t flags)
+    ShaderLight* ShaderLight::Compile(Context* context, const uint16_t flags, const Shader_Compile_Priority priority)
     {
         // Shader source file path
         string file_path = context->GetSubsystem<ResourceCache>()->GetDataDirectory(Asset_Shaders) + "/Light.hlsl";
@@ -80,7 +93,7 @@ namespace Spartan
         shader->AddDefine("SCREEN_SPACE_REFLECTIONS",   (flags & Shader_Light_ScreenSpaceReflections)   ? "1" : "0");
 
         // Compile
-        shader->CompileAsync(RHI_Shader_Pixel, file_path);
+        shader->CompileAsync(RHI_Shader_Pixel, file_path, priority);
 
         // Save
         m_variations[flags] = shader;
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <unordered_map>
+#include <mutex>
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Shader.h"
 //================================
@@ -51,13 +52,15 @@ namespace Spartan
         ShaderLight(Context* context, const uint16_t flags = 0);
         ~ShaderLight() = default;
 
-        static ShaderLight* GetVariation(Context* context, const Light* light, const uint64_t renderer_flags);
+        // Lights ask for their variation when they are about to be drawn, so it compiles ahead of everything else by default
+        static ShaderLight* GetVariation(Context* context, const Light* light, const uint64_t renderer_flags, const Shader_Compile_Priority priority = Shader_Compile_Priority_High);
         static auto& GetVariations() { return m_variations; }
 
     private:
-        static ShaderLight* Compile(Context* context, const uint16_t flags);
+        static ShaderLight* Compile(Context* context, const uint16_t flags, const Shader_Compile_Priority priority);
 
         uint16_t m_flags = 0;
         static std::unordered_map<uint16_t, std::shared_ptr<ShaderLight>> m_variations;
+        static std::mutex m_mutex;
     };
 }
@@ -0,0 +1,352 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ================================
+#include "Spartan.h"
+#include "TextureStreamer.h"
+#include "Material.h"
+#include "Renderer.h"
+#include "../RHI/RHI_Device.h"
+#include "../RHI/RHI_Texture.h"
+#include "../RHI/RHI_SwapChain.h"
+#include "../RHI/RHI_DescriptorCache.h"
+#include "../Profiling/Profiler.h"
+#include "../World/Entity.h"
+#include "../World/Components/Camera.h"
+#include "../World/Components/Transform.h"
+#include "../World/Components/Renderable.h"
+//===========================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace _texture_streamer
+{
+    static const uint32_t reads_max             = 4;    // in flight, each one can be a whole texture's worth of I/O
+    static const uint32_t initial_size_max      = 256;  // largest side of the most detailed mip a texture starts with
+    static const float budget_default           = 0.8f; // fraction of the GPU memory, when no budget is set
+    static const int64_t megabyte               = 1024 * 1024;
+}
+
+namespace Spartan
+{
+    TextureStreamer::TextureStreamer(Context* context)
+    {
+        m_threading     = context->GetSubsystem<Threading>();
+        m_profiler      = context->GetSubsystem<Profiler>();
+        m_renderer      = context->GetSubsystem<Renderer>();
+        m_rhi_device    = m_renderer->GetRhiDevice().get();
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        // Reads in flight reference this streamer's state
+        m_threading->Wait(m_reads_counter);
+
+        // Nothing is rendering anymore, so the retired resources can go after one last wait
+        if (!m_retired.empty())
+        {
+            m_rhi_device->Queue_WaitAll();
+            DestroyRetired();
+        }
+    }
+
+    void TextureStreamer::RequestMips(const Camera* camera, const vector<Entity*>& entities, const float resolution_height)
+    {
+        if (!camera || resolution_height <= 0.0f)
+            return;
+
+        const Vector3 camera_position   = camera->GetTransform()->GetPosition();
+        const float tan_half_fov        = tan(camera->GetFovVerticalRad() * 0.5f);
+        const bool is_perspective       = camera->GetProjectionType() == Projection_Perspective;
+
+        for (Entity* entity : entities)
+        {
+            Renderable* renderable  = entity->GetRenderable();
+            Material* material      = renderable ? renderable->GetMaterial() : nullptr;
+            if (!material)
+                continue;
+
+            // Pixels covered by the bounding sphere, across
+            float pixels = resolution_height;
+            if (is_perspective)
+            {
+                const BoundingBox& aabb = renderable->GetAabb();
+                const float radius      = aabb.GetExtents().Length();
+                const float distance    = (max)(Vector3::Distance(aabb.GetCenter(), camera_position) - radius, camera->GetNearPlane());
+                pixels                  = (radius / (distance * tan_half_fov)) * resolution_height;
+            }
+
+            // A tiled texture repeats across the surface, so it needs that many more texels
+            const Vector2& tiling       = material->GetTiling();
+            const float texels_needed   = pixels * (max)((max)(tiling.x, tiling.y), 1.0f);
+
+            for (const auto& it : material->GetTextures())
+            {
+                // Textures which are still loading (possibly on another thread) are left alone until they are done
+                const shared_ptr<RHI_Texture>& texture = it.second;
+                if (!texture || texture->GetLoadState() != LoadState_Completed || !texture->IsStreamable())
+                    continue;
+
+                // Each mip halves the texels, so the most detailed mip needed is the one which still has at least as many as the screen
+                const float texels      = static_cast<float>((max)(texture->GetStreamWidth(), texture->GetStreamHeight()));
+                const float mip_exact   = texels_needed > 0.0f ? log2(texels / texels_needed) : static_cast<float>(texture->GetStreamMipCount());
+                const uint32_t mip      = static_cast<uint32_t>(Helper::Clamp(floor(mip_exact), 0.0f, static_cast<float>(texture->GetStreamMipCount() - 1)));
+
+                // The most detailed request of this frame wins
+                _texture& entry = m_textures[texture->GetId()];
+                if (entry.frame_seen != m_frame || entry.texture.expired())
+                {
+                    entry.texture       = texture;
+                    entry.frame_seen    = m_frame;
+                    entry.mip_desired   = mip;
+                }
+                else
+                {
+                    entry.mip_desired = (min)(entry.mip_desired, mip);
+                }
+            }
+        }
+    }
+
+    void TextureStreamer::Tick()
+    {
+        // Destroy replaced resources which none of the frames in flight can be using anymore
+        const uint64_t frames_in_flight = m_renderer->GetSwapChain() ? m_renderer->GetSwapChain()->GetBufferCount() : 1;
+        while (!m_retired.empty() && m_retired.front().frame + frames_in_flight < m_frame)
+        {
+            m_retired.front().destroy();
+            m_memory_delta -= m_retired.front().size;
+            m_retired.pop_front();
+        }
+
+        // Apply finished reads, the previous resources are retired instead of waiting for the GPU to let go of them
+        {
+            vector<void*> texture_views_replaced;
+            for (auto it = m_reads.begin(); it != m_reads.end();)
+            {
+                _read& read = **it;
+                if (!read.done.load(memory_order_acquire))
+                {
+                    ++it;
+                    continue;
+                }
+
+                m_memory_delta_pending -= read.size_delta;
+
+                if (read.result)
+                {
+                    _retired retired;
+                    retired.frame               = m_frame;
+                    retired.size                = static_cast<int64_t>(read.texture->GetSizeGpu());
+                    void* texture_view_previous = read.texture->Get_Resource_View();
+
+                    read.texture->StreamApply(read.mip_offset, read.mips, retired.destroy);
+                    if (read.texture->Get_Resource_View() != texture_view_previous)
+                    {
+                        texture_views_replaced.emplace_back(texture_view_previous);
+                    }
+
+                    // The memory of both resources is in use until the previous one is destroyed
+                    m_memory_delta += static_cast<int64_t>(read.texture->GetSizeGpu());
+                    if (retired.destroy)
+                    {
+                        m_retired.emplace_back(move(retired));
+                    }
+                    else
+                    {
+                        m_memory_delta -= retired.size;
+                    }
+                }
+
+                const auto entry = m_textures.find(read.texture->GetId());
+                if (entry != m_textures.end())
+                {
+                    entry->second.is_reading = false;
+                }
+
+                it = m_reads.erase(it);
+            }
+
+            // Descriptor sets which point to the previous views are stale
+            if (!texture_views_replaced.empty())
+            {
+                m_renderer->GetDescriptorCache()->RemoveDescriptorSets(texture_views_replaced);
+            }
+        }
+
+        // Forget destroyed textures, the ones which weren't seen this frame are only worth their least detailed mips
+        int64_t size_streamed = 0;
+        vector<pair<_texture*, shared_ptr<RHI_Texture>>> candidates;
+        for (auto it = m_textures.begin(); it != m_textures.end();)
+        {
+            shared_ptr<RHI_Texture> texture = it->second.texture.lock();
+            if (!texture)
+            {
+                it = m_textures.erase(it);
+                continue;
+            }
+
+            _texture& entry = it->second;
+            if (entry.frame_seen != m_frame)
+            {
+                entry.mip_desired = GetInitialMipOffset(texture->GetStreamWidth(), texture->GetStreamHeight(), texture->GetStreamMipCount());
+            }
+
+            size_streamed += static_cast<int64_t>(texture->GetSizeGpu());
+            if (!entry.is_reading && entry.mip_desired != texture->GetStreamMipOffset())
+            {
+                candidates.emplace_back(&entry, move(texture));
+            }
+
+            ++it;
+        }
+
+        // Estimate memory usage, falling back to the streamed textures alone if the API can't report it
+        const uint32_t used_mb = m_profiler->GpuGetMemoryUsed();
+        if (used_mb != m_memory_used_sample_mb)
+        {
+            m_memory_used_sample_mb = used_mb;
+            m_memory_delta          = 0;
+        }
+        int64_t usage        = (used_mb != 0 ? static_cast<int64_t>(used_mb) * _texture_streamer::megabyte + m_memory_delta : size_streamed) + m_memory_delta_pending;
+        const int64_t budget = static_cast<int64_t>(GetBudget()) * _texture_streamer::megabyte;
+
+        if (budget == 0)
+        {
+            // No budget (the GPU memory isn't known, e.g. the profiler hasn't sampled it yet), so keep what's resident
+        }
+        else if (usage > budget)
+        {
+            // Over budget - evict from the textures which were seen the longest time ago, then from the ones with the most excess detail
+            sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+            {
+                if (a.first->frame_seen != b.first->frame_seen)
+                    return a.first->frame_seen < b.first->frame_seen;
+
+                return (static_cast<int32_t>(a.first->mip_desired) - static_cast<int32_t>(a.second->GetStreamMipOffset())) >
+                       (static_cast<int32_t>(b.first->mip_desired) - static_cast<int32_t>(b.second->GetStreamMipOffset()));
+            });
+
+            for (auto& [entry, texture] : candidates)
+            {
+                if (usage <= budget || m_reads.size() >= _texture_streamer::reads_max)
+                    break;
+
+                if (entry->mip_desired <= texture->GetStreamMipOffset())
+                    continue;
+
+                Read(*entry, texture, entry->mip_desired);
+                usage += m_reads.back()->size_delta;
+            }
+        }
+        else
+        {
+            // Within budget - add detail where it's missing the most, as far as the budget allows
+            sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+            {
+                return (a.second->GetStreamMipOffset() - (min)(a.first->mip_desired, a.second->GetStreamMipOffset())) >
+                       (b.second->GetStreamMipOffset() - (min)(b.first->mip_desired, b.second->GetStreamMipOffset()));
+            });
+
+            for (auto& [entry, texture] : candidates)
+            {
+                if (m_reads.size() >= _texture_streamer::reads_max)
+                    break;
+
+                if (entry->mip_desired >= texture->GetStreamMipOffset())
+                    continue;
+
+                // Settle for less detail if the desired mips don't fit
+                for (uint32_t mip = entry->mip_desired; mip < texture->GetStreamMipOffset(); mip++)
+                {
+                    const int64_t size_delta = static_cast<int64_t>(texture->GetStreamSizeGpu(mip)) - static_cast<int64_t>(texture->GetSizeGpu());
+                    if (usage + size_delta <= budget)
+                    {
+                        Read(*entry, texture, mip);
+                        usage += size_delta;
+                        break;
+                    }
+                }
+            }
+        }
+
+        m_frame++;
+    }
+
+    void TextureStreamer::Clear()
+    {
+        m_threading->Wait(m_reads_counter);
+        m_reads.clear();
+        m_textures.clear();
+        DestroyRetired();
+        m_memory_delta          = 0;
+        m_memory_delta_pending  = 0;
+    }
+
+    uint32_t TextureStreamer::GetBudget() const
+    {
+        if (m_budget_mb != 0)
+            return m_budget_mb;
+
+        return static_cast<uint32_t>(m_profiler->GpuGetMemoryAvailable() * _texture_streamer::budget_default);
+    }
+
+    uint32_t TextureStreamer::GetInitialMipOffset(const uint32_t width, const uint32_t height, const uint32_t mip_count)
+    {
+        uint32_t mip_offset = 0;
+        while (mip_offset + 1 < mip_count && ((max)(width, height) >> mip_offset) > _texture_streamer::initial_size_max)
+        {
+            mip_offset++;
+        }
+
+        return mip_offset;
+    }
+
+    void TextureStreamer::DestroyRetired()
+    {
+        for (_retired& retired : m_retired)
+        {
+            retired.destroy();
+        }
+        m_retired.clear();
+    }
+
+    void TextureStreamer::Read(_texture& entry, const shared_ptr<RHI_Texture>& texture, const uint32_t mip_offset)
+    {
+        shared_ptr<_read> read  = make_shared<_read>();
+        read->texture           = texture;
+        read->mip_offset        = mip_offset;
+        read->size_delta        = static_cast<int64_t>(texture->GetStreamSizeGpu(mip_offset)) - static_cast<int64_t>(texture->GetSizeGpu());
+
+        entry.is_reading        = true;
+        m_memory_delta_pending  += read->size_delta;
+        m_reads.emplace_back(read);
+
+        m_threading->AddTask([read]()
+        {
+            read->result = read->texture->StreamRead(read->mip_offset, &read->mips);
+            read->done.store(true, memory_order_release);
+        }, &m_reads_counter);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ========================
+#include <deque>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include "../Threading/Threading.h"
+//===================================
+
+namespace Spartan
+{
+    class Camera;
+    class Entity;
+    class Context;
+    class Profiler;
+    class Renderer;
+    class RHI_Device;
+    class RHI_Texture;
+
+    // Keeps only the texture mips which are needed resident. A texture starts with its least detailed mips and gains detail as
+    // the renderables which use it cover more of the screen, within a GPU memory budget which, when exceeded, costs the least
+    // needed textures their detail. Mips are read from the texture's native file on the thread pool and swapped in on the main thread.
+    class SPARTAN_CLASS TextureStreamer
+    {
+    public:
+        TextureStreamer(Context* context);
+        ~TextureStreamer();
+
+        // Registers the mips that the textures of the given entities need, based on how many pixels they cover
+        void RequestMips(const Camera* camera, const std::vector<Entity*>& entities, const float resolution_height);
+
+        // Applies finished reads and issues new ones, replaced GPU resources are destroyed once the frames in flight are done with them
+        void Tick();
+
+        // Waits for the reads in flight and forgets every texture (e.g. when the world unloads), the GPU has to be idle
+        void Clear();
+
+        // Budget in MB, zero derives it from the GPU memory available (until that's known, textures don't gain detail)
+        void SetBudget(const uint32_t budget_mb) { m_budget_mb = budget_mb; }
+        uint32_t GetBudget() const;
+
+        // The most detailed mip a texture starts with, so that loading is quick and cheap
+        static uint32_t GetInitialMipOffset(const uint32_t width, const uint32_t height, const uint32_t mip_count);
+
+    private:
+        struct _texture
+        {
+            std::weak_ptr<RHI_Texture> texture;
+            uint32_t mip_desired    = 0;
+            uint64_t frame_seen     = 0;
+            bool is_reading         = false;
+        };
+
+        struct _read
+        {
+            std::shared_ptr<RHI_Texture> texture;
+            uint32_t mip_offset     = 0;
+            int64_t size_delta      = 0; // expected change in GPU memory
+            std::vector<std::vector<std::byte>> mips;
+            bool result             = false;
+            std::atomic<bool> done  = false;
+        };
+
+        struct _retired
+        {
+            std::function<void()> destroy;
+            uint64_t frame  = 0;
+            int64_t size    = 0;
+        };
+
+        void Read(_texture& entry, const std::shared_ptr<RHI_Texture>& texture, const uint32_t mip_offset);
+        void DestroyRetired();
+
+        std::unordered_map<uint32_t, _texture> m_textures; // by texture id
+        std::vector<std::shared_ptr<_read>> m_reads;
+        std::deque<_retired> m_retired;
+        TaskCounter m_reads_counter;
+        uint64_t m_frame        = 0;
+        uint32_t m_budget_mb    = 0;
+
+        // The profiler samples memory usage periodically, the bytes streamed since then are tracked on top
+        uint32_t m_memory_used_sample_mb    = 0;
+        int64_t m_memory_delta              = 0;
+        int64_t m_memory_delta_pending      = 0;
+
+        // Dependencies
+        Threading* m_threading      = nullptr;
+        Profiler* m_profiler        = nullptr;
+        Renderer* m_renderer        = nullptr;
+        RHI_Device* m_rhi_device    = nullptr;
+    };
+}
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ======================
 #include <memory>
+#include <atomic>
 #include "../Core/Context.h"
 #include "../Core/FileSystem.h"
 #include "../Core/Spartan_Object.h"
@@ -104,7 +105,8 @@ namespace Spartan
 
 
         // Misc
-		LoadState GetLoadState() const { return m_load_state; }
+		LoadState GetLoadState() const         { return m_load_state; }
+        void SetLoadState(LoadState state)      { m_load_state = state; }
 
 		// IO
 		virtual bool SaveToFile(const std::string& file_path)	{ return true; }
@@ -116,7 +118,7 @@ namespace Spartan
 
 	protected:
 		Resource_Type m_resource_type	= Resource_Unknown;
-		LoadState m_load_state			= LoadState_Idle;
+		std::atomic<LoadState> m_load_state	= LoadState_Idle;
 
 	private:
 		std::string m_resource_name;
@@ -44,7 +44,6 @@ namespace Spartan::freeimage_helper
 		uint32_t height		    = 0;
 		uint32_t channel_count	= 0;
 		vector<std::byte>* data	= nullptr;
-		bool done			    = false;
 
 		RescaleJob(const uint32_t width, const uint32_t height, const uint32_t channel_count)
 		{
@@ -289,6 +288,7 @@ namespace Spartan
 
 		// Parallelize mipmap generation using multiple threads (because FreeImage_Rescale() using FILTER_LANCZOS3 is expensive)
 		auto threading = m_context->GetSubsystem<Threading>();
+		TaskCounter counter;
 		for (auto& job : jobs)
 		{
 			threading->AddTask([this, &job, &bitmap]()
@@ -299,23 +299,11 @@ namespace Spartan
 					LOG_ERROR("Failed to create mip level %dx%d", job.width, job.height);
 				}
 				FreeImage_Unload(bitmap_scaled);
-				job.done = true;
-			});
+			}, &counter);
 		}
 
 		// Wait until all mipmaps have been generated
-		auto ready = false;
-		while (!ready)
-		{
-			ready = true;
-			for (const auto& job : jobs)
-			{
-				if (!job.done)
-				{
-					ready = false;
-				}
-			}
-		}
+		threading->Wait(counter);
 	}
 
 	FIBITMAP* ImageImporter::ApplyBitmapCorrections(FIBITMAP* bitmap) const
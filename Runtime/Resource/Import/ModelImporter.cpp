@@ -122,6 +122,9 @@ namespace Spartan
 		{
 			FIRE_EVENT(Event_World_Stop);
 
+            // Resolve the world once, after all the entities and components have been created
+            m_world->BatchBegin();
+
             params.scene            = scene;
             params.has_animation    = scene->mNumAnimations != 0;
 
@@ -143,6 +146,8 @@ namespace Spartan
             // Update model geometry
 			model->UpdateGeometry();
 
+            m_world->BatchEnd();
+
 			FIRE_EVENT(Event_World_Start);
 		}
 		else
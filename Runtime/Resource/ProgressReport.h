@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===========================
 #include <string>
+#include <atomic>
 #include <unordered_map>
 #include "../Core/Spartan_Definitions.h"
 //======================================
@@ -46,7 +47,7 @@ namespace Spartan
 		}
 
 		std::string status;
-		int jobsDone;
+		std::atomic<int> jobsDone;
 		int jobCount;
 		bool isLoading;
 	};
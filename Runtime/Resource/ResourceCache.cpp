@@ -33,6 +33,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_TextureCube.h"
 #include "../Audio/AudioClip.h"
 #include "../Rendering/Model.h"
+#include "../Threading/Threading.h"
 //=================================
 
 //= NAMESPACES ================
@@ -58,6 +59,8 @@ namespace Spartan
 		// Create project directory
 		SetProjectDirectory("Project/");
 
+        m_streaming = make_unique<TaskCounter>();
+
 		// Subscribe to events
 		SUBSCRIBE_TO_EVENT(Event_World_Save,	EVENT_HANDLER(SaveResourcesToFiles));
 		SUBSCRIBE_TO_EVENT(Event_World_Load,	EVENT_HANDLER(LoadResourcesFromFiles));
@@ -88,27 +91,35 @@ namespace Spartan
 			return false;
 		}
 
-		for (const auto& resource : m_resource_groups[resource_type])
-		{
-			if (resource_name == resource->GetResourceName())
-				return true;
-		}
-
-		return false;
+        lock_guard<mutex> guard(m_mutex);
+        const auto& names = m_resource_names[resource_type];
+        return names.find(resource_name) != names.end();
 	}
 
 	shared_ptr<IResource>& ResourceCache::GetByName(const string& name, const Resource_Type type)
 	{
-		for (auto& resource : m_resource_groups[type])
-		{
-			if (name == resource->GetResourceName())
-				return resource;
-		}
+        lock_guard<mutex> guard(m_mutex);
+        auto& names = m_resource_names[type];
+        const auto it = names.find(name);
+        if (it != names.end())
+            return it->second;
 
         static shared_ptr<IResource> empty;
 		return empty;
 	}
 
+    shared_ptr<IResource>& ResourceCache::GetByPath(const string& path, const Resource_Type type)
+    {
+        lock_guard<mutex> guard(m_mutex);
+        auto& paths = m_resource_paths[type];
+        const auto it = paths.find(GetPathKey(path));
+        if (it != paths.end())
+            return it->second;
+
+        static shared_ptr<IResource> empty;
+        return empty;
+    }
+
 	vector<shared_ptr<IResource>> ResourceCache::GetByType(const Resource_Type type /*= Resource_Unknown*/)
 	{
 		vector<shared_ptr<IResource>> resources;
@@ -130,6 +141,9 @@ namespace Spartan
 
 	void ResourceCache::SaveResourcesToFiles()
 	{
+        // Textures which are still streaming have no data to save yet
+        StreamingWait();
+
 		// Start progress report
 		ProgressReport::Get().Reset(g_progress_resource_cache);
 		ProgressReport::Get().SetIsLoading(g_progress_resource_cache, true);
@@ -185,38 +199,164 @@ namespace Spartan
 		// Load resource count
         const auto resource_count = file->ReadAs<uint32_t>();
 
-		for (uint32_t i = 0; i < resource_count; i++)
+        // Each entry is at least a string length and a type, a count which the rest of the file can't hold means that it's corrupted
+        const uint64_t entry_size_min = sizeof(uint32_t) * 2;
+        if (file->GetPosition() > file->GetSize() || resource_count > (file->GetSize() - file->GetPosition()) / entry_size_min)
+        {
+            LOG_ERROR("\"%s\" is corrupted", file_path.c_str());
+            return;
+        }
+
+        // Read the whole list first, so that loading can be scheduled by resource type
+        vector<pair<string, Resource_Type>> resources(resource_count);
+		for (auto& resource : resources)
 		{
-			// Load resource file path
-			auto file_path = file->ReadAs<string>();
+			resource.first     = file->ReadAs<string>();
+            resource.second    = static_cast<Resource_Type>(file->ReadAs<uint32_t>());
+		}
 
-			// Load resource type
-            const auto type = static_cast<Resource_Type>(file->ReadAs<uint32_t>());
+        // Start progress report
+        ProgressReport::Get().Reset(g_progress_resource_cache);
+        ProgressReport::Get().SetIsLoading(g_progress_resource_cache, true);
+        ProgressReport::Get().SetStatus(g_progress_resource_cache, "Loading resources...");
+        ProgressReport::Get().SetJobCount(g_progress_resource_cache, resource_count);
+
+        // Textures are streamed, they are cached now (without data) so that materials can reference them, and their data follows in the background.
+        // Everything else is needed by the entities which are about to be deserialized, so it's loaded before returning.
+        vector<shared_ptr<RHI_Texture>> textures;
+        vector<uint32_t> independent;
+        vector<uint32_t> materials;
+        for (uint32_t i = 0; i < resource_count; i++)
+        {
+            const string& path          = resources[i].first;
+            const Resource_Type type    = resources[i].second;
 
-			switch (type)
-			{
-			case Resource_Model:
-				Load<Model>(file_path);
-				break;
-			case Resource_Material:
-				Load<Material>(file_path);
-				break;
-			case Resource_Texture:
-				Load<RHI_Texture>(file_path);
-				break;
-			case Resource_Texture2d:
-				Load<RHI_Texture2D>(file_path);
-				break;
-			case Resource_TextureCube:
-				Load<RHI_TextureCube>(file_path);
-				break;
+            if (type == Resource_Texture || type == Resource_Texture2d || type == Resource_TextureCube)
+            {
+                if (!FileSystem::Exists(path))
+                {
+                    LOG_ERROR("\"%s\" doesn't exist.", path.c_str());
+                    continue;
+                }
+
+                shared_ptr<RHI_Texture> texture;
+                if (type == Resource_Texture)           texture = make_shared<RHI_Texture>(m_context);
+                else if (type == Resource_Texture2d)    texture = make_shared<RHI_Texture2D>(m_context);
+                else                                    texture = make_shared<RHI_TextureCube>(m_context);
+
+                // Only stream it if it wasn't already cached
+                texture->SetResourceFilePath(path);
+                texture->SetLoadState(LoadState_Started);
+                if (CacheInsert(texture, false) == texture)
+                {
+                    textures.emplace_back(texture);
+                }
+                else
+                {
+                    ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
+                }
+            }
+            else if (type == Resource_Material)
+            {
+                materials.emplace_back(i);
+            }
+            else
+            {
+                independent.emplace_back(i);
+            }
+        }
+
+        const auto load = [this, &resources](const uint32_t index)
+        {
+            const string& path = resources[index].first;
+
+            switch (resources[index].second)
+            {
+            case Resource_Model:
+                Load<Model>(path);
+                break;
+            case Resource_Material:
+                Load<Material>(path);
+                break;
             case Resource_Audio:
-                Load<AudioClip>(file_path);
+                Load<AudioClip>(path);
                 break;
-			}
-		}
+            }
+
+            ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
+        };
+
+        // Models and audio don't depend on anything, materials only need their textures to be cached
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        threading->ParallelFor(0, static_cast<uint32_t>(independent.size()), 1, [&load, &independent](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++) load(independent[i]);
+        });
+        threading->ParallelFor(0, static_cast<uint32_t>(materials.size()), 1, [&load, &materials](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++) load(materials[i]);
+        });
+
+        // Stream texture data, a texture can be used once its load state is completed
+        if (textures.empty())
+        {
+            ProgressReport::Get().SetIsLoading(g_progress_resource_cache, false);
+            return;
+        }
+
+        auto remaining = make_shared<atomic<uint32_t>>(static_cast<uint32_t>(textures.size()));
+        for (const shared_ptr<RHI_Texture>& texture : textures)
+        {
+            threading->AddTask([texture, remaining]()
+            {
+                texture->LoadFromFile(texture->GetResourceFilePathNative());
+
+                ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
+                if (remaining->fetch_sub(1) == 1)
+                {
+                    ProgressReport::Get().SetIsLoading(g_progress_resource_cache, false);
+                }
+            }, m_streaming.get());
+        }
 	}
 
+    bool ResourceCache::IsStreaming() const
+    {
+        return !m_streaming->IsDone();
+    }
+
+    void ResourceCache::StreamingWait()
+    {
+        if (IsStreaming())
+        {
+            m_context->GetSubsystem<Threading>()->Wait(*m_streaming);
+        }
+    }
+
+    shared_ptr<IResource> ResourceCache::CacheInsert(const shared_ptr<IResource>& resource, const bool save)
+    {
+        // Prevent threads from colliding in critical section
+        lock_guard<mutex> guard(m_mutex);
+
+        // Ensure that this resource is not already cached
+        const Resource_Type type    = resource->GetResourceType();
+        auto& names                 = m_resource_names[type];
+        const auto it               = names.find(resource->GetResourceName());
+        if (it != names.end())
+            return it->second;
+
+        // In order to guarantee deserialization, we save it now
+        if (save)
+        {
+            resource->SaveToFile(resource->GetResourceFilePathNative());
+        }
+
+        // Cache it
+        names[resource->GetResourceName()] = resource;
+        m_resource_paths[type][GetPathKey(resource->GetResourceFilePathNative())] = resource;
+        return m_resource_groups[type].emplace_back(resource);
+    }
+
     uint64_t ResourceCache::GetMemoryUsageCpu(Resource_Type type /*= Resource_Unknown*/)
     {
         uint64_t size = 0;
@@ -263,6 +403,17 @@ namespace Spartan
         return size;
     }
 
+    void ResourceCache::Clear()
+    {
+        // Streaming loads reference the cache (and its task counter), so they have to finish first
+        StreamingWait();
+
+        lock_guard<mutex> guard(m_mutex);
+        m_resource_groups.clear();
+        m_resource_names.clear();
+        m_resource_paths.clear();
+    }
+
     uint32_t ResourceCache::GetResourceCount(const Resource_Type type)
 	{
 		return static_cast<uint32_t>(GetByType(type).size());
@@ -298,4 +449,12 @@ namespace Spartan
 	{
 		return FileSystem::GetWorkingDirectory() + "/" + m_project_directory;
 	}
+
+    string ResourceCache::GetPathKey(const string& path)
+    {
+        // Both separators show up in serialized paths, so they are unified before hashing
+        string key = path;
+        replace(key.begin(), key.end(), '\\', '/');
+        return key;
+    }
 }
@@ -33,6 +33,7 @@ namespace Spartan
     class FontImporter;
     class ImageImporter;
     class ModelImporter;
+    class TaskCounter;
 
 	enum Asset_Type
 	{
@@ -67,16 +68,11 @@ namespace Spartan
 		std::vector<std::shared_ptr<IResource>> GetByType(Resource_Type type = Resource_Unknown);
 
 		// Get by path
+        std::shared_ptr<IResource>& GetByPath(const std::string& path, Resource_Type type);
 		template <class T>
 		std::shared_ptr<T> GetByPath(const std::string& path)
 		{
-			for (auto& resource : m_resource_groups[IResource::TypeToEnum<T>()])
-			{
-				if (path == resource->GetResourceFilePathNative())
-					return std::static_pointer_cast<T>(resource);
-			}
-
-            return nullptr;
+            return std::static_pointer_cast<T>(GetByPath(path, IResource::TypeToEnum<T>()));
 		}
 
 		// Caches resource, or replaces with existing cached resource
@@ -101,18 +97,7 @@ namespace Spartan
                 return nullptr;
             }
 
-			// Ensure that this resource is not already cached
-			if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
-				return GetByName<T>(resource->GetResourceName());
-
-            // Prevent threads from colliding in critical section
-            std::lock_guard<mutex> guard(m_mutex);
-
-            // In order to guarantee deserialization, we save it now
-            resource->SaveToFile(resource->GetResourceFilePathNative());
-
-			// Cache it
-			return static_pointer_cast<T>(m_resource_groups[resource->GetResourceType()].emplace_back(resource));
+            return std::static_pointer_cast<T>(CacheInsert(resource, true));
 		}
 		bool IsCached(const std::string& resource_name, Resource_Type resource_type);
 
@@ -122,13 +107,27 @@ namespace Spartan
             if (!resource)
                 return;
 
-            if (!IsCached(resource->GetResourceName(), resource->GetResourceType()))
+            std::lock_guard<std::mutex> guard(m_mutex);
+
+            // Only remove the lookup entries if they still point to this resource
+            const Resource_Type type    = resource->GetResourceType();
+            auto& names                 = m_resource_names[type];
+            const auto it_name          = names.find(resource->GetResourceName());
+            if (it_name == names.end() || it_name->second.get() != resource.get())
                 return;
+            names.erase(it_name);
+
+            auto& paths             = m_resource_paths[type];
+            const auto it_path      = paths.find(GetPathKey(resource->GetResourceFilePathNative()));
+            if (it_path != paths.end() && it_path->second.get() == resource.get())
+            {
+                paths.erase(it_path);
+            }
 
-            auto& vector = m_resource_groups[resource->GetResourceType()];
+            auto& vector = m_resource_groups[type];
             for (auto it = vector.begin(); it != vector.end(); it++)
             {
-                if (dynamic_cast<Spartan_Object*>((*it).get())->GetId() == resource->GetId())
+                if ((*it).get() == resource.get())
                 {
                     vector.erase(it);
                     break;
@@ -171,6 +170,10 @@ namespace Spartan
 		//= I/O ======================
 		void SaveResourcesToFiles();
 		void LoadResourcesFromFiles();
+        // Returns true while textures of the last loaded world are still being streamed in
+        bool IsStreaming() const;
+        // Blocks until all streamed textures have finished loading
+        void StreamingWait();
 		//============================
 
 		//= MISC ========================================================
@@ -178,7 +181,7 @@ namespace Spartan
         uint64_t GetMemoryUsageCpu(Resource_Type type = Resource_Unknown);
         uint64_t GetMemoryUsageGpu(Resource_Type type = Resource_Unknown);
 		// Unloads all resources
-		void Clear() { m_resource_groups.clear(); }
+		void Clear();
 		// Returns all resources of a given type
 		uint32_t GetResourceCount(Resource_Type type = Resource_Unknown);
 		//===============================================================
@@ -198,9 +201,18 @@ namespace Spartan
 		auto GetFontImporter()  const { return m_importer_font.get(); }
 
 	private:
+        // Adds a resource to the cache (or returns the already cached one), optionally saving it first
+        std::shared_ptr<IResource> CacheInsert(const std::shared_ptr<IResource>& resource, bool save);
+
+		// Lookups are keyed by name and by a normalized file path, both per resource type
+        static std::string GetPathKey(const std::string& path);
+
 		// Cache
 		std::unordered_map<Resource_Type, std::vector<std::shared_ptr<IResource>>> m_resource_groups;
+        std::unordered_map<Resource_Type, std::unordered_map<std::string, std::shared_ptr<IResource>>> m_resource_names;
+        std::unordered_map<Resource_Type, std::unordered_map<std::string, std::shared_ptr<IResource>>> m_resource_paths;
 		std::mutex m_mutex;
+        std::unique_ptr<TaskCounter> m_streaming;
 
 		// Directories
 		std::unordered_map<Asset_Type, std::string> m_standard_resource_directories;
@@ -0,0 +1,122 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======
+#include <atomic>
+#include <cstdint>
+//=================
+
+namespace Spartan
+{
+    class Task;
+
+    // A bounded Chase-Lev work-stealing deque.
+    // Only the owning thread may call Push() and Pop(), any thread may call Steal().
+    // Based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Nardelli - 2013)
+    class TaskQueue
+    {
+    public:
+        static constexpr int64_t capacity = 4096; // must be a power of two
+
+        TaskQueue()
+        {
+            for (auto& task : m_tasks)
+            {
+                task.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        // Owner only - returns false if the queue is full
+        bool Push(Task* task)
+        {
+            const int64_t bottom    = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top       = m_top.load(std::memory_order_acquire);
+
+            if (bottom - top >= capacity)
+                return false;
+
+            m_tasks[bottom & mask].store(task, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Owner only - takes the most recently pushed task (LIFO)
+        Task* Pop()
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            // Empty
+            if (top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Task* task = m_tasks[bottom & mask].load(std::memory_order_relaxed);
+
+            // Last task, race against the thieves for it
+            if (top == bottom)
+            {
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    task = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return task;
+        }
+
+        // Any thread - takes the least recently pushed task (FIFO)
+        Task* Steal()
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            Task* task = m_tasks[top & mask].load(std::memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return task;
+        }
+
+        bool IsEmpty() const { return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr int64_t mask = capacity - 1;
+
+        // Top and bottom live on separate cache lines since they are written by different threads
+        alignas(64) std::atomic<int64_t> m_top      = 0;
+        alignas(64) std::atomic<int64_t> m_bottom   = 0;
+        alignas(64) std::atomic<Task*> m_tasks[capacity];
+    };
+}
@@ -30,6 +30,16 @@ using namespace std;
 
 namespace Spartan
 {
+    namespace
+    {
+        constexpr uint32_t slot_none        = numeric_limits<uint32_t>::max();
+        constexpr uint32_t task_block_size  = 256;
+
+        // Identifies the slot of the calling thread
+        thread_local const Threading* t_threading   = nullptr;
+        thread_local uint32_t t_slot                = slot_none;
+    }
+
 	Threading::Threading(Context* context) : ISubsystem(context)
 	{
 		m_stopping	                            = false;
@@ -37,9 +47,17 @@ namespace Spartan
 		m_thread_count                          = m_thread_count_support - 1; // exclude the main (this) thread
         m_thread_names[this_thread::get_id()]   = "main";
 
+        // Slot 0 is the main thread's
+        for (uint32_t i = 0; i < m_thread_count + 1; i++)
+        {
+            m_slots.emplace_back(make_unique<_thread_slot>());
+        }
+        t_threading = this;
+        t_slot      = 0;
+
 		for (uint32_t i = 0; i < m_thread_count; i++)
 		{
-			m_threads.emplace_back(thread(&Threading::ThreadLoop, this));
+			m_threads.emplace_back(thread(&Threading::ThreadLoop, this, i + 1));
             m_thread_names[m_threads.back().get_id()] = "worker_" + to_string(i);
 		}
 
@@ -50,8 +68,8 @@ namespace Spartan
     {
         Flush(true);
 
-        // Put unique lock on task mutex.
-        unique_lock<mutex> lock(m_mutex_tasks);
+        // Put unique lock on sleep mutex.
+        unique_lock<mutex> lock(m_mutex_sleep);
 
         // Set termination flag to true.
         m_stopping = true;
@@ -70,18 +88,37 @@ namespace Spartan
 
         // Empty worker threads.
         m_threads.clear();
+
+        if (t_threading == this)
+        {
+            t_threading = nullptr;
+            t_slot      = slot_none;
+        }
     }
 
-    uint32_t Threading::GetThreadsAvailable() const
+    void Threading::Wait(const TaskCounter& counter)
     {
-        uint32_t available_threads = m_thread_count;
-
-        for (const auto& task : m_tasks)
+        while (!counter.IsDone())
         {
-            available_threads -= task->IsExecuting() ? 1 : 0;
+            // Help out while there is work
+            if (TaskExecuteOne())
+                continue;
+
+            // Nothing left to steal, the remaining tasks are executing elsewhere, so sleep until
+            // a counter completes or more work is queued (which might be what we are waiting on)
+            unique_lock<mutex> lock(m_mutex_sleep);
+            m_threads_sleeping.fetch_add(1);
+            m_threads_waiting.fetch_add(1);
+            m_condition_var.wait(lock, [this, &counter] { return counter.IsDone() || m_tasks_queued.load() > 0 || m_stopping; });
+            m_threads_waiting.fetch_sub(1);
+            m_threads_sleeping.fetch_sub(1);
         }
+    }
 
-        return available_threads;
+    uint32_t Threading::GetThreadsAvailable() const
+    {
+        const uint32_t tasks_running = static_cast<uint32_t>(max(m_tasks_running.load(memory_order_relaxed), 0));
+        return tasks_running >= m_thread_count ? 0 : m_thread_count - tasks_running;
     }
 
     void Threading::Flush(bool removed_queued /*= false*/)
@@ -89,42 +126,230 @@ namespace Spartan
         // Clear any queued tasks
         if (removed_queued)
         {
-            m_tasks.clear();
+            lock_guard<mutex> lock(m_mutex_tasks);
+
+            auto discard = [this](Task* task)
+            {
+                TaskCounter* counter = task->GetCounter();
+                m_tasks_queued.fetch_sub(1, memory_order_relaxed);
+                TaskRelease(task);
+                CounterDecrement(counter);
+            };
+
+            for (auto& slot : m_slots)
+            {
+                while (Task* task = slot->queue.Steal())
+                {
+                    discard(task);
+                }
+            }
+
+            for (Task* task : m_tasks_shared)
+            {
+                discard(task);
+            }
+            m_tasks_shared.clear();
+            m_tasks_shared_count.store(0, memory_order_relaxed);
         }
 
-        // If so, wait for them
-        while (AreTasksRunning())
+        // Wait for executing and queued tasks, helping out in the meantime
+        while (m_tasks_running.load(memory_order_acquire) > 0 || m_tasks_queued.load(memory_order_acquire) > 0)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            if (!TaskExecuteOne())
+            {
+                this_thread::yield();
+            }
         }
     }
 
-    void Threading::ThreadLoop()
+    void Threading::ThreadLoop(uint32_t slot)
     {
-        shared_ptr<Task> task;
+        t_threading = this;
+        t_slot      = slot;
+
         while (true)
         {
-            // Lock tasks mutex
-            unique_lock<mutex> lock(m_mutex_tasks);
+            // Keep working while there is work
+            if (TaskExecuteOne())
+                continue;
+
+            // Lock sleep mutex
+            unique_lock<mutex> lock(m_mutex_sleep);
 
             // Check condition on notification
-            m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+            m_threads_sleeping.fetch_add(1);
+            m_condition_var.wait(lock, [this] { return m_tasks_queued.load() > 0 || m_stopping; });
+            m_threads_sleeping.fetch_sub(1);
 
             // If m_stopping is true, it's time to shut everything down
-            if (m_stopping && m_tasks.empty())
+            if (m_stopping && m_tasks_queued.load() <= 0)
                 return;
+        }
+    }
+
+    Task* Threading::TaskAllocate()
+    {
+        const uint32_t slot_index = GetSlot();
+
+        // Threads which don't own a slot go to the heap
+        if (slot_index == slot_none)
+        {
+            Task* task      = new Task();
+            task->m_slot    = slot_none;
+            return task;
+        }
+
+        _thread_slot& slot = *m_slots[slot_index];
+
+        // Reclaim tasks which other threads have released
+        if (slot.tasks_free.empty())
+        {
+            Task* task = slot.tasks_returned.exchange(nullptr, memory_order_acquire);
+            while (task)
+            {
+                slot.tasks_free.emplace_back(task);
+                task = task->m_next;
+            }
+        }
+
+        // Grow the pool
+        if (slot.tasks_free.empty())
+        {
+            slot.task_blocks.emplace_back(make_unique<Task[]>(task_block_size));
+            Task* block = slot.task_blocks.back().get();
+            for (uint32_t i = 0; i < task_block_size; i++)
+            {
+                block[i].m_slot = slot_index;
+                slot.tasks_free.emplace_back(&block[i]);
+            }
+        }
+
+        Task* task = slot.tasks_free.back();
+        slot.tasks_free.pop_back();
+        task->m_next = nullptr;
+
+        return task;
+    }
+
+    void Threading::TaskRelease(Task* task)
+    {
+        task->Reset();
+
+        if (task->m_slot == slot_none)
+        {
+            delete task;
+            return;
+        }
 
-            // Get next task in the queue.
-            task = m_tasks.front();
+        // Released by the owner, put it straight back
+        if (task->m_slot == GetSlot())
+        {
+            m_slots[task->m_slot]->tasks_free.emplace_back(task);
+            return;
+        }
 
-            // Remove it from the queue.
-            m_tasks.pop_front();
+        // Released by another thread, hand it back to the owner
+        atomic<Task*>& returned = m_slots[task->m_slot]->tasks_returned;
+        task->m_next = returned.load(memory_order_relaxed);
+        while (!returned.compare_exchange_weak(task->m_next, task, memory_order_release, memory_order_relaxed)) {}
+    }
 
-            // Unlock the mutex
-            lock.unlock();
+    void Threading::TaskSubmit(Task* task)
+    {
+        m_tasks_queued.fetch_add(1);
 
-            // Execute the task.
-            task->Execute();
+        const uint32_t slot_index = GetSlot();
+        if (slot_index == slot_none || !m_slots[slot_index]->queue.Push(task))
+        {
+            lock_guard<mutex> lock(m_mutex_tasks);
+            m_tasks_shared.emplace_back(task);
+            m_tasks_shared_count.fetch_add(1, memory_order_release);
         }
+
+        // Wake up a thread, the lock makes sure that a thread which is about to sleep doesn't miss the notification
+        if (m_threads_sleeping.load() > 0)
+        {
+            lock_guard<mutex> lock(m_mutex_sleep);
+        }
+        m_condition_var.notify_one();
+    }
+
+    Task* Threading::TaskAcquire()
+    {
+        const uint32_t slot_index = GetSlot();
+
+        // Own queue first
+        if (slot_index != slot_none)
+        {
+            if (Task* task = m_slots[slot_index]->queue.Pop())
+                return task;
+        }
+
+        // Then steal from the others
+        const uint32_t slot_count   = static_cast<uint32_t>(m_slots.size());
+        const uint32_t slot_start   = slot_index == slot_none ? 0 : slot_index + 1;
+        for (uint32_t i = 0; i < slot_count; i++)
+        {
+            const uint32_t victim = (slot_start + i) % slot_count;
+            if (victim == slot_index)
+                continue;
+
+            if (Task* task = m_slots[victim]->queue.Steal())
+                return task;
+        }
+
+        // Finally, the shared queue
+        if (m_tasks_shared_count.load(memory_order_acquire) > 0)
+        {
+            lock_guard<mutex> lock(m_mutex_tasks);
+            if (!m_tasks_shared.empty())
+            {
+                Task* task = m_tasks_shared.front();
+                m_tasks_shared.pop_front();
+                m_tasks_shared_count.fetch_sub(1, memory_order_relaxed);
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool Threading::TaskExecuteOne()
+    {
+        Task* task = TaskAcquire();
+        if (!task)
+            return false;
+
+        m_tasks_running.fetch_add(1);
+        m_tasks_queued.fetch_sub(1);
+
+        task->Execute();
+
+        // Release before signaling, so nothing the task captured outlives the wait
+        TaskCounter* counter = task->GetCounter();
+        TaskRelease(task);
+        CounterDecrement(counter);
+
+        m_tasks_running.fetch_sub(1);
+
+        return true;
+    }
+
+    void Threading::CounterDecrement(TaskCounter* counter)
+    {
+        if (!counter)
+            return;
+
+        // The counter can be destroyed by its waiter as soon as it reaches zero, so don't touch it after this
+        if (counter->m_count.fetch_sub(1) == 1 && m_threads_waiting.load() > 0)
+        {
+            lock_guard<mutex> lock(m_mutex_sleep);
+            m_condition_var.notify_all();
+        }
+    }
+
+    uint32_t Threading::GetSlot() const
+    {
+        return t_threading == this ? t_slot : slot_none;
     }
 }
@@ -25,28 +25,100 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <deque>
+#include <atomic>
 #include <unordered_map>
 #include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include "TaskQueue.h"
 #include "../Logging/Log.h"
 #include "../Core/ISubsystem.h"
 //=============================
 
 namespace Spartan
 {
-	class Task
-	{
-	public:
-		typedef std::function<void()> function_type;
+    // Counts outstanding tasks, pass it to AddTask() and wait on it with Threading::Wait()
+    class TaskCounter
+    {
+    public:
+        TaskCounter() = default;
+        TaskCounter(const TaskCounter&) = delete;
+        TaskCounter& operator=(const TaskCounter&) = delete;
+
+        bool IsDone()       const { return m_count.load(std::memory_order_acquire) == 0; }
+        uint32_t GetCount() const { return m_count.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<uint32_t> m_count = 0;
+
+        friend class Threading;
+    };
+
+    // A type-erased callable which lives in inline storage, tasks are pooled by Threading so submitting doesn't allocate
+    class alignas(64) Task
+    {
+    public:
+        static constexpr size_t storage_size = 64;
+
+        Task() = default;
+        ~Task() { Reset(); }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
 
-		Task(function_type&& function)  { m_function = std::forward<function_type>(function); }
-        void Execute()                  { m_is_executing = true; m_function(); m_is_executing = false; }
-        bool IsExecuting() const { return m_is_executing; }
+        template <typename Function>
+        void Set(Function&& function, TaskCounter* counter)
+        {
+            using function_type = std::decay_t<Function>;
 
-	private:
-        bool m_is_executing = false;
-		function_type m_function;
-	};
+            Reset();
+
+            if constexpr (sizeof(function_type) <= storage_size && alignof(function_type) <= alignof(std::max_align_t))
+            {
+                new (m_storage) function_type(std::forward<Function>(function));
+                m_invoke    = [](void* storage) { (*static_cast<function_type*>(storage))(); };
+                m_destroy   = [](void* storage) { static_cast<function_type*>(storage)->~function_type(); };
+            }
+            else // Captures too much to fit, fall back to the heap
+            {
+                new (m_storage) function_type*(new function_type(std::forward<Function>(function)));
+                m_invoke    = [](void* storage) { (**static_cast<function_type**>(storage))(); };
+                m_destroy   = [](void* storage) { delete *static_cast<function_type**>(storage); };
+            }
+
+            m_counter = counter;
+        }
+
+        void Execute() { m_invoke(m_storage); }
+
+        void Reset()
+        {
+            if (m_destroy)
+            {
+                m_destroy(m_storage);
+            }
+
+            m_invoke    = nullptr;
+            m_destroy   = nullptr;
+            m_counter   = nullptr;
+        }
+
+        TaskCounter* GetCounter() const { return m_counter; }
+
+    private:
+        alignas(std::max_align_t) std::byte m_storage[storage_size];
+        void (*m_invoke)(void*)     = nullptr;
+        void (*m_destroy)(void*)    = nullptr;
+        TaskCounter* m_counter      = nullptr;
+
+        // Pool bookkeeping
+        Task* m_next    = nullptr;
+        uint32_t m_slot = 0;
+
+        friend class Threading;
+    };
 
 	class Threading : public ISubsystem
 	{
@@ -54,9 +126,9 @@ namespace Spartan
 		Threading(Context* context);
         ~Threading();
 
-		// Add a task
+		// Add a task, if a counter is provided it will be incremented now and decremented once the task has executed
 		template <typename Function>
-		void AddTask(Function&& function)
+		void AddTask(Function&& function, TaskCounter* counter = nullptr)
 		{
 			if (m_threads.empty())
 			{
@@ -65,53 +137,62 @@ namespace Spartan
 				return;
 			}
 
-			// Lock tasks mutex
-			std::unique_lock<std::mutex> lock(m_mutex_tasks);
-
-			// Save the task
-			m_tasks.push_back(std::make_shared<Task>(std::bind(std::forward<Function>(function))));
-
-			// Unlock the mutex
-			lock.unlock();
+            if (counter)
+            {
+                counter->m_count.fetch_add(1, std::memory_order_relaxed);
+            }
 
-			// Wake up a thread
-			m_condition_var.notify_one();
+            Task* task = TaskAllocate();
+            task->Set(std::forward<Function>(function), counter);
+            TaskSubmit(task);
 		}
 
-        // Adds a task which is a loop and executes chunks of it in parallel
+        // Executes function(start, end) over [begin, end) in chunks of at most grain elements (0 picks a grain automatically).
+        // Chunks are handed out dynamically so uneven work balances out, the calling thread processes chunks too and returns once all of them are done.
         template <typename Function>
-        void AddTaskLoop(Function&& function, uint32_t range)
+        void ParallelFor(uint32_t begin, uint32_t end, uint32_t grain, Function&& function)
         {
-            uint32_t available_threads  = GetThreadsAvailable();
-            vector<bool> tasks_done     = vector<bool>(available_threads, false);
-            const uint32_t task_count   = available_threads + 1; // plus one for the current thread
+            if (begin >= end)
+                return;
 
-            uint32_t start  = 0;
-            uint32_t end    = 0;
-            for (uint32_t i = 0; i < available_threads; i++)
+            const uint32_t range = end - begin;
+            if (grain == 0)
             {
-                start   = (range / task_count) * i;
-                end     = start + (range / task_count);
-
-                // Kick off task
-                AddTask([&function, &tasks_done, i, start, end] { function(start, end); tasks_done[i] = true; });
+                // Aim for a few chunks per thread, so that threads which finish early can pick up more
+                grain = range / ((m_thread_count + 1) * 4);
             }
+            grain = grain == 0 ? 1 : grain;
 
-            // Do last task in the current thread
-            function(end, range);
+            const uint32_t chunk_count = (range - 1) / grain + 1;
+            std::atomic<uint32_t> chunk_next = 0;
 
-            // Wait till the threads are done
-            uint32_t tasks = 0;
-            while (tasks != tasks_done.size())
+            const auto process_chunks = [&function, &chunk_next, chunk_count, begin, end, grain]()
             {
-                tasks = 0;
-                for (const bool job_done : tasks_done)
+                uint32_t chunk = 0;
+                while ((chunk = chunk_next.fetch_add(1, std::memory_order_relaxed)) < chunk_count)
                 {
-                    tasks += job_done ? 1 : 0;
+                    const uint32_t start = begin + chunk * grain;
+                    function(start, start + (std::min)(grain, end - start));
                 }
+            };
+
+            // One task per worker that can help, the calling thread takes part as well
+            TaskCounter counter;
+            const uint32_t task_count = (std::min)(m_thread_count, chunk_count - 1);
+            for (uint32_t i = 0; i < task_count; i++)
+            {
+                AddTask(process_chunks, &counter);
             }
+
+            process_chunks();
+
+            // Chunks which are still being processed by other threads
+            Wait(counter);
         }
 
+        // Blocks until the counter reaches zero, the calling thread executes queued tasks while there are any and sleeps otherwise
+        void Wait(const TaskCounter& counter);
+
         // Get the number of threads used
         uint32_t GetThreadCount()           const { return m_thread_count; }
         // Get the maximum number of threads the hardware supports
@@ -124,14 +205,39 @@ namespace Spartan
         void Flush(bool removed_queued = false);
 
 	private:
+        // Per thread state, slot 0 belongs to the thread which created the subsystem (main), the rest to the workers
+        struct _thread_slot
+        {
+            TaskQueue queue;
+            std::vector<Task*> tasks_free;                  // Only touched by the owning thread
+            std::atomic<Task*> tasks_returned = nullptr;    // Tasks released by other threads, pushed lock-free
+            std::vector<std::unique_ptr<Task[]>> task_blocks;
+        };
+
         // This function is invoked by the threads
-        void ThreadLoop();
+        void ThreadLoop(uint32_t slot);
+
+        Task* TaskAllocate();
+        void TaskRelease(Task* task);
+        void TaskSubmit(Task* task);
+        Task* TaskAcquire();
+        bool TaskExecuteOne();
+        void CounterDecrement(TaskCounter* counter);
+        uint32_t GetSlot() const;
 
 		uint32_t m_thread_count         = 0;
         uint32_t m_thread_count_support = 0;
 		std::vector<std::thread> m_threads;
-		std::deque<std::shared_ptr<Task>> m_tasks;
+        std::vector<std::unique_ptr<_thread_slot>> m_slots;
+        std::atomic<int32_t> m_tasks_queued     = 0;
+        std::atomic<int32_t> m_tasks_running    = 0;
+        std::atomic<uint32_t> m_threads_sleeping = 0;
+        std::atomic<uint32_t> m_threads_waiting = 0;
+        // Overflow queue for threads which don't own a slot or when a slot's queue is full
+		std::deque<Task*> m_tasks_shared;
+        std::atomic<uint32_t> m_tasks_shared_count = 0;
 		std::mutex m_mutex_tasks;
+        std::mutex m_mutex_sleep;
 		std::condition_variable m_condition_var;
         std::unordered_map<std::thread::id, std::string> m_thread_names;
 		bool m_stopping;
@@ -29,4 +29,22 @@ namespace Spartan::Utility::Hash
         std::hash<T> hasher;
         seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
     }
+
+    // FNV-1a, unlike std::hash it's stable across runs and compilers, so it can be used for anything persisted to disk
+    inline uint64_t fnv1a(const void* data, const size_t size, uint64_t hash = 0xcbf29ce484222325)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3;
+        }
+
+        return hash;
+    }
+
+    inline uint64_t fnv1a(const std::string& str, const uint64_t hash = 0xcbf29ce484222325)
+    {
+        return fnv1a(str.data(), str.size(), hash);
+    }
 }
@@ -0,0 +1,129 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =========================
+#include <vector>
+#include <array>
+#include "../Threading/Threading.h"
+//====================================
+
+namespace Spartan::Utility::Sort
+{
+    // Sorts items by their 64-bit key member, ascending and stable. It's an LSD radix sort with one pass per byte,
+    // bytes which are the same for every item are skipped. Large inputs are split into chunks which are
+    // counted and scattered in parallel (when a threading subsystem is provided).
+    template <typename T>
+    void Radix(std::vector<T>& items, std::vector<T>& scratch, Threading* threading = nullptr)
+    {
+        const uint32_t count = static_cast<uint32_t>(items.size());
+        if (count <= 1)
+            return;
+
+        scratch.resize(count);
+
+        // Find the bytes which differ between items, the rest don't need a pass
+        uint64_t bits_and   = ~0ull;
+        uint64_t bits_or    = 0;
+        for (const T& item : items)
+        {
+            bits_and    &= item.key;
+            bits_or     |= item.key;
+        }
+        const uint64_t bits_varying = bits_and ^ bits_or;
+
+        const uint32_t chunk_size_min   = 16384;
+        const uint32_t chunk_count      = (threading && count > chunk_size_min) ? (std::min)(threading->GetThreadCount() + 1, (count + chunk_size_min - 1) / chunk_size_min) : 1;
+        const uint32_t chunk_size       = (count + chunk_count - 1) / chunk_count;
+        std::vector<std::array<uint32_t, 256>> histograms(chunk_count);
+
+        T* source       = items.data();
+        T* destination  = scratch.data();
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            if (((bits_varying >> shift) & 0xFF) == 0)
+                continue;
+
+            const auto for_each_chunk = [&](auto&& function)
+            {
+                const auto process = [&](uint32_t chunk_start, uint32_t chunk_end)
+                {
+                    for (uint32_t chunk = chunk_start; chunk < chunk_end; chunk++)
+                    {
+                        const uint32_t start = chunk * chunk_size;
+                        function(chunk, start, (std::min)(start + chunk_size, count));
+                    }
+                };
+
+                if (chunk_count > 1)
+                {
+                    threading->ParallelFor(0, chunk_count, 1, process);
+                }
+                else
+                {
+                    process(0, 1);
+                }
+            };
+
+            // Count the digits of each chunk
+            for_each_chunk([&](uint32_t chunk, uint32_t start, uint32_t end)
+            {
+                std::array<uint32_t, 256>& histogram = histograms[chunk];
+                histogram.fill(0);
+                for (uint32_t i = start; i < end; i++)
+                {
+                    histogram[(source[i].key >> shift) & 0xFF]++;
+                }
+            });
+
+            // Turn the counts into offsets, digit major and chunk minor so that the order within a digit is preserved
+            uint32_t offset = 0;
+            for (uint32_t digit = 0; digit < 256; digit++)
+            {
+                for (std::array<uint32_t, 256>& histogram : histograms)
+                {
+                    const uint32_t digit_count  = histogram[digit];
+                    histogram[digit]            = offset;
+                    offset                      += digit_count;
+                }
+            }
+
+            // Scatter, every chunk writes to its own ranges
+            for_each_chunk([&](uint32_t chunk, uint32_t start, uint32_t end)
+            {
+                std::array<uint32_t, 256>& histogram = histograms[chunk];
+                for (uint32_t i = start; i < end; i++)
+                {
+                    destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+                }
+            });
+
+            std::swap(source, destination);
+        }
+
+        // An odd number of passes leaves the result in the scratch buffer
+        if (source != items.data())
+        {
+            items.swap(scratch);
+        }
+    }
+}
@@ -0,0 +1,476 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==============
+#include "Spartan.h"
+#include "Bvh.h"
+#include "Entity.h"
+//=========================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace Spartan
+{
+    namespace
+    {
+        // Traversal stack, per thread so that queries can run in parallel (and without allocating, once it has grown)
+        thread_local vector<uint32_t> t_stack;
+
+        BoundingBox merge(const BoundingBox& a, const BoundingBox& b)
+        {
+            BoundingBox merged = a;
+            merged.Merge(b);
+            return merged;
+        }
+
+        // Surface area, the cost metric of the tree
+        float area(const BoundingBox& box)
+        {
+            const Vector3 size = box.GetSize();
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        // Enlarge the box so that small movements don't require the tree to change
+        BoundingBox enlarge(const BoundingBox& box)
+        {
+            const Vector3 margin = Vector3(0.1f) + box.GetSize() * 0.1f;
+            return BoundingBox(box.GetMin() - margin, box.GetMax() + margin);
+        }
+
+        bool overlaps_sphere(const BoundingBox& box, const Vector3& center, const float radius)
+        {
+            const Vector3 closest = Vector3(
+                Helper::Clamp(center.x, box.GetMin().x, box.GetMax().x),
+                Helper::Clamp(center.y, box.GetMin().y, box.GetMax().y),
+                Helper::Clamp(center.z, box.GetMin().z, box.GetMax().z)
+            );
+
+            return (closest - center).LengthSquared() <= radius * radius;
+        }
+    }
+
+    void Bvh::Insert(Entity* entity, const BoundingBox& box)
+    {
+        if (Contains(entity))
+        {
+            Update(entity, box);
+            return;
+        }
+
+        const uint32_t leaf     = NodeAllocate();
+        _node& node             = m_nodes[leaf];
+        node.box                = enlarge(box);
+        node.box_entity         = box;
+        node.entity             = entity;
+        node.height             = 0;
+
+        LeafInsert(leaf);
+        m_leaves[entity] = leaf;
+    }
+
+    void Bvh::Remove(Entity* entity)
+    {
+        const auto it = m_leaves.find(entity);
+        if (it == m_leaves.end())
+            return;
+
+        LeafRemove(it->second);
+        NodeFree(it->second);
+        m_leaves.erase(it);
+    }
+
+    void Bvh::Update(Entity* entity, const BoundingBox& box)
+    {
+        const auto it = m_leaves.find(entity);
+        if (it == m_leaves.end())
+        {
+            Insert(entity, box);
+            return;
+        }
+
+        const uint32_t leaf = it->second;
+        m_nodes[leaf].box_entity = box;
+
+        // Still within the enlarged box, the tree remains valid
+        if (m_nodes[leaf].box.IsInside(box) == Inside)
+            return;
+
+        LeafRemove(leaf);
+        m_nodes[leaf].box = enlarge(box);
+        LeafInsert(leaf);
+    }
+
+    void Bvh::Clear()
+    {
+        m_nodes.clear();
+        m_leaves.clear();
+        m_root      = node_null;
+        m_free_list = node_null;
+    }
+
+    void Bvh::QueryRay(const Ray& ray, vector<RayHit>& hits) const
+    {
+        Traverse
+        (
+            [&ray](const BoundingBox& box) { return ray.HitDistance(box) != INFINITY; },
+            [&ray, &hits](const _node& node)
+            {
+                const float distance = ray.HitDistance(node.box_entity);
+                if (distance == INFINITY)
+                    return;
+
+                hits.emplace_back(
+                    node.entity->GetPtrShared(),                        // Entity
+                    ray.GetStart() + distance * ray.GetDirection(),     // Position
+                    distance,                                           // Distance
+                    distance == 0.0f                                    // Inside
+                );
+            }
+        );
+    }
+
+    void Bvh::QueryFrustum(const Frustum& frustum, vector<Entity*>& entities) const
+    {
+        Traverse
+        (
+            [&frustum](const BoundingBox& box) { return frustum.IsVisible(box.GetCenter(), box.GetExtents()); },
+            [&frustum, &entities](const _node& node)
+            {
+                if (frustum.IsVisible(node.box_entity.GetCenter(), node.box_entity.GetExtents()))
+                {
+                    entities.emplace_back(node.entity);
+                }
+            }
+        );
+    }
+
+    void Bvh::QueryOverlap(const BoundingBox& box, vector<Entity*>& entities) const
+    {
+        Traverse
+        (
+            [&box](const BoundingBox& node_box) { return box.IsInside(node_box) != Outside; },
+            [&box, &entities](const _node& node)
+            {
+                if (box.IsInside(node.box_entity) != Outside)
+                {
+                    entities.emplace_back(node.entity);
+                }
+            }
+        );
+    }
+
+    void Bvh::QueryOverlap(const Vector3& center, const float radius, vector<Entity*>& entities) const
+    {
+        Traverse
+        (
+            [&center, radius](const BoundingBox& box) { return overlaps_sphere(box, center, radius); },
+            [&center, radius, &entities](const _node& node)
+            {
+                if (overlaps_sphere(node.box_entity, center, radius))
+                {
+                    entities.emplace_back(node.entity);
+                }
+            }
+        );
+    }
+
+    template <typename Overlaps, typename Visit>
+    void Bvh::Traverse(Overlaps&& overlaps, Visit&& visit) const
+    {
+        if (m_root == node_null)
+            return;
+
+        t_stack.clear();
+        t_stack.emplace_back(m_root);
+
+        while (!t_stack.empty())
+        {
+            const _node& node = m_nodes[t_stack.back()];
+            t_stack.pop_back();
+
+            if (!overlaps(node.box))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                visit(node);
+            }
+            else
+            {
+                t_stack.emplace_back(node.child_left);
+                t_stack.emplace_back(node.child_right);
+            }
+        }
+    }
+
+    uint32_t Bvh::NodeAllocate()
+    {
+        if (m_free_list == node_null)
+        {
+            m_nodes.emplace_back();
+            return static_cast<uint32_t>(m_nodes.size() - 1);
+        }
+
+        const uint32_t index    = m_free_list;
+        m_free_list             = m_nodes[index].parent;
+        m_nodes[index]          = _node();
+        return index;
+    }
+
+    void Bvh::NodeFree(const uint32_t index)
+    {
+        m_nodes[index]          = _node();
+        m_nodes[index].parent   = m_free_list;
+        m_free_list             = index;
+    }
+
+    void Bvh::LeafInsert(const uint32_t leaf)
+    {
+        if (m_root == node_null)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = node_null;
+            return;
+        }
+
+        // Find the best sibling, descending towards the child which increases the total surface area the least
+        const BoundingBox box_leaf = m_nodes[leaf].box;
+        uint32_t index = m_root;
+        while (!m_nodes[index].IsLeaf())
+        {
+            const _node& node = m_nodes[index];
+
+            const float area_combined   = area(merge(node.box, box_leaf));
+            const float cost            = 2.0f * area_combined;                         // creating a new parent for this node and the leaf
+            const float cost_inherited  = 2.0f * (area_combined - area(node.box));      // pushing the leaf further down
+
+            const auto cost_child = [&box_leaf, cost_inherited](const _node& child)
+            {
+                const float area_merged = area(merge(child.box, box_leaf));
+                return (child.IsLeaf() ? area_merged : area_merged - area(child.box)) + cost_inherited;
+            };
+            const float cost_left   = cost_child(m_nodes[node.child_left]);
+            const float cost_right  = cost_child(m_nodes[node.child_right]);
+
+            if (cost < cost_left && cost < cost_right)
+                break;
+
+            index = cost_left < cost_right ? node.child_left : node.child_right;
+        }
+        const uint32_t sibling = index;
+
+        // Create a new parent for the sibling and the leaf
+        const uint32_t parent_old   = m_nodes[sibling].parent;
+        const uint32_t parent_new   = NodeAllocate();
+        _node& parent               = m_nodes[parent_new];
+        parent.parent               = parent_old;
+        parent.box                  = merge(box_leaf, m_nodes[sibling].box);
+        parent.height               = m_nodes[sibling].height + 1;
+        parent.child_left           = sibling;
+        parent.child_right          = leaf;
+        m_nodes[sibling].parent     = parent_new;
+        m_nodes[leaf].parent        = parent_new;
+
+        if (parent_old != node_null)
+        {
+            if (m_nodes[parent_old].child_left == sibling)
+            {
+                m_nodes[parent_old].child_left = parent_new;
+            }
+            else
+            {
+                m_nodes[parent_old].child_right = parent_new;
+            }
+        }
+        else
+        {
+            m_root = parent_new;
+        }
+
+        // Walk back up, fixing heights and boxes
+        index = m_nodes[leaf].parent;
+        while (index != node_null)
+        {
+            index = Balance(index);
+
+            _node& node = m_nodes[index];
+            node.height = 1 + Helper::Max(m_nodes[node.child_left].height, m_nodes[node.child_right].height);
+            node.box    = merge(m_nodes[node.child_left].box, m_nodes[node.child_right].box);
+
+            index = node.parent;
+        }
+    }
+
+    void Bvh::LeafRemove(const uint32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = node_null;
+            return;
+        }
+
+        const uint32_t parent       = m_nodes[leaf].parent;
+        const uint32_t grandparent  = m_nodes[parent].parent;
+        const uint32_t sibling      = m_nodes[parent].child_left == leaf ? m_nodes[parent].child_right : m_nodes[parent].child_left;
+
+        // The sibling takes the place of the parent
+        NodeFree(parent);
+        m_nodes[sibling].parent = grandparent;
+
+        if (grandparent == node_null)
+        {
+            m_root = sibling;
+            return;
+        }
+
+        if (m_nodes[grandparent].child_left == parent)
+        {
+            m_nodes[grandparent].child_left = sibling;
+        }
+        else
+        {
+            m_nodes[grandparent].child_right = sibling;
+        }
+
+        // Walk back up, fixing heights and boxes
+        uint32_t index = grandparent;
+        while (index != node_null)
+        {
+            index = Balance(index);
+
+            _node& node = m_nodes[index];
+            node.height = 1 + Helper::Max(m_nodes[node.child_left].height, m_nodes[node.child_right].height);
+            node.box    = merge(m_nodes[node.child_left].box, m_nodes[node.child_right].box);
+
+            index = node.parent;
+        }
+    }
+
+    // Performs a left or right rotation if the node is imbalanced, returns the index of the node which took its place
+    uint32_t Bvh::Balance(const uint32_t index_a)
+    {
+        _node& a = m_nodes[index_a];
+        if (a.IsLeaf() || a.height < 2)
+            return index_a;
+
+        const uint32_t index_b  = a.child_left;
+        const uint32_t index_c  = a.child_right;
+        _node& b                = m_nodes[index_b];
+        _node& c                = m_nodes[index_c];
+        const int32_t balance   = c.height - b.height;
+
+        // Replaces a with its child in the parent of a
+        const auto promote = [this, &a, index_a](const uint32_t index_child)
+        {
+            _node& child    = m_nodes[index_child];
+            child.parent    = a.parent;
+            a.parent        = index_child;
+
+            if (child.parent == node_null)
+            {
+                m_root = index_child;
+            }
+            else if (m_nodes[child.parent].child_left == index_a)
+            {
+                m_nodes[child.parent].child_left = index_child;
+            }
+            else
+            {
+                m_nodes[child.parent].child_right = index_child;
+            }
+        };
+
+        // Rotate c up
+        if (balance > 1)
+        {
+            const uint32_t index_f  = c.child_left;
+            const uint32_t index_g  = c.child_right;
+            _node& f                = m_nodes[index_f];
+            _node& g                = m_nodes[index_g];
+
+            c.child_left = index_a;
+            promote(index_c);
+
+            if (f.height > g.height)
+            {
+                c.child_right   = index_f;
+                a.child_right   = index_g;
+                g.parent        = index_a;
+                a.box           = merge(b.box, g.box);
+                c.box           = merge(a.box, f.box);
+                a.height        = 1 + Helper::Max(b.height, g.height);
+                c.height        = 1 + Helper::Max(a.height, f.height);
+            }
+            else
+            {
+                c.child_right   = index_g;
+                a.child_right   = index_f;
+                f.parent        = index_a;
+                a.box           = merge(b.box, f.box);
+                c.box           = merge(a.box, g.box);
+                a.height        = 1 + Helper::Max(b.height, f.height);
+                c.height        = 1 + Helper::Max(a.height, g.height);
+            }
+
+            return index_c;
+        }
+
+        // Rotate b up
+        if (balance < -1)
+        {
+            const uint32_t index_d  = b.child_left;
+            const uint32_t index_e  = b.child_right;
+            _node& d                = m_nodes[index_d];
+            _node& e                = m_nodes[index_e];
+
+            b.child_left = index_a;
+            promote(index_b);
+
+            if (d.height > e.height)
+            {
+                b.child_right   = index_d;
+                a.child_left    = index_e;
+                e.parent        = index_a;
+                a.box           = merge(c.box, e.box);
+                b.box           = merge(a.box, d.box);
+                a.height        = 1 + Helper::Max(c.height, e.height);
+                b.height        = 1 + Helper::Max(a.height, d.height);
+            }
+            else
+            {
+                b.child_right   = index_e;
+                a.child_left    = index_d;
+                d.parent        = index_a;
+                a.box           = merge(c.box, d.box);
+                b.box           = merge(a.box, e.box);
+                a.height        = 1 + Helper::Max(c.height, d.height);
+                b.height        = 1 + Helper::Max(a.height, e.height);
+            }
+
+            return index_b;
+        }
+
+        return index_a;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <unordered_map>
+#include "../Math/BoundingBox.h"
+//================================
+
+namespace Spartan
+{
+    class Entity;
+
+    namespace Math
+    {
+        class Ray;
+        class RayHit;
+        class Frustum;
+    }
+
+    // Dynamic bounding volume hierarchy over entity bounding boxes.
+    // Leaves store a slightly enlarged box, so small movements don't require the tree to change.
+    class SPARTAN_CLASS Bvh
+    {
+    public:
+        Bvh() = default;
+        ~Bvh() = default;
+
+        // Entities
+        void Insert(Entity* entity, const Math::BoundingBox& box);
+        void Remove(Entity* entity);
+        void Update(Entity* entity, const Math::BoundingBox& box);
+        void Clear();
+        bool Contains(Entity* entity) const { return m_leaves.find(entity) != m_leaves.end(); }
+        uint32_t GetCount()           const { return static_cast<uint32_t>(m_leaves.size()); }
+
+        // Queries - The entities are appended to the provided vector
+        void QueryRay(const Math::Ray& ray, std::vector<Math::RayHit>& hits) const;
+        void QueryFrustum(const Math::Frustum& frustum, std::vector<Entity*>& entities) const;
+        void QueryOverlap(const Math::BoundingBox& box, std::vector<Entity*>& entities) const;
+        void QueryOverlap(const Math::Vector3& center, float radius, std::vector<Entity*>& entities) const;
+
+    private:
+        struct _node
+        {
+            bool IsLeaf() const { return child_left == node_null; }
+
+            Math::BoundingBox box;                  // enlarged for leaves
+            Math::BoundingBox box_entity;           // leaves only
+            Entity* entity          = nullptr;
+            uint32_t parent         = node_null;    // next free node, when the node is not in use
+            uint32_t child_left     = node_null;
+            uint32_t child_right    = node_null;
+            int32_t height          = -1;           // leaves are 0, free nodes are -1
+        };
+
+        uint32_t NodeAllocate();
+        void NodeFree(uint32_t index);
+        void LeafInsert(uint32_t leaf);
+        void LeafRemove(uint32_t leaf);
+        uint32_t Balance(uint32_t index);
+        template <typename Overlaps, typename Visit>
+        void Traverse(Overlaps&& overlaps, Visit&& visit) const;
+
+        static const uint32_t node_null = 0xFFFFFFFF;
+
+        std::vector<_node> m_nodes;
+        std::unordered_map<Entity*, uint32_t> m_leaves;
+        uint32_t m_root         = node_null;
+        uint32_t m_free_list    = node_null;
+    };
+}
@@ -115,6 +115,7 @@ namespace Spartan
 		//= MISC ==============================================================================
 		bool IsInViewFrustrum(Renderable* renderable) const;
 		bool IsInViewFrustrum(const Math::Vector3& center, const Math::Vector3& extents) const;
+        uint32_t IsInViewFrustrum(const Math::BoundingBoxSoA& boxes, uint32_t offset) const { return m_frustrum.IsVisible(boxes, offset); }
 		const Math::Vector4& GetClearColor() const		{ return m_clear_color; }
 		void SetClearColor(const Math::Vector4& color)	{ m_clear_color = color; }
         bool GetFpsControl()                 const { return m_fps_control; }
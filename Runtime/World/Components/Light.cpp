@@ -497,4 +497,12 @@ namespace Spartan
 
         return m_shadow_map.slices[index].frustum.IsVisible(center, extents, ignore_near_plane);
     }
+
+    uint32_t Light::IsInViewFrustrum(const BoundingBoxSoA& boxes, uint32_t offset, uint32_t index) const
+    {
+        // ensure that potential shadow casters from behind the near plane are not rejected
+        const bool ignore_near_plane = m_light_type == LightType_Directional;
+
+        return m_shadow_map.slices[index].frustum.IsVisible(boxes, offset, ignore_near_plane);
+    }
 }  
@@ -122,6 +122,7 @@ namespace Spartan
         void CreateShadowMap();
 
         bool IsInViewFrustrum(Renderable* renderable, uint32_t index) const;
+        uint32_t IsInViewFrustrum(const Math::BoundingBoxSoA& boxes, uint32_t offset, uint32_t index) const;
 
 	private:
 		void ComputeViewMatrix();
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "Renderable.h"
 #include "Transform.h"
+#include "../World.h"
 #include "../../IO/FileStream.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Utilities/Geometry.h"
@@ -234,6 +235,12 @@ namespace Spartan
 
         // Set to false otherwise material won't serialize/deserialize
         m_material_default = false;
+
+        // The renderer classifies entities by their material
+        if (World* world = m_context->GetSubsystem<World>())
+        {
+            world->ResolvePending(m_entity);
+        }
 	}
 
 	shared_ptr<Material> Renderable::SetMaterial(const string& file_path)
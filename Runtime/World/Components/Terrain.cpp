@@ -110,9 +110,9 @@ namespace Spartan
                 LOG_ERROR("Height map has no data");
             }
 
-            // Deduce some stuff
-            m_height                            = m_height_map->GetHeight();
-            m_width                             = m_height_map->GetWidth();
+            // Deduce some stuff (mip 0 is read from the file, so use the full dimensions if the height map streams)
+            m_height                            = m_height_map->IsStreamable() ? m_height_map->GetStreamHeight() : m_height_map->GetHeight();
+            m_width                             = m_height_map->IsStreamable() ? m_height_map->GetStreamWidth() : m_height_map->GetWidth();
             m_vertex_count                      = m_height * m_width;
             m_face_count                        = (m_height - 1) * (m_width - 1) * 2;
             m_progress_jobs_done                = 0;
@@ -375,7 +375,7 @@ namespace Spartan
             }
         };
 
-        m_context->GetSubsystem<Threading>()->AddTaskLoop(compute_vertex_normals_tangents, vertex_count);
+        m_context->GetSubsystem<Threading>()->ParallelFor(0, vertex_count, 64, compute_vertex_normals_tangents);
 
         return true;
     }
@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===================
 #include "Spartan.h"
+#include <mutex>
 #include "Transform.h"
 #include "../World.h"
 #include "../Entity.h"
@@ -34,6 +35,12 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    namespace _transform
+    {
+        // Serializes on demand resolves, recursive since resolving a transform resolves its parents first
+        static recursive_mutex resolve_mutex;
+    }
+
 	Transform::Transform(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id, this)
 	{
 		m_positionLocal		= Vector3::Zero;
@@ -44,9 +51,9 @@ namespace Spartan
 		m_wvp_previous		= Matrix::Identity;
 		m_parent			= nullptr;
 
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_positionLocal,	Vector3);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotationLocal,	Quaternion);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_scaleLocal, Vector3);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_positionLocal, SetPositionLocal, Vector3);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_rotationLocal, SetRotationLocal, Quaternion);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_scaleLocal, SetScaleLocal, Vector3);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrix, Matrix);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrixLocal, Matrix);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt, Vector3);
@@ -84,15 +91,28 @@ namespace Spartan
 			}
 		}
 
-		UpdateTransform();
+		MakeDirty();
 	}
 	//===============================================================================================
-	void Transform::UpdateTransform()
+	void Transform::UpdateTransform() const
 	{
+		if (!m_is_dirty)
+			return;
+
+		lock_guard<recursive_mutex> lock(_transform::resolve_mutex);
+		Resolve();
+	}
+
+	void Transform::Resolve() const
+	{
+		// Another thread might have resolved it while waiting for the lock
+		if (!m_is_dirty)
+			return;
+
 		// Compute local transform
 		m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
 
-		// Compute world transform
+		// Compute world transform (this will update the parent first, if it's dirty)
 		if (!HasParent())
 		{
 			m_matrix = m_matrixLocal;
@@ -101,11 +121,23 @@ namespace Spartan
 		{
 			m_matrix = m_matrixLocal * GetParentTransformMatrix();
 		}
-		
-		// Update children
-		for (const auto& child : m_children)
+
+		m_is_dirty = false;
+	}
+
+	void Transform::MakeDirty()
+	{
+		m_has_changed = true;
+
+		// A dirty transform always has dirty descendants, so there is nothing more to do
+		if (m_is_dirty)
+			return;
+
+		m_is_dirty = true;
+
+		for (Transform* child : m_children)
 		{
-			child->UpdateTransform();
+			child->MakeDirty();
 		}
 	}
 
@@ -124,7 +156,7 @@ namespace Spartan
 			return;
 
 		m_positionLocal = position;
-		UpdateTransform();
+		MakeDirty();
 	}
 	//================================================================================================
 
@@ -143,7 +175,7 @@ namespace Spartan
 			return;
 
 		m_rotationLocal = rotation;
-		UpdateTransform();
+		MakeDirty();
 	}
 	//================================================================================================
 
@@ -168,7 +200,7 @@ namespace Spartan
 		m_scaleLocal.y = (m_scaleLocal.y == 0.0f) ? Helper::M_EPSILON : m_scaleLocal.y;
 		m_scaleLocal.z = (m_scaleLocal.z == 0.0f) ? Helper::M_EPSILON : m_scaleLocal.z;
 
-		UpdateTransform();
+		MakeDirty();
 	}
 	//================================================================================================
 
@@ -279,15 +311,22 @@ namespace Spartan
 		// Switch parent but keep a pointer to the old one
 		auto parent_old = m_parent;
 		m_parent = new_parent;
-		if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
 
-		// make the new parent "aware" of this transform/child
-		if (m_parent)
+		// While the world is batching, children lists are rebuilt once the batch ends
+		World* world = GetContext()->GetSubsystem<World>();
+		if (!world->IsBatching())
 		{
-			m_parent->AcquireChildren();
+			if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
+
+			// make the new parent "aware" of this transform/child
+			if (m_parent)
+			{
+				m_parent->AcquireChildren();
+			}
 		}
 
-		UpdateTransform();
+		MakeDirty();
+		world->MakeHierarchyDirty();
 	}
 
 	void Transform::AddChild(Transform* child)
@@ -412,12 +451,14 @@ namespace Spartan
 		m_parent = nullptr;
 
 		// Update the transform without the parent now
-		UpdateTransform();
+		MakeDirty();
+		World* world = GetContext()->GetSubsystem<World>();
+		world->MakeHierarchyDirty();
 
 		// make the parent search for children,
 		// that's indirect way of making the parent "forget"
 		// about this child, since it won't be able to find it
-		if (temp_ref)
+		if (temp_ref && !world->IsBatching())
 		{
 			temp_ref->AcquireChildren();
 		}
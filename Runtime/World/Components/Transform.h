@@ -46,24 +46,32 @@ namespace Spartan
 		void Deserialize(FileStream* stream) override;
 		//============================================
 
-		void UpdateTransform();
+		// Computes the local and world matrices, if anything affecting them changed since they were last computed.
+		// The getters do this on demand, concurrent calls are serialized, but the world and the renderer resolve
+		// everything upfront, so that readers which run in parallel find the transforms resolved and only read them.
+		void UpdateTransform() const;
+		bool IsDirty() const { return m_is_dirty; }
+
+		// Set whenever the transform changes, the world resets it once it has processed the change
+		bool HasChanged() const	{ return m_has_changed; }
+		void ResetChanged()		{ m_has_changed = false; }
 
 		//= POSITION ==============================================================
-		auto GetPosition()              const { return m_matrix.GetTranslation(); }
+		auto GetPosition()              const { return GetMatrix().GetTranslation(); }
 		const auto& GetPositionLocal()  const { return m_positionLocal; }
 		void SetPosition(const Math::Vector3& position);
 		void SetPositionLocal(const Math::Vector3& position);
 		//=========================================================================
 
 		//= ROTATION ===========================================================
-		Math::Quaternion GetRotation() const { return m_matrix.GetRotation(); }
+		Math::Quaternion GetRotation() const { return GetMatrix().GetRotation(); }
 		const auto& GetRotationLocal() const { return m_rotationLocal; }
 		void SetRotation(const Math::Quaternion& rotation);
 		void SetRotationLocal(const Math::Quaternion& rotation);
 		//======================================================================
 
 		//= SCALE =======================================================
-		auto GetScale()             const { return m_matrix.GetScale(); }
+		auto GetScale()             const { return GetMatrix().GetScale(); }
 		const auto& GetScaleLocal() const { return m_scaleLocal; }
 		void SetScale(const Math::Vector3& scale);
 		void SetScaleLocal(const Math::Vector3& scale);
@@ -103,26 +111,35 @@ namespace Spartan
 		//======================================================================================
 
 		void LookAt(const Math::Vector3& v)                       { m_lookAt = v; }
-		const Math::Matrix& GetMatrix()                     const { return m_matrix; }     
-		const Math::Matrix& GetLocalMatrix()                const { return m_matrixLocal; }
+		const Math::Matrix& GetMatrix()                     const { UpdateTransform(); return m_matrix; }
+		const Math::Matrix& GetLocalMatrix()                const { UpdateTransform(); return m_matrixLocal; }
         const Math::Matrix& GetWvpLastFrame()               const { return m_wvp_previous; }
         void SetWvpLastFrame(const Math::Matrix& matrix)          { m_wvp_previous = matrix;}
 
 	private:
 		Math::Matrix GetParentTransformMatrix() const;
+		// Same as UpdateTransform(), without serialization, the world uses it once the parents are resolved
+		void Resolve() const;
+		// Flags this transform and its descendants, their matrices are computed when next needed (or by the world, once per frame)
+		void MakeDirty();
 
 		// local
 		Math::Vector3 m_positionLocal;
 		Math::Quaternion m_rotationLocal;
 		Math::Vector3 m_scaleLocal;
 
-		Math::Matrix m_matrix;
-		Math::Matrix m_matrixLocal;
+		mutable Math::Matrix m_matrix;
+		mutable Math::Matrix m_matrixLocal;
+		mutable bool m_is_dirty = true;
+		bool m_has_changed		= false;
 		Math::Vector3 m_lookAt;
 
 		Transform* m_parent; // the parent of this transform
 		std::vector<Transform*> m_children; // the children of this transform
 
 		Math::Matrix m_wvp_previous;
+
+		// The world rebuilds children lists in bulk when a batch ends
+		friend class World;
 	};
 }
@@ -265,14 +265,15 @@ namespace Spartan
                 child.lock()->Deserialize(stream, GetTransform());
             }
 
-            if (m_transform)
+            // While batching, the world rebuilds all children lists once the batch ends
+            if (m_transform && !scene->IsBatching())
             {
                 m_transform->AcquireChildren();
             }
         }
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve_Pending);
+		ResolvePending();
 	}
 
     IComponent* Entity::AddComponent(const ComponentType type, uint32_t id /*= 0*/)
@@ -336,6 +337,14 @@ namespace Spartan
         }
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve_Pending);
+		ResolvePending();
 	}
+
+    void Entity::ResolvePending()
+    {
+        if (World* world = m_context->GetSubsystem<World>())
+        {
+            world->ResolvePending(this);
+        }
+    }
 }
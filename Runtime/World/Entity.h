@@ -51,7 +51,7 @@ namespace Spartan
 		void SetName(const std::string& name)							{ m_name = name; }
 
 		bool IsActive() const											{ return m_is_active; }
-		void SetActive(const bool active)								{ m_is_active = active; }
+		void SetActive(const bool active)								{ if (m_is_active != active) { m_is_active = active; ResolvePending(); } }
 
 		bool IsVisibleInHierarchy() const								{ return m_hierarchy_visibility; }
 		void SetHierarchyVisibility(const bool hierarchy_visibility)	{ m_hierarchy_visibility = hierarchy_visibility; }
@@ -83,7 +83,7 @@ namespace Spartan
             component->OnInitialize();
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve_Pending);
+			ResolvePending();
 
             return component.get();
 		}
@@ -159,7 +159,7 @@ namespace Spartan
 			}
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve_Pending);
+			ResolvePending();
 		}
 
 		void RemoveComponentById(uint32_t id);
@@ -174,6 +174,8 @@ namespace Spartan
 		std::shared_ptr<Entity> GetPtrShared()  { return shared_from_this(); }
 
 	private:
+        // Lets the world know that this entity changed (deferred while the world is batching)
+        void ResolvePending();
         constexpr uint32_t GetComponentMask(ComponentType type) { return static_cast<uint32_t>(1) << static_cast<uint32_t>(type); }
 
 		std::string m_name			= "Entity";
@@ -19,7 +19,7 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ==========================
+//= INCLUDES =================================
 #include "Spartan.h"
 #include "World.h"
 #include "Entity.h"
@@ -28,14 +28,17 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Components/Light.h"
 #include "Components/Environment.h"
 #include "Components/AudioListener.h"
+#include "Components/Renderable.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ProgressReport.h"
 #include "../IO/FileStream.h"
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
+#include "../Rendering/ShaderCompileQueue.h"
 #include "../Input/Input.h"
 #include "../RHI/RHI_Device.h"
-//=====================================
+#include "../Threading/Threading.h"
+//============================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -44,10 +47,26 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    namespace _world
+    {
+        // A world file starts with a header, followed by one chunk per root entity (and its descendants) and ends with a table
+        // which holds the id, offset and size of every chunk, the last 8 bytes are the offset of that table.
+        // Files without the magic predate the chunked format and are read sequentially.
+        static const uint32_t file_magic    = 0x444C5257; // "WRLD"
+        static const uint32_t file_version  = 1;
+
+        struct _chunk
+        {
+            uint32_t id     = 0;
+            uint64_t offset = 0;
+            uint64_t size   = 0;
+        };
+    }
+
 	World::World(Context* context) : ISubsystem(context)
 	{
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Pending, [this](Variant) { m_is_dirty = true; });
+		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Pending, [this](Variant) { ResolvePending(); });
 		SUBSCRIBE_TO_EVENT(Event_World_Stop,	        [this](Variant)	{ m_state = Idle; });
 		SUBSCRIBE_TO_EVENT(Event_World_Start,	        [this](Variant)	{ m_state = Ticking; });
 	}
@@ -118,6 +137,13 @@ namespace Spartan
 
         if (m_is_dirty)
         {
+            // Take the entities which changed since the last resolve
+            {
+                lock_guard<mutex> lock(m_mutex_resolve);
+                m_entities_resolved.assign(m_entities_changed.begin(), m_entities_changed.end());
+                m_entities_changed.clear();
+            }
+
             // Update dirty entities
             {
                 // Make a copy so we can iterate while removing entities
@@ -132,10 +158,36 @@ namespace Spartan
                 }
             }
 
-            // Notify Renderer
-            FIRE_EVENT_DATA(Event_World_Resolve_Complete, m_entities);
-            m_is_dirty = false;
+            // Add new entities to the spatial index and drop the ones which no longer qualify
+            for (const auto& entity : m_entities)
+            {
+                Renderable* renderable = entity->GetRenderable();
+                if (entity->IsActive() && renderable && renderable->GeometryModel())
+                {
+                    if (!m_bvh.Contains(entity.get()))
+                    {
+                        m_bvh.Insert(entity.get(), renderable->GetAabb());
+                    }
+                }
+                else
+                {
+                    m_bvh.Remove(entity.get());
+                }
+            }
+
+            // Notify Renderer, it picks up the deltas through EntityGetChanged() and EntityGetRemoved()
+            FIRE_EVENT(Event_World_Resolve_Complete);
+            m_entities_resolved.clear();
+            m_entities_removed.clear();
+            m_is_dirty              = false;
+            m_is_hierarchy_dirty    = true;
         }
+
+        // Compute the matrices of any transforms which changed this frame
+        TransformsUpdate();
+
+        // Refit the spatial index to the entities which moved
+        BvhUpdate();
 	}
 
 	void World::Unload()
@@ -145,8 +197,17 @@ namespace Spartan
 
         m_entities.clear();
         m_entities.shrink_to_fit();
+        m_transforms.clear();
+        m_transform_levels.clear();
+        m_bvh.Clear();
+        {
+            lock_guard<mutex> lock(m_mutex_resolve);
+            m_entities_changed.clear();
+        }
+        m_entities_removed.clear();
 
-		m_is_dirty = true;
+		m_is_dirty              = true;
+        m_is_hierarchy_dirty    = true;
 	}
 
 	bool World::SaveToFile(const string& filePathIn)
@@ -182,21 +243,32 @@ namespace Spartan
 
 		ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
 
-		// Save root entity count
+		// Save header
+		file->Write(_world::file_magic);
+		file->Write(_world::file_version);
 		file->Write(root_entity_count);
 
-		// Save root entity IDs
-		for (const auto& root : root_actors)
+		// Save root entities, each one into its own chunk
+		vector<_world::_chunk> chunks(root_entity_count);
+		for (uint32_t i = 0; i < root_entity_count; i++)
 		{
-			file->Write(root->GetId());
+			chunks[i].id        = root_actors[i]->GetId();
+			chunks[i].offset    = file->GetPosition();
+			root_actors[i]->Serialize(file.get());
+			chunks[i].size      = file->GetPosition() - chunks[i].offset;
+
+			ProgressReport::Get().IncrementJobsDone(g_progress_world);
 		}
 
-		// Save root entities
-		for (const auto& root : root_actors)
+		// Save chunk table
+		const uint64_t table_offset = file->GetPosition();
+		for (const _world::_chunk& chunk : chunks)
 		{
-			root->Serialize(file.get());
-			ProgressReport::Get().IncrementJobsDone(g_progress_world);
+			file->Write(chunk.id);
+			file->Write(chunk.offset);
+			file->Write(chunk.size);
 		}
+		file->Write(table_offset);
 
 		// Finish with progress report and timer
 		ProgressReport::Get().SetIsLoading(g_progress_world, false);
@@ -242,6 +314,116 @@ namespace Spartan
 		// Notify subsystems that need to load data
 		FIRE_EVENT(Event_World_Load);
 
+		// Load header, files without one use the sequential layout
+		const bool is_chunked = file->ReadAs<uint32_t>() == _world::file_magic;
+		if (is_chunked)
+		{
+			const auto version = file->ReadAs<uint32_t>();
+			if (version > _world::file_version)
+			{
+				LOG_ERROR("\"%s\" has version %d, the newest supported version is %d", file_path.c_str(), version, _world::file_version);
+				ProgressReport::Get().SetIsLoading(g_progress_world, false);
+				m_state = Ticking;
+				return false;
+			}
+		}
+		else
+		{
+			file->Seek(0);
+		}
+
+		// Components and hierarchy are resolved once, after everything has been deserialized
+		BatchBegin();
+		if (is_chunked)
+		{
+			LoadFromFileChunked(file.get());
+		}
+		else
+		{
+			LoadFromFileSequential(file.get());
+		}
+		BatchEnd();
+
+		// Notify subsystems while the world is complete but not ticking yet (the renderer queues the shader variations it uses)
+		FIRE_EVENT(Event_World_Loaded);
+
+		// Keep the loading screen up until those shaders are ready, so that nothing pops in afterwards
+		if (ShaderCompileQueue* shader_compile_queue = m_context->GetSubsystem<Renderer>()->GetShaderCompileQueue())
+		{
+			ProgressReport::Get().SetStatus(g_progress_world, "Compiling shaders...");
+			shader_compile_queue->Wait();
+		}
+
+		m_is_dirty	= true;
+		m_state		= Ticking;
+		ProgressReport::Get().SetIsLoading(g_progress_world, false);	
+		LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
+
+		return true;
+	}
+
+    void World::BatchBegin()
+    {
+        m_batch_depth.fetch_add(1, memory_order_acq_rel);
+    }
+
+    void World::BatchEnd()
+    {
+        if (m_batch_depth.fetch_sub(1, memory_order_acq_rel) != 1)
+            return;
+
+        HierarchyResolve();
+
+        // A single resolve for everything that was requested during the batch
+        lock_guard<mutex> lock(m_mutex_resolve);
+        if (m_resolve_deferred || !m_entities_changed.empty())
+        {
+            m_resolve_deferred  = false;
+            m_is_dirty          = true;
+        }
+    }
+
+    void World::ResolvePending(Entity* entity /*= nullptr*/)
+    {
+        lock_guard<mutex> lock(m_mutex_resolve);
+
+        if (entity)
+        {
+            m_entities_changed.insert(entity);
+        }
+
+        if (IsBatching())
+        {
+            m_resolve_deferred = true;
+        }
+        else
+        {
+            m_is_dirty = true;
+        }
+    }
+
+    void World::HierarchyResolve()
+    {
+        // Equivalent to every transform calling AcquireChildren(), but in a single pass over the entities
+        for (const auto& entity : m_entities)
+        {
+            entity->GetTransform()->m_children.clear();
+        }
+
+        for (const auto& entity : m_entities)
+        {
+            Transform* transform = entity->GetTransform();
+            if (transform->m_parent)
+            {
+                transform->m_parent->m_children.emplace_back(transform);
+            }
+        }
+
+        m_is_hierarchy_dirty = true;
+    }
+
+    void World::LoadFromFileSequential(FileStream* file)
+    {
 		// Load root entity count
         const auto root_entity_count = file->ReadAs<uint32_t>();
 
@@ -257,18 +439,65 @@ namespace Spartan
 		// Serialize root entities
 		for (uint32_t i = 0; i < root_entity_count; i++)
 		{
-			m_entities[i]->Deserialize(file.get(), nullptr);
+			m_entities[i]->Deserialize(file, nullptr);
 			ProgressReport::Get().IncrementJobsDone(g_progress_world);
 		}
+    }
 
-		m_is_dirty	= true;
-		m_state		= Ticking;
-		ProgressReport::Get().SetIsLoading(g_progress_world, false);	
-		LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
+    void World::LoadFromFileChunked(FileStream* file)
+    {
+        const auto root_entity_count = file->ReadAs<uint32_t>();
 
-		FIRE_EVENT(Event_World_Loaded);
-		return true;
-	}
+        // Load chunk table
+        const uint64_t table_size = static_cast<uint64_t>(root_entity_count) * (sizeof(uint32_t) + sizeof(uint64_t) * 2);
+        if (file->GetSize() < sizeof(uint64_t) + table_size || !file->Seek(file->GetSize() - sizeof(uint64_t)))
+        {
+            LOG_ERROR("The chunk table is missing");
+            return;
+        }
+
+        const auto table_offset = file->ReadAs<uint64_t>();
+        if (!file->Seek(table_offset))
+        {
+            LOG_ERROR("The chunk table is corrupted");
+            return;
+        }
+
+        vector<_world::_chunk> chunks(root_entity_count);
+        for (_world::_chunk& chunk : chunks)
+        {
+            file->Read(&chunk.id);
+            file->Read(&chunk.offset);
+            file->Read(&chunk.size);
+        }
+
+		ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
+
+        // Create root entities first, so that they precede their descendants
+        const uint32_t root_entity_first = static_cast<uint32_t>(m_entities.size());
+        for (const _world::_chunk& chunk : chunks)
+        {
+            EntityCreate()->SetId(chunk.id);
+        }
+
+        // Every chunk is located through the table, so one which fails to deserialize doesn't affect the ones after it
+        for (uint32_t i = 0; i < root_entity_count; i++)
+        {
+            const _world::_chunk& chunk = chunks[i];
+
+            if (file->Seek(chunk.offset))
+            {
+                m_entities[root_entity_first + i]->Deserialize(file, nullptr);
+
+                if (file->GetPosition() != chunk.offset + chunk.size)
+                {
+                    LOG_WARNING("Entity %d read %llu bytes but its chunk is %llu bytes", chunk.id, static_cast<unsigned long long>(file->GetPosition() - chunk.offset), static_cast<unsigned long long>(chunk.size));
+                }
+            }
+
+			ProgressReport::Get().IncrementJobsDone(g_progress_world);
+        }
+    }
 
     shared_ptr<Entity>& World::EntityCreate(bool is_active /*= true*/)
     {
@@ -344,6 +573,89 @@ namespace Spartan
 		return empty;
 	}
 
+    void World::TransformsUpdate()
+    {
+        // Flatten the hierarchy, one depth level after the other
+        if (m_is_hierarchy_dirty)
+        {
+            m_transforms.clear();
+            m_transform_levels.clear();
+
+            for (const auto& entity : m_entities)
+            {
+                Transform* transform = entity->GetTransform();
+                if (transform->IsRoot())
+                {
+                    m_transforms.emplace_back(transform);
+                }
+            }
+
+            uint32_t level_start = 0;
+            while (level_start != static_cast<uint32_t>(m_transforms.size()))
+            {
+                m_transform_levels.emplace_back(level_start);
+
+                const uint32_t level_end = static_cast<uint32_t>(m_transforms.size());
+                for (uint32_t i = level_start; i < level_end; i++)
+                {
+                    for (Transform* child : m_transforms[i]->GetChildren())
+                    {
+                        m_transforms.emplace_back(child);
+                    }
+                }
+
+                level_start = level_end;
+            }
+            m_transform_levels.emplace_back(level_start);
+
+            m_is_hierarchy_dirty = false;
+        }
+
+        // Resolve level by level, all the parents of a level are up to date by the time
+        // it is processed, so the transforms within it are independent and can be updated in parallel.
+        const auto update_transforms = [this](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                m_transforms[i]->Resolve();
+            }
+        };
+
+        Threading* threading                = m_context->GetSubsystem<Threading>();
+        const uint32_t parallel_threshold   = 1024;
+        for (uint32_t level = 0; level + 1 < static_cast<uint32_t>(m_transform_levels.size()); level++)
+        {
+            const uint32_t start    = m_transform_levels[level];
+            const uint32_t end      = m_transform_levels[level + 1];
+
+            if (end - start >= parallel_threshold)
+            {
+                threading->ParallelFor(start, end, 256, update_transforms);
+            }
+            else
+            {
+                update_transforms(start, end);
+            }
+        }
+    }
+
+    void World::BvhUpdate()
+    {
+        for (Transform* transform : m_transforms)
+        {
+            if (!transform->HasChanged())
+                continue;
+
+            transform->ResetChanged();
+
+            Entity* entity = transform->GetEntity();
+            if (m_bvh.Contains(entity))
+            {
+                m_bvh.Update(entity, entity->GetRenderable()->GetAabb());
+            }
+        }
+    }
+
     // Removes an entity and all of it's children
     void World::_EntityRemove(const std::shared_ptr<Entity>& entity)
     {
@@ -357,6 +669,14 @@ namespace Spartan
         // Keep a reference to it's parent (in case it has one)
         auto parent = entity->GetTransform()->GetParent();
 
+        m_bvh.Remove(entity.get());
+        {
+            lock_guard<mutex> lock(m_mutex_resolve);
+            m_entities_changed.erase(entity.get());
+        }
+        m_entities_resolved.erase(remove(m_entities_resolved.begin(), m_entities_resolved.end(), entity.get()), m_entities_resolved.end());
+        m_entities_removed.emplace_back(entity.get());
+
         // Remove this entity
         for (auto it = m_entities.begin(); it < m_entities.end();)
         {
@@ -25,16 +25,22 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <memory>
 #include <string>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
 #include "../Core/ISubsystem.h"
 #include "../Core/Spartan_Definitions.h"
+#include "Bvh.h"
 //======================================
 
 namespace Spartan
 {
 	class Entity;
+	class Transform;
 	class Light;
 	class Input;
 	class Profiler;
+	class FileStream;
 
 	enum Scene_State
 	{
@@ -60,6 +66,21 @@ namespace Spartan
 		bool LoadFromFile(const std::string& file_path);
 		const auto& GetName() const { return m_name; }
         void MakeDirty() { m_is_dirty = true; }
+        void MakeHierarchyDirty() { m_is_hierarchy_dirty = true; }
+
+		//= BATCHING ========================================================================================================
+        // Between BatchBegin() and BatchEnd(), resolve requests are only recorded and hierarchy updates are deferred.
+        // Closing the outermost batch rebuilds the hierarchy once and raises a single resolve for everything that changed.
+        void BatchBegin();
+        void BatchEnd();
+        bool IsBatching() const { return m_batch_depth.load(std::memory_order_acquire) != 0; }
+        // Requests a resolve, the entity (if any) is recorded as changed
+        void ResolvePending(Entity* entity = nullptr);
+        // The entities which changed since the previous resolve, valid while Event_World_Resolve_Complete is being handled
+        const auto& EntityGetChanged() const { return m_entities_resolved; }
+        // The entities which were removed by this resolve, they are already destroyed so they can only be used as keys
+        const auto& EntityGetRemoved() const { return m_entities_removed; }
+		//===================================================================================================================
 
 		//= Entities ===========================================================================
 		std::shared_ptr<Entity>& EntityCreate(bool is_active = true);
@@ -73,8 +94,16 @@ namespace Spartan
 		auto EntityGetCount() const         { return static_cast<uint32_t>(m_entities.size()); }
 		//======================================================================================
 
+        // Spatial index of all the active entities with a renderable (ray, frustum and overlap queries)
+        const Bvh& GetBvh() const { return m_bvh; }
+
 	private:
         void _EntityRemove(const std::shared_ptr<Entity>& entity);
+        void TransformsUpdate();
+        void BvhUpdate();
+        void LoadFromFileSequential(FileStream* file);
+        void HierarchyResolve();
+        void LoadFromFileChunked(FileStream* file);
 
 		//= COMMON ENTITY CREATION ========================
 		std::shared_ptr<Entity>& CreateEnvironment();
@@ -85,10 +114,25 @@ namespace Spartan
         std::string m_name;
         bool m_was_in_editor_mode   = false;
         bool m_is_dirty             = true;
+        bool m_is_hierarchy_dirty   = true;
         Scene_State m_state         = Ticking;	
         Input* m_input              = nullptr;
         Profiler* m_profiler        = nullptr;
 
         std::vector<std::shared_ptr<Entity>> m_entities;
+
+        // All transforms, sorted by hierarchy depth (parents before children), and where each depth level starts
+        std::vector<Transform*> m_transforms;
+        std::vector<uint32_t> m_transform_levels;
+
+        Bvh m_bvh;
+
+        // Batching and resolve requests, which can come from any thread
+        std::atomic<uint32_t> m_batch_depth = 0;
+        bool m_resolve_deferred             = false;
+        std::unordered_set<Entity*> m_entities_changed;
+        std::vector<Entity*> m_entities_resolved;
+        std::vector<Entity*> m_entities_removed;
+        std::mutex m_mutex_resolve;
 	};
 }
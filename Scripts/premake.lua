@@ -37,16 +37,25 @@ if API_GRAPHICS == "d3d11" then
 	TARGET_NAME		= "Spartan_d3d11"
 	IGNORE_FILES[0]	= RUNTIME_DIR .. "/RHI/D3D12/**"
 	IGNORE_FILES[1]	= RUNTIME_DIR .. "/RHI/Vulkan/**"
+	IGNORE_FILES[2]	= RUNTIME_DIR .. "/RHI/Null/**"
 elseif API_GRAPHICS == "d3d12" then
 	API_GRAPHICS	= "API_GRAPHICS_D3D12"
 	TARGET_NAME		= "Spartan_d3d12"
 	IGNORE_FILES[0]	= RUNTIME_DIR .. "/RHI/D3D11/**"
 	IGNORE_FILES[1]	= RUNTIME_DIR .. "/RHI/Vulkan/**"
+	IGNORE_FILES[2]	= RUNTIME_DIR .. "/RHI/Null/**"
 elseif API_GRAPHICS == "vulkan" then
 	API_GRAPHICS	= "API_GRAPHICS_VULKAN"
 	TARGET_NAME		= "Spartan_vk"
 	IGNORE_FILES[0]	= RUNTIME_DIR .. "/RHI/D3D11/**"
 	IGNORE_FILES[1]	= RUNTIME_DIR .. "/RHI/D3D12/**"
+	IGNORE_FILES[2]	= RUNTIME_DIR .. "/RHI/Null/**"
+elseif API_GRAPHICS == "null" then
+	API_GRAPHICS	= "API_GRAPHICS_NULL"
+	TARGET_NAME		= "Spartan_null"
+	IGNORE_FILES[0]	= RUNTIME_DIR .. "/RHI/D3D11/**"
+	IGNORE_FILES[1]	= RUNTIME_DIR .. "/RHI/D3D12/**"
+	IGNORE_FILES[2]	= RUNTIME_DIR .. "/RHI/Vulkan/**"
 end
 
 -- Solution
@@ -104,7 +113,7 @@ project (RUNTIME_NAME)
 	}
 	
 	-- Source to ignore
-	removefiles { IGNORE_FILES[0], IGNORE_FILES[1] }
+	removefiles { IGNORE_FILES[0], IGNORE_FILES[1], IGNORE_FILES[2] }
 
 	-- Includes
 	includedirs { "../ThirdParty/DirectXShaderCompiler" }